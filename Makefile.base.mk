@@ -29,6 +29,9 @@
 # USE_GLES3=false
 # USE_WEB_VIEW=false
 
+# USE_SINGLE_BUFFER=true
+#  Use a single-buffered OpenGL context, allowing to only redraw the parts of a window that changed
+
 # STATIC_BUILD=true
 #  Tweak build to be able to generate fully static builds (e.g. skip use of libdl)
 #  Experimental, use only if you know what you are doing
@@ -686,6 +689,10 @@ ifeq ($(USE_RGBA),true)
 BUILD_CXX_FLAGS += -DDGL_USE_RGBA
 endif
 
+ifeq ($(USE_SINGLE_BUFFER),true)
+BUILD_CXX_FLAGS += -DDGL_USE_SINGLE_BUFFER
+endif
+
 ifeq ($(USE_FILE_BROWSER),true)
 BUILD_CXX_FLAGS += -DDGL_USE_FILE_BROWSER
 endif
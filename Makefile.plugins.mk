@@ -391,6 +391,7 @@ else
 jack       = $(TARGET_DIR)/$(NAME)$(APP_EXT)
 endif
 
+bench      = $(TARGET_DIR)/$(NAME)-bench$(APP_EXT)
 clap       = $(TARGET_DIR)/$(CLAP_FILENAME)
 dssi_dsp   = $(TARGET_DIR)/$(NAME)-dssi$(LIB_EXT)
 dssi_ui    = $(TARGET_DIR)/$(NAME)-dssi/$(NAME)_ui$(APP_EXT)
@@ -620,6 +621,16 @@ endif
 	@echo "Creating JACK standalone for $(NAME)"
 	$(SILENT)$(CXX) $^ $(BUILD_CXX_FLAGS) $(LINK_FLAGS) $(EXTRA_LIBS) $(EXTRA_DSP_LIBS) $(EXTRA_UI_LIBS) $(DGL_LIBS) $(JACK_LIBS) -o $@
 
+# ---------------------------------------------------------------------------------------------------------------------
+# Benchmark
+
+bench: $(bench)
+
+$(bench): $(OBJS_DSP) $(BUILD_DIR)/DistrhoPluginMain_BENCH.cpp.o
+	-@mkdir -p $(shell dirname $@)
+	@echo "Creating benchmark tool for $(NAME)"
+	$(SILENT)$(CXX) $^ $(BUILD_CXX_FLAGS) $(LINK_FLAGS) $(EXTRA_LIBS) $(EXTRA_DSP_LIBS) -o $@
+
 # ---------------------------------------------------------------------------------------------------------------------
 # LADSPA
 
@@ -917,6 +928,7 @@ ifneq ($(UI_TYPE),)
 endif
 
 -include $(BUILD_DIR)/DistrhoPluginMain_AU.cpp.d
+-include $(BUILD_DIR)/DistrhoPluginMain_BENCH.cpp.d
 -include $(BUILD_DIR)/DistrhoPluginMain_CLAP.cpp.d
 -include $(BUILD_DIR)/DistrhoPluginMain_DSSI.cpp.d
 -include $(BUILD_DIR)/DistrhoPluginMain_Export.cpp.d
@@ -72,7 +72,7 @@ include(CMakeParseArguments)
 #
 #   `TARGETS` <tgt1>...<tgtN>
 #       a list of one of more of the following target types:
-#       `jack`, `ladspa`, `dssi`, `lv2`, `vst2`, `vst3`, `clap`
+#       `jack`, `ladspa`, `dssi`, `lv2`, `vst2`, `vst3`, `clap`, `bench`
 #
 #   `UI_TYPE` <type>
 #       the user interface type, can be one of the following:
@@ -263,6 +263,8 @@ function(dpf_add_plugin NAME)
       endif()
     elseif(_target STREQUAL "static")
       dpf__build_static("${NAME}" "${_dgl_has_ui}")
+    elseif(_target STREQUAL "bench")
+      dpf__build_bench("${NAME}")
     else()
       message(FATAL_ERROR "Unrecognized target type for plugin: ${_target}")
     endif()
@@ -496,6 +498,22 @@ function(dpf__build_jack NAME HAS_UI FORCE_NATIVE_AUDIO_FALLBACK SKIP_NATIVE_AUD
   endif()
 endfunction()
 
+# dpf__build_bench
+# ------------------------------------------------------------------------------
+#
+# Add build rules for a headless benchmark program.
+#
+function(dpf__build_bench NAME)
+  dpf__create_dummy_source_list(_no_srcs)
+
+  dpf__add_executable("${NAME}-bench" ${_no_srcs})
+  dpf__add_plugin_main("${NAME}-bench" "bench")
+  target_link_libraries("${NAME}-bench" PRIVATE "${NAME}-dsp")
+  set_target_properties("${NAME}-bench" PROPERTIES
+    RUNTIME_OUTPUT_DIRECTORY "${PROJECT_BINARY_DIR}/bin/$<0:>"
+    OUTPUT_NAME "${NAME}-bench")
+endfunction()
+
 # dpf__build_ladspa
 # ------------------------------------------------------------------------------
 #
@@ -152,6 +152,22 @@ public:
    */
     double getTime() const;
 
+   /**
+      Get the maximum rate at which windows are repainted, in frames per second.
+      Returns 0 if following the refresh rate of the display, which is the default.
+      @see setMaxFrameRate
+    */
+    uint getMaxFrameRate() const noexcept;
+
+   /**
+      Set the maximum rate at which windows are repainted, in frames per second.
+      Repaint requests that arrive before the next frame is due are merged and drawn together once it is,
+      which avoids redrawing faster than the display can show while many windows are open.
+      Set to 0 to follow the refresh rate of the display, or 60 if the refresh rate is unknown.
+      Hosts that schedule repaints themselves (such as AU) are not affected by this.
+    */
+    void setMaxFrameRate(uint framesPerSecond) noexcept;
+
    /**
       Return the application type, either kTypeClassic or kTypeModern.
       This function never return kTypeAuto.
@@ -582,6 +582,7 @@ public:
 
    /**
       Creates image by loading it from the disk from specified file name.
+      When several NanoVG instances in the same process load the same contents, they share the decoded image.
     */
     NanoImage::Handle createImageFromFile(const char* filename, ImageFlags imageFlags);
 
@@ -594,6 +595,7 @@ public:
 
    /**
       Creates image by loading it from the specified chunk of memory.
+      When several NanoVG instances in the same process load the same contents, they share the decoded image.
     */
     NanoImage::Handle createImageFromMemory(const uchar* data, uint dataSize, ImageFlags imageFlags);
 
@@ -784,6 +786,7 @@ public:
 
    /**
       Creates font by loading it from the disk from specified file name.
+      The font data is shared with other NanoVG instances in the same process that load the same contents.
       Returns handle to the font.
     */
     FontId createFontFromFile(const char* name, const char* filename);
@@ -843,6 +846,7 @@ public:
 
    /**
       Draws text string at specified location. If end is specified only the sub-string up to the end is drawn.
+      The positioned glyphs of short strings are cached, so drawing the same text again on later frames is cheap.
     */
     float text(float x, float y, const char* string, const char* end);
 
@@ -851,6 +855,7 @@ public:
       If end is specified only the sub-string up to the end is drawn.
       White space is stripped at the beginning of the rows, the text is split at word boundaries or when new-line characters are encountered.
       Words longer than the max width are slit at nearest character (i.e. no hyphenation).
+      The row layout of short strings is cached, same as the glyphs drawn by text().
     */
     void textBox(float x, float y, float breakRowWidth, const char* string, const char* end = nullptr);
 
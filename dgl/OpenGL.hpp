@@ -22,6 +22,8 @@
 
 #include "OpenGL-include.hpp"
 
+#include <vector>
+
 START_NAMESPACE_DGL
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -332,6 +334,134 @@ private:
 
 // --------------------------------------------------------------------------------------------------------------------
 
+/**
+   OpenGL image atlas.
+
+   This class packs several images into a single shared texture, so they can be drawn together using OpenGLImageBatch.
+   Images are placed in rows, with a transparent 1 pixel gap around each of them to avoid filtering artifacts.
+
+   Image data is uploaded on the next draw, so images can be added while the graphics context is not active.
+   Grayscale images are not supported.
+ */
+class OpenGLImageAtlas
+{
+public:
+   /**
+      Constructor, using the size of the shared texture.
+    */
+    explicit OpenGLImageAtlas(uint width = 2048, uint height = 2048);
+
+   /**
+      Destructor.
+    */
+    ~OpenGLImageAtlas();
+
+   /**
+      Add an image to this atlas, setting @a imageId to use for drawing.
+      Returns false if the image is invalid or does not fit in the remaining space.
+      @note The image must remain valid for the lifetime of this atlas.
+    */
+    bool addImage(const OpenGLImage& image, uint& imageId);
+
+   /**
+      Get the number of images in this atlas.
+    */
+    uint getImageCount() const noexcept;
+
+   /**
+      Get the size of an image in this atlas.
+    */
+    Size<uint> getImageSize(uint imageId) const noexcept;
+
+   /**
+      Get the size of the shared texture.
+    */
+    const Size<uint>& getSize() const noexcept;
+
+private:
+    struct ImageData {
+        const char* rawData;
+        ImageFormat format;
+        Rectangle<uint> area;
+    };
+
+    std::vector<ImageData> images;
+    const Size<uint> size;
+    uint rowX, rowY, rowHeight;
+    uint numUploaded;
+    GLuint textureId;
+
+    GLuint prepareTexture();
+
+    friend class OpenGLImageBatch;
+
+    DISTRHO_DECLARE_NON_COPYABLE(OpenGLImageAtlas)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   OpenGL batched image renderer.
+
+   Collects images from an OpenGLImageAtlas during a widget's onDisplay() and submits all of them in a single draw call,
+   instead of binding a texture and drawing once per image like OpenGLImage does.
+   Images are drawn in the order they were added, relative to the current widget.
+
+   @code
+   void onDisplay() override
+   {
+       const GraphicsContext& context(getGraphicsContext());
+
+       for (uint i = 0; i < kNumMeters; ++i)
+           batch.add(meterImageId, meterPositions[i]);
+
+       batch.draw(context);
+   }
+   @endcode
+ */
+class OpenGLImageBatch
+{
+public:
+   /**
+      Constructor, using images from @a atlas.
+    */
+    explicit OpenGLImageBatch(OpenGLImageAtlas& atlas);
+
+   /**
+      Add an image to be drawn at position @a pos.
+    */
+    void add(uint imageId, const Point<int>& pos);
+
+   /**
+      Add part of an image to be drawn at position @a pos, for example a single frame of a knob strip.
+      @a sourceArea is relative to the image, not the atlas.
+    */
+    void add(uint imageId, const Point<int>& pos, const Rectangle<uint>& sourceArea);
+
+   /**
+      Get the number of images waiting to be drawn.
+    */
+    uint getCount() const noexcept;
+
+   /**
+      Discard all images waiting to be drawn.
+    */
+    void clear() noexcept;
+
+   /**
+      Draw all added images using the graphics context @a context, and then clear the batch.
+    */
+    void draw(const GraphicsContext& context);
+
+private:
+    OpenGLImageAtlas& atlas;
+    std::vector<GLfloat> vertices;
+
+    DISTRHO_DECLARE_NON_COPYABLE(OpenGLImageBatch)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
 typedef ImageBaseAboutWindow<OpenGLImage> OpenGLImageAboutWindow;
 typedef ImageBaseButton<OpenGLImage> OpenGLImageButton;
 typedef ImageBaseKnob<OpenGLImage> OpenGLImageKnob;
@@ -164,6 +164,15 @@ public:
     */
     void setSkipDrawing(bool skipDrawing = true);
 
+   /**
+      Cache the drawing of this subwidget, so that onDisplay() is only called again after repaint() or a change in
+      its size, position or scale factor. The last drawing is reused otherwise.
+      Useful for widgets with static contents, such as backgrounds, scales and labels.
+      Subwidgets drawing out of bounds are never cached.
+      @note Only implemented for OpenGL (including NanoVG) and Cairo.
+    */
+    void setCachedDrawing(bool cachedDrawing = true);
+
 protected:
    /**
       A function called when the subwidget's absolute position is changed.
@@ -122,6 +122,39 @@ public:
         bool reenter;
     };
 
+   /**
+      Frame timing statistics of a window.
+      All times are in seconds, measured with the same clock as Application::getTime().
+      @see getFrameStatistics
+    */
+    struct FrameStatistics
+    {
+        /** Number of frames drawn so far. */
+        uint32_t frameCount;
+
+        /** Number of repaint requests that were merged into a later frame, as they arrived before it was due. */
+        uint32_t coalescedRepaints;
+
+        /** Time taken to draw the last frame. */
+        double lastFrameTime;
+
+        /** Average and maximum time taken to draw a frame. */
+        double averageFrameTime;
+        double maxFrameTime;
+
+        /** Average time between the start of consecutive frames. */
+        double averageFrameInterval;
+
+        /** Constructor, sets everything to zero. */
+        FrameStatistics() noexcept
+            : frameCount(0),
+              coalescedRepaints(0),
+              lastFrameTime(0.0),
+              averageFrameTime(0.0),
+              maxFrameTime(0.0),
+              averageFrameInterval(0.0) {}
+    };
+
    /**
       Constructor for a regular, standalone window.
     */
@@ -442,6 +475,17 @@ public:
     */
     void repaint(const Rectangle<uint>& rect) noexcept;
 
+   /**
+      Get the frame timing statistics of this window.
+      Repaint requests are limited to the frame rate set in the Application, see Application::setMaxFrameRate().
+    */
+    FrameStatistics getFrameStatistics() const noexcept;
+
+   /**
+      Reset the frame timing statistics of this window.
+    */
+    void resetFrameStatistics() noexcept;
+
    /**
       Render this window's content into a picture file, specified by @a filename.
       Window must be visible and on screen.
@@ -213,6 +213,16 @@ double Application::getTime() const
     return pData->getTime();
 }
 
+uint Application::getMaxFrameRate() const noexcept
+{
+    return pData->maxFrameRate;
+}
+
+void Application::setMaxFrameRate(const uint framesPerSecond) noexcept
+{
+    pData->maxFrameRate = framesPerSecond;
+}
+
 Application::Type Application::getType() const noexcept
 {
     return pData->isModern ? kTypeModern : kTypeClassic;
@@ -19,6 +19,10 @@
 
 #include "pugl.hpp"
 
+#ifndef DPF_TEST_APPLICATION_CPP
+# include "WindowPrivateData.hpp"
+#endif
+
 #include <ctime>
 
 START_NAMESPACE_DGL
@@ -62,6 +66,7 @@ Application::PrivateData::PrivateData(const bool standalone, const Type type)
       isQuitting(false),
       isQuittingInNextCycle(false),
       needsRepaint(false),
+      maxFrameRate(0),
       visibleWindows(0),
       mainThreadHandle(getCurrentThreadHandle()),
       windows(),
@@ -119,9 +124,15 @@ void Application::PrivateData::idle(const uint timeoutInMs)
 
     if (world != nullptr)
     {
-        const double timeoutInSeconds = timeoutInMs != 0
-                                      ? static_cast<double>(timeoutInMs) / 1000.0
-                                      : 0.0;
+        double timeoutInSeconds = timeoutInMs != 0
+                                ? static_cast<double>(timeoutInMs) / 1000.0
+                                : 0.0;
+
+        // do not wait for events past the time the next deferred repaint is due
+        const double nextFrameInSeconds = flushDeferredRepaints();
+
+        if (d_isNotZero(nextFrameInSeconds) && nextFrameInSeconds < timeoutInSeconds)
+            timeoutInSeconds = nextFrameInSeconds;
 
         puglUpdate(world, timeoutInSeconds);
     }
@@ -150,6 +161,28 @@ void Application::PrivateData::repaintIfNeeeded()
             window->repaint();
         }
     }
+
+    flushDeferredRepaints();
+}
+
+double Application::PrivateData::flushDeferredRepaints()
+{
+    double nextFrameInSeconds = 0.0;
+
+   #ifndef DPF_TEST_APPLICATION_CPP
+    const double time = getTime();
+
+    for (WindowListIterator it = windows.begin(), ite = windows.end(); it != ite; ++it)
+    {
+        DGL_NAMESPACE::Window* const window(*it);
+        const double remaining = window->pData->flushDeferredRepaint(time);
+
+        if (d_isNotZero(remaining) && (d_isZero(nextFrameInSeconds) || remaining < nextFrameInSeconds))
+            nextFrameInSeconds = remaining;
+    }
+   #endif
+
+    return nextFrameInSeconds;
 }
 
 void Application::PrivateData::quit()
@@ -69,6 +69,9 @@ struct Application::PrivateData {
     /** When true force all windows to be repainted on next idle. */
     bool needsRepaint;
 
+    /** Maximum rate at which windows are repainted, 0 to follow the display refresh rate. */
+    uint maxFrameRate;
+
     /** Counter of visible windows, only used in standalone mode.
         If 0->1, application is starting. If 1->0, application is quitting/stopping. */
     uint visibleWindows;
@@ -102,9 +105,13 @@ struct Application::PrivateData {
     /** Run each idle callback without updating pugl world. */
     void triggerIdleCallbacks();
 
-    /** Trigger a repaint of all windows if @a needsRepaint is true. */
+    /** Trigger a repaint of all windows if @a needsRepaint is true, and any deferred repaints that are now due. */
     void repaintIfNeeeded();
 
+    /** Trigger deferred repaints of all windows that are now due, as limited by @a maxFrameRate.
+        Returns the time in seconds until the next deferred repaint is due, or 0 if there are none left. */
+    double flushDeferredRepaints();
+
     /** Set flag indicating application is quitting, and close all windows in reverse order of registration.
         For standalone mode only. */
     void quit();
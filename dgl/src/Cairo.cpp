@@ -764,11 +764,71 @@ template class ImageBaseSwitch<CairoImage>;
 
 // -----------------------------------------------------------------------
 
-void SubWidget::PrivateData::display(const uint width, const uint height, const double autoScaleFactor)
+bool SubWidget::PrivateData::updateCache(const Rectangle<int>& area)
 {
     cairo_t* const handle = static_cast<const CairoGraphicsContext&>(self->getGraphicsContext()).handle;
 
-    bool needsResetClip = false;
+    destroyCache();
+
+    cairo_matrix_t matrix;
+    cairo_get_matrix(handle, &matrix);
+
+    cairo_save(handle);
+
+    // draw the full widget, not just the area being exposed
+    cairo_identity_matrix(handle);
+    cairo_reset_clip(handle);
+    cairo_rectangle(handle, area.getX(), area.getY(), area.getWidth(), area.getHeight());
+    cairo_clip(handle);
+    cairo_set_matrix(handle, &matrix);
+
+    cairo_push_group(handle);
+    self->onDisplay();
+
+    // keep the group pattern relative to the window, see drawCache
+    cairo_identity_matrix(handle);
+    cache.pattern = cairo_pop_group(handle);
+
+    cairo_restore(handle);
+
+    cache.area = area;
+    cache.needsUpdate = false;
+    return true;
+}
+
+void SubWidget::PrivateData::drawCache()
+{
+    cairo_t* const handle = static_cast<const CairoGraphicsContext&>(self->getGraphicsContext()).handle;
+
+    cairo_save(handle);
+    cairo_identity_matrix(handle);
+    cairo_set_source(handle, static_cast<cairo_pattern_t*>(cache.pattern));
+    cairo_paint(handle);
+    cairo_restore(handle);
+}
+
+void SubWidget::PrivateData::destroyCache()
+{
+    if (cache.pattern != nullptr)
+    {
+        cairo_pattern_destroy(static_cast<cairo_pattern_t*>(cache.pattern));
+        cache.pattern = nullptr;
+    }
+
+    cache.needsUpdate = true;
+}
+
+// -----------------------------------------------------------------------
+
+void SubWidget::PrivateData::display(const uint width, const uint height, const double autoScaleFactor,
+                                     const Rectangle<int>& exposeArea)
+{
+    cairo_t* const handle = static_cast<const CairoGraphicsContext&>(self->getGraphicsContext()).handle;
+
+    bool needsRestoreClip = false;
+
+    // area covered by the widget in pixels, if it can use cached drawing
+    Rectangle<int> cacheArea;
 
     cairo_matrix_t matrix;
     cairo_get_matrix(handle, &matrix);
@@ -783,13 +843,17 @@ void SubWidget::PrivateData::display(const uint width, const uint height, const
         // full viewport size
         cairo_translate(handle, 0, 0);
         cairo_scale(handle, autoScaleFactor, autoScaleFactor);
+
+        if (cachedDrawing && ! needsFullViewportForDrawing)
+            cacheArea = Rectangle<int>(0, 0, static_cast<int>(width), static_cast<int>(height));
     }
     else
     {
         // set viewport pos
         cairo_translate(handle, absolutePos.getX() * autoScaleFactor, absolutePos.getY() * autoScaleFactor);
 
-        // then cut the outer bounds
+        // then cut the outer bounds, keeping the clip of the area being exposed
+        cairo_save(handle);
         cairo_rectangle(handle,
                         0,
                         0,
@@ -797,21 +861,30 @@ void SubWidget::PrivateData::display(const uint width, const uint height, const
                         std::round(self->getHeight() * autoScaleFactor));
 
         cairo_clip(handle);
-        needsResetClip = true;
+        needsRestoreClip = true;
 
         // set viewport scaling
         cairo_scale(handle, autoScaleFactor, autoScaleFactor);
+
+        if (cachedDrawing)
+            cacheArea = Rectangle<int>(d_roundToInt(absolutePos.getX() * autoScaleFactor),
+                                       d_roundToInt(absolutePos.getY() * autoScaleFactor),
+                                       d_roundToIntPositive(self->getWidth() * autoScaleFactor),
+                                       d_roundToIntPositive(self->getHeight() * autoScaleFactor));
     }
 
-    // display widget
-    self->onDisplay();
+    // display widget, reusing its last drawing if possible
+    if (cacheArea.isValid() && ((! cache.needsUpdate && cache.area == cacheArea) || updateCache(cacheArea)))
+        drawCache();
+    else
+        self->onDisplay();
 
-    if (needsResetClip)
-        cairo_reset_clip(handle);
+    if (needsRestoreClip)
+        cairo_restore(handle);
 
     cairo_set_matrix(handle, &matrix);
 
-    selfw->pData->displaySubWidgets(width, height, autoScaleFactor);
+    selfw->pData->displaySubWidgets(width, height, autoScaleFactor, exposeArea);
 }
 
 // -----------------------------------------------------------------------
@@ -828,6 +901,12 @@ void TopLevelWidget::PrivateData::display()
     const uint height = size.getHeight();
 
     const double autoScaleFactor = window.pData->autoScaleFactor;
+    const Rectangle<int>& exposeArea(window.pData->exposeArea);
+
+    // only draw within the area being exposed
+    cairo_save(handle);
+    cairo_rectangle(handle, exposeArea.getX(), exposeArea.getY(), exposeArea.getWidth(), exposeArea.getHeight());
+    cairo_clip(handle);
 
     cairo_matrix_t matrix;
     cairo_get_matrix(handle, &matrix);
@@ -846,7 +925,17 @@ void TopLevelWidget::PrivateData::display()
     cairo_set_matrix(handle, &matrix);
 
     // now draw subwidgets if there are any
-    selfw->pData->displaySubWidgets(width, height, autoScaleFactor);
+    selfw->pData->displaySubWidgets(width, height, autoScaleFactor, exposeArea);
+
+    cairo_restore(handle);
+}
+
+// -----------------------------------------------------------------------
+
+bool Window::PrivateData::canRedrawPartially() const
+{
+    // pugl only flushes the exposed area into the view
+    return true;
 }
 
 // -----------------------------------------------------------------------
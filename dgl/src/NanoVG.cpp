@@ -26,6 +26,12 @@
 # include "Resources.hpp"
 #endif
 
+#include "../../distrho/extra/Mutex.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <list>
+
 // -----------------------------------------------------------------------
 
 #if defined(DISTRHO_OS_WINDOWS)
@@ -103,6 +109,11 @@ DGL_EXT(PFNGLUNIFORMBLOCKBINDINGPROC,      glUniformBlockBinding)
 # define glGenVertexArrays glGenVertexArraysAPPLE
 #endif
 
+#if defined(DGL_USE_SINGLE_BUFFER) && DGL_USE_SINGLE_BUFFER
+// keep the scissor set by DGL, which limits partial redraws to the area being exposed
+# define NANOVG_GL_KEEP_SCISSOR_TEST 1
+#endif
+
 #include "nanovg/nanovg_gl.h"
 
 #ifdef DGL_USE_NANOVG_FBO
@@ -230,6 +241,271 @@ Color::operator NVGcolor() const noexcept
     return nc;
 }
 
+// -----------------------------------------------------------------------
+// Process-wide shared resources
+
+/* Images and font files are kept in a process-wide cache for as long as any NanoVG context uses them,
+   so that opening many instances of the same plugin only reads each font file once and decodes each image
+   only once for all but the first instance.
+   Resources are identified by their contents, not by their memory location or file name.
+   Textures are still uploaded per context, as DGL does not create shared OpenGL contexts, so decoded pixels
+   are only kept while at least 2 contexts use the image. A single instance only keeps the encoded image data. */
+
+enum NanoSharedResourceType {
+    kSharedImageFromFile,
+    kSharedImageFromMemory,
+    kSharedFontFromFile
+};
+
+struct NanoSharedResource {
+    struct User {
+        NVGcontext* context;
+        int imageId; // 0 for fonts, which are only released together with their context
+
+        bool operator==(const User& other) const noexcept
+        {
+            return context == other.context && imageId == other.imageId;
+        }
+    };
+
+    NanoSharedResourceType type;
+    uint64_t hash;
+    uchar* source; // encoded image or font file contents, used to verify matches
+    uint sourceSize;
+    uchar* data;   // decoded image pixels (can be null), or same as source for fonts
+    int width, height;
+    std::list<User> users;
+};
+
+struct NanoSharedResourceCache {
+    Mutex mutex;
+    std::list<NanoSharedResource*> resources;
+};
+
+static NanoSharedResourceCache& getSharedResourceCache()
+{
+    static NanoSharedResourceCache cache;
+    return cache;
+}
+
+// implemented at the end of this file, after stb_image
+static uchar* decodeSharedImage(const uchar* data, uint dataSize, bool fromFile, int& width, int& height);
+static void freeSharedImage(uchar* data);
+
+static uint64_t hashSharedResource(const uchar* const data, const uint dataSize) noexcept
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (uint i = 0; i < dataSize; ++i)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static uchar* readSharedResourceFile(const char* const filename, uint& dataSize)
+{
+    FILE* const fp = std::fopen(filename, "rb");
+
+    if (fp == nullptr)
+        return nullptr;
+
+    uchar* data = nullptr;
+    long size = 0;
+
+    if (std::fseek(fp, 0, SEEK_END) == 0 && (size = std::ftell(fp)) > 0 && std::fseek(fp, 0, SEEK_SET) == 0)
+    {
+        data = static_cast<uchar*>(std::malloc(static_cast<size_t>(size)));
+
+        if (data != nullptr && std::fread(data, 1, static_cast<size_t>(size), fp) != static_cast<size_t>(size))
+        {
+            std::free(data);
+            data = nullptr;
+        }
+    }
+
+    std::fclose(fp);
+
+    dataSize = data != nullptr ? static_cast<uint>(size) : 0;
+    return data;
+}
+
+static void freeSharedResource(NanoSharedResource* const resource)
+{
+    if (resource->type != kSharedFontFromFile && resource->data != nullptr)
+        freeSharedImage(resource->data);
+
+    std::free(resource->source);
+    delete resource;
+}
+
+// decoded pixels are only worth keeping if another context might create the same image again
+static void trimSharedImage(NanoSharedResource* const resource)
+{
+    if (resource->type == kSharedFontFromFile || resource->data == nullptr)
+        return;
+
+    const std::list<NanoSharedResource::User>& users(resource->users);
+
+    for (std::list<NanoSharedResource::User>::const_iterator it = users.begin(); it != users.end(); ++it)
+    {
+        if (it->context != users.front().context)
+            return;
+    }
+
+    freeSharedImage(resource->data);
+    resource->data = nullptr;
+}
+
+// must be called with the cache mutex locked
+static NanoSharedResource* findSharedResource(NanoSharedResourceCache& cache,
+                                              const NanoSharedResourceType type,
+                                              const uint64_t hash,
+                                              const uchar* const source,
+                                              const uint sourceSize)
+{
+    for (std::list<NanoSharedResource*>::iterator it = cache.resources.begin(); it != cache.resources.end(); ++it)
+    {
+        NanoSharedResource* const resource(*it);
+
+        // the hash only avoids comparing contents of resources that are obviously different
+        if (resource->type == type && resource->hash == hash && resource->sourceSize == sourceSize &&
+            std::memcmp(resource->source, source, sourceSize) == 0)
+            return resource;
+    }
+
+    return nullptr;
+}
+
+/* Create an image from encoded @a source contents, decoding it only if there are no cached pixels.
+   The cache entry is kept until the returned image is released with releaseSharedResources(). */
+static int createSharedImage(NVGcontext* const context,
+                             const NanoSharedResourceType type,
+                             const uchar* const source,
+                             const uint sourceSize,
+                             const int imageFlags)
+{
+    const uint64_t hash = hashSharedResource(source, sourceSize);
+
+    NanoSharedResourceCache& cache(getSharedResourceCache());
+    const MutexLocker cml(cache.mutex);
+
+    NanoSharedResource* resource = findSharedResource(cache, type, hash, source, sourceSize);
+
+    if (resource == nullptr)
+    {
+        uchar* const sourceCopy = static_cast<uchar*>(std::malloc(sourceSize));
+        DISTRHO_SAFE_ASSERT_RETURN(sourceCopy != nullptr, 0);
+
+        std::memcpy(sourceCopy, source, sourceSize);
+
+        resource = new NanoSharedResource;
+        resource->type = type;
+        resource->hash = hash;
+        resource->source = sourceCopy;
+        resource->sourceSize = sourceSize;
+        resource->data = nullptr;
+        resource->width = resource->height = 0;
+        cache.resources.push_back(resource);
+    }
+
+    if (resource->data == nullptr)
+        resource->data = decodeSharedImage(source, sourceSize, type == kSharedImageFromFile,
+                                           resource->width, resource->height);
+
+    const int imageId = resource->data != nullptr
+                      ? nvgCreateImageRGBA(context, resource->width, resource->height, imageFlags, resource->data)
+                      : 0;
+
+    if (imageId != 0)
+    {
+        const NanoSharedResource::User user = { context, imageId };
+        resource->users.push_back(user);
+    }
+
+    if (resource->users.empty())
+    {
+        cache.resources.remove(resource);
+        freeSharedResource(resource);
+    }
+    else
+    {
+        trimSharedImage(resource);
+    }
+
+    return imageId;
+}
+
+/* Get the shared copy of a font file, given its full @a source contents which this function takes ownership of.
+   The returned data stays valid until releaseSharedResources() is called for @a context. */
+static const NanoSharedResource* acquireSharedFont(NVGcontext* const context, uchar* const source, const uint sourceSize)
+{
+    const uint64_t hash = hashSharedResource(source, sourceSize);
+
+    NanoSharedResourceCache& cache(getSharedResourceCache());
+    const MutexLocker cml(cache.mutex);
+
+    NanoSharedResource* resource = findSharedResource(cache, kSharedFontFromFile, hash, source, sourceSize);
+
+    if (resource != nullptr)
+    {
+        std::free(source);
+    }
+    else
+    {
+        resource = new NanoSharedResource;
+        resource->type = kSharedFontFromFile;
+        resource->hash = hash;
+        resource->source = source;
+        resource->sourceSize = sourceSize;
+        resource->data = source;
+        resource->width = resource->height = 0;
+        cache.resources.push_back(resource);
+    }
+
+    const NanoSharedResource::User user = { context, 0 };
+
+    if (std::find(resource->users.begin(), resource->users.end(), user) == resource->users.end())
+        resource->users.push_back(user);
+
+    return resource;
+}
+
+/* Release shared resources used by @a context.
+   If @a imageId is 0, everything related to @a context is released, otherwise only that image. */
+static void releaseSharedResources(NVGcontext* const context, const int imageId = 0)
+{
+    NanoSharedResourceCache& cache(getSharedResourceCache());
+    const MutexLocker cml(cache.mutex);
+
+    for (std::list<NanoSharedResource*>::iterator it = cache.resources.begin(); it != cache.resources.end();)
+    {
+        NanoSharedResource* const resource(*it);
+
+        for (std::list<NanoSharedResource::User>::iterator it2 = resource->users.begin(); it2 != resource->users.end();)
+        {
+            if (it2->context == context && (imageId == 0 || it2->imageId == imageId))
+                it2 = resource->users.erase(it2);
+            else
+                ++it2;
+        }
+
+        if (resource->users.empty())
+        {
+            freeSharedResource(resource);
+            it = cache.resources.erase(it);
+        }
+        else
+        {
+            trimSharedImage(resource);
+            ++it;
+        }
+    }
+}
+
 // -----------------------------------------------------------------------
 // NanoImage
 
@@ -249,13 +525,19 @@ NanoImage::NanoImage(const Handle& handle)
 NanoImage::~NanoImage()
 {
     if (fHandle.context != nullptr && fHandle.imageId != 0)
+    {
+        releaseSharedResources(fHandle.context, fHandle.imageId);
         nvgDeleteImage(fHandle.context, fHandle.imageId);
+    }
 }
 
 NanoImage& NanoImage::operator=(const Handle& handle)
 {
     if (fHandle.context != nullptr && fHandle.imageId != 0)
+    {
+        releaseSharedResources(fHandle.context, fHandle.imageId);
         nvgDeleteImage(fHandle.context, fHandle.imageId);
+    }
 
     fHandle.context = handle.context;
     fHandle.imageId = handle.imageId;
@@ -355,7 +637,10 @@ NanoVG::~NanoVG()
     DISTRHO_CUSTOM_SAFE_ASSERT("Destroying NanoVG context with still active frame", ! fInFrame);
 
     if (fContext != nullptr && ! fIsSubWidget)
+    {
+        releaseSharedResources(fContext);
         nvgDeleteGL(fContext);
+    }
 }
 
 // -----------------------------------------------------------------------
@@ -684,7 +969,16 @@ NanoImage::Handle NanoVG::createImageFromFile(const char* filename, int imageFla
     if (fContext == nullptr) return NanoImage::Handle();
     DISTRHO_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', NanoImage::Handle());
 
-    return NanoImage::Handle(fContext, nvgCreateImage(fContext, filename, imageFlags));
+    uint dataSize;
+    uchar* const data = readSharedResourceFile(filename, dataSize);
+
+    if (data == nullptr)
+        return NanoImage::Handle();
+
+    const int imageId = createSharedImage(fContext, kSharedImageFromFile, data, dataSize, imageFlags);
+    std::free(data);
+
+    return NanoImage::Handle(fContext, imageId);
 }
 
 NanoImage::Handle NanoVG::createImageFromMemory(const uchar* data, uint dataSize, ImageFlags imageFlags)
@@ -698,7 +992,7 @@ NanoImage::Handle NanoVG::createImageFromMemory(const uchar* data, uint dataSize
     DISTRHO_SAFE_ASSERT_RETURN(data != nullptr, NanoImage::Handle());
     DISTRHO_SAFE_ASSERT_RETURN(dataSize > 0,    NanoImage::Handle());
 
-    return NanoImage::Handle(fContext, nvgCreateImageMem(fContext, imageFlags, data, static_cast<int>(dataSize)));
+    return NanoImage::Handle(fContext, createSharedImage(fContext, kSharedImageFromMemory, data, dataSize, imageFlags));
 }
 
 NanoImage::Handle NanoVG::createImageFromRawMemory(uint w, uint h, const uchar* data,
@@ -930,7 +1224,15 @@ NanoVG::FontId NanoVG::createFontFromFile(const char* name, const char* filename
     DISTRHO_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', -1);
     DISTRHO_SAFE_ASSERT_RETURN(fContext != nullptr, -1);
 
-    return nvgCreateFont(fContext, name, filename);
+    uint dataSize;
+    uchar* const data = readSharedResourceFile(filename, dataSize);
+
+    if (data == nullptr)
+        return -1;
+
+    const NanoSharedResource* const font = acquireSharedFont(fContext, data, dataSize);
+
+    return nvgCreateFontMem(fContext, name, font->data, static_cast<int>(font->sourceSize), 0);
 }
 
 NanoVG::FontId NanoVG::createFontFromMemory(const char* name, const uchar* data, uint dataSize, bool freeData)
@@ -1216,3 +1518,28 @@ extern "C" {
 #endif
 
 // -----------------------------------------------------------------------
+
+START_NAMESPACE_DGL
+
+static uchar* decodeSharedImage(const uchar* const data, const uint dataSize, const bool fromFile,
+                                int& width, int& height)
+{
+    // same settings as nvgCreateImage and nvgCreateImageMem
+    if (fromFile)
+    {
+        stbi_set_unpremultiply_on_load(1);
+        stbi_convert_iphone_png_to_rgb(1);
+    }
+
+    int n;
+    return stbi_load_from_memory(data, static_cast<int>(dataSize), &width, &height, &n, 4);
+}
+
+static void freeSharedImage(uchar* const data)
+{
+    stbi_image_free(data);
+}
+
+END_NAMESPACE_DGL
+
+// -----------------------------------------------------------------------
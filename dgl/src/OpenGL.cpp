@@ -27,8 +27,32 @@
 #include "WidgetPrivateData.hpp"
 #include "WindowPrivateData.hpp"
 
+#if defined(DISTRHO_OS_MAC) && !defined(DGL_USE_OPENGL3)
+// framebuffer objects are only defined as extensions for legacy OpenGL
+# include <OpenGL/glext.h>
+#endif
+
 START_NAMESPACE_DGL
 
+// --------------------------------------------------------------------------------------------------------------------
+// Load framebuffer symbols on Windows, used for cached subwidget drawing
+
+#if defined(DISTRHO_OS_WINDOWS)
+# include <windows.h>
+# define DGL_EXT(PROC, func) static PROC func;
+DGL_EXT(PFNGLBINDFRAMEBUFFERPROC,          glBindFramebuffer)
+DGL_EXT(PFNGLBINDRENDERBUFFERPROC,         glBindRenderbuffer)
+DGL_EXT(PFNGLCHECKFRAMEBUFFERSTATUSPROC,   glCheckFramebufferStatus)
+DGL_EXT(PFNGLDELETEFRAMEBUFFERSPROC,       glDeleteFramebuffers)
+DGL_EXT(PFNGLDELETERENDERBUFFERSPROC,      glDeleteRenderbuffers)
+DGL_EXT(PFNGLFRAMEBUFFERRENDERBUFFERPROC,  glFramebufferRenderbuffer)
+DGL_EXT(PFNGLFRAMEBUFFERTEXTURE2DPROC,     glFramebufferTexture2D)
+DGL_EXT(PFNGLGENFRAMEBUFFERSPROC,          glGenFramebuffers)
+DGL_EXT(PFNGLGENRENDERBUFFERSPROC,         glGenRenderbuffers)
+DGL_EXT(PFNGLRENDERBUFFERSTORAGEPROC,      glRenderbufferStorage)
+# undef DGL_EXT
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // OpenGLImage
 
@@ -156,14 +180,374 @@ OpenGLImage::OpenGLImage(const char* const rdata, const Size<uint>& s, const GLe
 #endif
 
 // --------------------------------------------------------------------------------------------------------------------
+// OpenGLImageAtlas
+
+// each quad is 2 triangles, each vertex has x, y and texture coordinates
+static constexpr const uint kAtlasFloatsPerVertex = 4;
+static constexpr const uint kAtlasFloatsPerQuad = kAtlasFloatsPerVertex * 6;
+
+OpenGLImageAtlas::OpenGLImageAtlas(const uint width, const uint height)
+    : images(),
+      size(width, height),
+      rowX(1),
+      rowY(1),
+      rowHeight(0),
+      numUploaded(0),
+      textureId(0)
+{
+    DISTRHO_SAFE_ASSERT(width > 2 && height > 2);
+}
+
+OpenGLImageAtlas::~OpenGLImageAtlas()
+{
+    if (textureId != 0)
+        glDeleteTextures(1, &textureId);
+}
+
+bool OpenGLImageAtlas::addImage(const OpenGLImage& image, uint& imageId)
+{
+    DISTRHO_SAFE_ASSERT_RETURN(image.isValid(), false);
+
+    const ImageFormat format = image.getFormat();
+    DISTRHO_SAFE_ASSERT_RETURN(format != kImageFormatNull && format != kImageFormatGrayscale, false);
+
+    const uint width = image.getWidth();
+    const uint height = image.getHeight();
+
+    // move to a new row if needed, leaving a gap between images
+    if (rowX + width + 1 > size.getWidth())
+    {
+        rowX = 1;
+        rowY += rowHeight + 1;
+        rowHeight = 0;
+    }
+
+    if (rowX + width + 1 > size.getWidth() || rowY + height + 1 > size.getHeight())
+    {
+        d_stderr2("OpenGLImageAtlas: image %ux%u does not fit", width, height);
+        return false;
+    }
+
+    const ImageData data = { image.getRawData(), format, Rectangle<uint>(rowX, rowY, width, height) };
+    images.push_back(data);
+
+    rowX += width + 1;
+    rowHeight = std::max(rowHeight, height);
+
+    imageId = static_cast<uint>(images.size() - 1);
+    return true;
+}
+
+uint OpenGLImageAtlas::getImageCount() const noexcept
+{
+    return static_cast<uint>(images.size());
+}
+
+Size<uint> OpenGLImageAtlas::getImageSize(const uint imageId) const noexcept
+{
+    DISTRHO_SAFE_ASSERT_RETURN(imageId < images.size(), Size<uint>());
+
+    return images[imageId].area.getSize();
+}
+
+const Size<uint>& OpenGLImageAtlas::getSize() const noexcept
+{
+    return size;
+}
+
+GLuint OpenGLImageAtlas::prepareTexture()
+{
+    if (textureId != 0 && numUploaded == images.size())
+        return textureId;
+
+    const GLsizei width = static_cast<GLsizei>(size.getWidth());
+    const GLsizei height = static_cast<GLsizei>(size.getHeight());
+
+    if (textureId == 0)
+    {
+        glGenTextures(1, &textureId);
+        DISTRHO_SAFE_ASSERT_RETURN(textureId != 0, 0);
+
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        // start fully transparent, so the gaps between images stay empty
+        void* const empty = std::calloc(static_cast<size_t>(width) * static_cast<size_t>(height), 4);
+        DISTRHO_SAFE_ASSERT(empty != nullptr);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, empty);
+
+        std::free(empty);
+    }
+    else
+    {
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    }
+
+    for (; numUploaded < images.size(); ++numUploaded)
+    {
+        const ImageData& data(images[numUploaded]);
+
+        glTexSubImage2D(GL_TEXTURE_2D,
+                        0,
+                        static_cast<GLint>(data.area.getX()),
+                        static_cast<GLint>(data.area.getY()),
+                        static_cast<GLsizei>(data.area.getWidth()),
+                        static_cast<GLsizei>(data.area.getHeight()),
+                        asOpenGLImageFormat(data.format),
+                        GL_UNSIGNED_BYTE,
+                        data.rawData);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return textureId;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// OpenGLImageBatch
+
+OpenGLImageBatch::OpenGLImageBatch(OpenGLImageAtlas& a)
+    : atlas(a),
+      vertices() {}
+
+void OpenGLImageBatch::add(const uint imageId, const Point<int>& pos)
+{
+    DISTRHO_SAFE_ASSERT_RETURN(imageId < atlas.images.size(),);
+
+    add(imageId, pos, Rectangle<uint>(Point<uint>(0, 0), atlas.images[imageId].area.getSize()));
+}
 
-void SubWidget::PrivateData::display(const uint width, const uint height, const double autoScaleFactor)
+void OpenGLImageBatch::add(const uint imageId, const Point<int>& pos, const Rectangle<uint>& sourceArea)
+{
+    DISTRHO_SAFE_ASSERT_RETURN(imageId < atlas.images.size(),);
+    DISTRHO_SAFE_ASSERT_RETURN(sourceArea.isValid(),);
+
+    const Rectangle<uint>& area(atlas.images[imageId].area);
+    DISTRHO_SAFE_ASSERT_RETURN(sourceArea.getX() + sourceArea.getWidth() <= area.getWidth(),);
+    DISTRHO_SAFE_ASSERT_RETURN(sourceArea.getY() + sourceArea.getHeight() <= area.getHeight(),);
+
+    const GLfloat atlasWidth = static_cast<GLfloat>(atlas.size.getWidth());
+    const GLfloat atlasHeight = static_cast<GLfloat>(atlas.size.getHeight());
+
+    const GLfloat x1 = static_cast<GLfloat>(pos.getX());
+    const GLfloat y1 = static_cast<GLfloat>(pos.getY());
+    const GLfloat x2 = x1 + static_cast<GLfloat>(sourceArea.getWidth());
+    const GLfloat y2 = y1 + static_cast<GLfloat>(sourceArea.getHeight());
+
+    const GLfloat u1 = static_cast<GLfloat>(area.getX() + sourceArea.getX()) / atlasWidth;
+    const GLfloat v1 = static_cast<GLfloat>(area.getY() + sourceArea.getY()) / atlasHeight;
+    const GLfloat u2 = u1 + static_cast<GLfloat>(sourceArea.getWidth()) / atlasWidth;
+    const GLfloat v2 = v1 + static_cast<GLfloat>(sourceArea.getHeight()) / atlasHeight;
+
+    const GLfloat quad[kAtlasFloatsPerQuad] = {
+        x1, y1, u1, v1,
+        x1, y2, u1, v2,
+        x2, y2, u2, v2,
+        x1, y1, u1, v1,
+        x2, y2, u2, v2,
+        x2, y1, u2, v1,
+    };
+    vertices.insert(vertices.end(), quad, quad + kAtlasFloatsPerQuad);
+}
+
+uint OpenGLImageBatch::getCount() const noexcept
+{
+    return static_cast<uint>(vertices.size() / kAtlasFloatsPerQuad);
+}
+
+void OpenGLImageBatch::clear() noexcept
+{
+    vertices.clear();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static bool isPartialExpose(const Rectangle<int>& exposeArea, const uint width, const uint height) noexcept
+{
+    return exposeArea != Rectangle<int>(0, 0, static_cast<int>(width), static_cast<int>(height));
+}
+
+static void setScissorToExposeArea(const Rectangle<int>& exposeArea, const uint height)
+{
+    glScissor(exposeArea.getX(),
+              static_cast<int>(height) - exposeArea.getY() - exposeArea.getHeight(),
+              exposeArea.getWidth(),
+              exposeArea.getHeight());
+    glEnable(GL_SCISSOR_TEST);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static bool loadFramebufferFunctions()
+{
+#if defined(DISTRHO_OS_WINDOWS)
+# if defined(__GNUC__) && (__GNUC__ >= 9)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wcast-function-type"
+# endif
+    static bool needsInit = true;
+# define DGL_EXT(PROC, func) \
+      if (needsInit) func = (PROC) wglGetProcAddress ( #func ); \
+      DISTRHO_SAFE_ASSERT_RETURN(func != nullptr, false);
+DGL_EXT(PFNGLBINDFRAMEBUFFERPROC,          glBindFramebuffer)
+DGL_EXT(PFNGLBINDRENDERBUFFERPROC,         glBindRenderbuffer)
+DGL_EXT(PFNGLCHECKFRAMEBUFFERSTATUSPROC,   glCheckFramebufferStatus)
+DGL_EXT(PFNGLDELETEFRAMEBUFFERSPROC,       glDeleteFramebuffers)
+DGL_EXT(PFNGLDELETERENDERBUFFERSPROC,      glDeleteRenderbuffers)
+DGL_EXT(PFNGLFRAMEBUFFERRENDERBUFFERPROC,  glFramebufferRenderbuffer)
+DGL_EXT(PFNGLFRAMEBUFFERTEXTURE2DPROC,     glFramebufferTexture2D)
+DGL_EXT(PFNGLGENFRAMEBUFFERSPROC,          glGenFramebuffers)
+DGL_EXT(PFNGLGENRENDERBUFFERSPROC,         glGenRenderbuffers)
+DGL_EXT(PFNGLRENDERBUFFERSTORAGEPROC,      glRenderbufferStorage)
+# undef DGL_EXT
+    needsInit = false;
+# if defined(__GNUC__) && (__GNUC__ >= 9)
+#  pragma GCC diagnostic pop
+# endif
+#endif
+    return true;
+}
+
+static bool createCacheFramebuffer(GLuint& framebuffer, GLuint& renderbuffer, GLuint& texture,
+                                   const GLsizei width, const GLsizei height)
+{
+    glGenTextures(1, &texture);
+    DISTRHO_SAFE_ASSERT_RETURN(texture != 0, false);
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // stencil buffer is needed for NanoVG
+    glGenRenderbuffers(1, &renderbuffer);
+    DISTRHO_SAFE_ASSERT_RETURN(renderbuffer != 0, false);
+
+    glGenFramebuffers(1, &framebuffer);
+    DISTRHO_SAFE_ASSERT_RETURN(framebuffer != 0, false);
+
+    GLint prevFramebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFramebuffer);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_STENCIL_INDEX8, width, height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffer);
+
+    bool ok = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+   #ifdef GL_DEPTH24_STENCIL8
+    // not all implementations support stencil-only buffers
+    if (! ok)
+    {
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffer);
+        ok = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+   #endif
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(prevFramebuffer));
+
+    return ok;
+}
+
+bool SubWidget::PrivateData::updateCache(const Rectangle<int>& area)
+{
+    if (! loadFramebufferFunctions())
+        return false;
+
+    if (cache.framebuffer == 0 || cache.area.getSize() != area.getSize())
+    {
+        destroyCache();
+
+        if (! createCacheFramebuffer(cache.framebuffer, cache.renderbuffer, cache.texture,
+                                     area.getWidth(), area.getHeight()))
+        {
+            d_stderr2("Failed to create framebuffer for cached subwidget drawing");
+            destroyCache();
+            cachedDrawing = false;
+            return false;
+        }
+    }
+
+    GLint prevFramebuffer = 0;
+    GLint prevViewport[4] = {};
+    GLint prevScissor[4] = {};
+    GLfloat prevClearColor[4] = {};
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+    glGetIntegerv(GL_SCISSOR_BOX, prevScissor);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, prevClearColor);
+    const bool prevScissorEnabled = glIsEnabled(GL_SCISSOR_TEST);
+
+    // draw the full widget into the framebuffer, keeping the same viewport relative to the cached area
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, cache.framebuffer);
+    glViewport(prevViewport[0] - area.getX(), prevViewport[1] - area.getY(), prevViewport[2], prevViewport[3]);
+    glClearColor(0.f, 0.f, 0.f, 0.f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    self->onDisplay();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(prevFramebuffer));
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+    glScissor(prevScissor[0], prevScissor[1], prevScissor[2], prevScissor[3]);
+    glClearColor(prevClearColor[0], prevClearColor[1], prevClearColor[2], prevClearColor[3]);
+
+    if (prevScissorEnabled)
+        glEnable(GL_SCISSOR_TEST);
+
+    cache.area = area;
+    cache.needsUpdate = false;
+    return true;
+}
+
+void SubWidget::PrivateData::destroyCache()
+{
+    if (cache.framebuffer != 0)
+    {
+        glDeleteFramebuffers(1, &cache.framebuffer);
+        cache.framebuffer = 0;
+    }
+
+    if (cache.renderbuffer != 0)
+    {
+        glDeleteRenderbuffers(1, &cache.renderbuffer);
+        cache.renderbuffer = 0;
+    }
+
+    if (cache.texture != 0)
+    {
+        glDeleteTextures(1, &cache.texture);
+        cache.texture = 0;
+    }
+
+    cache.needsUpdate = true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void SubWidget::PrivateData::display(const uint width, const uint height, const double autoScaleFactor,
+                                     const Rectangle<int>& exposeArea)
 {
     if (skipDrawing)
         return;
 
+    const bool partialExpose = isPartialExpose(exposeArea, width, height);
     bool needsDisableScissor = false;
 
+    // area covered by the widget in OpenGL coordinates, if it can use cached drawing
+    Rectangle<int> cacheArea;
+
     if (needsViewportScaling)
     {
         // limit viewport to widget bounds
@@ -182,12 +566,18 @@ void SubWidget::PrivateData::display(const uint width, const uint height, const
         {
             const int y = static_cast<int>(height - self->getHeight()) - absolutePos.getY();
             glViewport(x, y, w, h);
+
+            if (cachedDrawing)
+                cacheArea = Rectangle<int>(x, y, w, h);
         }
     }
     else if (needsFullViewportForDrawing || (absolutePos.isZero() && self->getSize() == Size<uint>(width, height)))
     {
         // full viewport size
         glViewport(0, 0, static_cast<int>(width), static_cast<int>(height));
+
+        if (cachedDrawing && ! needsFullViewportForDrawing)
+            cacheArea = Rectangle<int>(0, 0, static_cast<int>(width), static_cast<int>(height));
     }
     else
     {
@@ -198,22 +588,45 @@ void SubWidget::PrivateData::display(const uint width, const uint height, const
                    static_cast<int>(height));
 
         // then cut the outer bounds
-        glScissor(d_roundToIntPositive(absolutePos.getX() * autoScaleFactor),
-                  d_roundToIntPositive(height - (static_cast<int>(self->getHeight()) + absolutePos.getY()) * autoScaleFactor),
-                  d_roundToIntPositive(self->getWidth() * autoScaleFactor),
-                  d_roundToIntPositive(self->getHeight() * autoScaleFactor));
+        int x = d_roundToIntPositive(absolutePos.getX() * autoScaleFactor);
+        int y = d_roundToIntPositive(height - (static_cast<int>(self->getHeight()) + absolutePos.getY()) * autoScaleFactor);
+        int w = d_roundToIntPositive(self->getWidth() * autoScaleFactor);
+        int h = d_roundToIntPositive(self->getHeight() * autoScaleFactor);
+
+        if (cachedDrawing)
+            cacheArea = Rectangle<int>(x, y, w, h);
 
+        // and limit those to the area being exposed
+        if (partialExpose)
+        {
+            const int ex = exposeArea.getX();
+            const int ey = static_cast<int>(height) - exposeArea.getY() - exposeArea.getHeight();
+            const int x2 = std::min(x + w, ex + exposeArea.getWidth());
+            const int y2 = std::min(y + h, ey + exposeArea.getHeight());
+            x = std::max(x, ex);
+            y = std::max(y, ey);
+            w = std::max(0, x2 - x);
+            h = std::max(0, y2 - y);
+        }
+
+        glScissor(x, y, w, h);
         glEnable(GL_SCISSOR_TEST);
         needsDisableScissor = true;
     }
 
-    // display widget
-    self->onDisplay();
+    // display widget, reusing its last drawing if possible
+    if (cacheArea.isValid() && ((! cache.needsUpdate && cache.area == cacheArea) || updateCache(cacheArea)))
+        drawCache();
+    else
+        self->onDisplay();
 
-    if (needsDisableScissor)
+    // keep drawing limited to the area being exposed, the widget might have changed the scissor too
+    if (partialExpose)
+        setScissorToExposeArea(exposeArea, height);
+    else if (needsDisableScissor)
         glDisable(GL_SCISSOR_TEST);
 
-    selfw->pData->displaySubWidgets(width, height, autoScaleFactor);
+    selfw->pData->displaySubWidgets(width, height, autoScaleFactor, exposeArea);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -227,14 +640,35 @@ void TopLevelWidget::PrivateData::display()
     const uint width  = size.getWidth();
     const uint height = size.getHeight();
 
+    const Rectangle<int>& exposeArea(window.pData->exposeArea);
+    const bool partialExpose = isPartialExpose(exposeArea, width, height);
+
     // full viewport size
     glViewport(0, 0, static_cast<int>(width), static_cast<int>(height));
 
+    // only draw within the area being exposed
+    if (partialExpose)
+        setScissorToExposeArea(exposeArea, height);
+
     // main widget drawing
     self->onDisplay();
 
+    if (partialExpose)
+        setScissorToExposeArea(exposeArea, height);
+
     // now draw subwidgets if there are any
-    selfw->pData->displaySubWidgets(width, height, window.pData->autoScaleFactor);
+    selfw->pData->displaySubWidgets(width, height, window.pData->autoScaleFactor, exposeArea);
+
+    if (partialExpose)
+        glDisable(GL_SCISSOR_TEST);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+bool Window::PrivateData::canRedrawPartially() const
+{
+    // contents outside of the exposed area are only kept when not swapping buffers
+    return puglGetViewHint(view, PUGL_DOUBLE_BUFFER) == PUGL_FALSE;
 }
 
 // --------------------------------------------------------------------------------------------------------------------
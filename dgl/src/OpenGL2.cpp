@@ -23,7 +23,7 @@
 #include "../Color.hpp"
 #include "../ImageWidgets.hpp"
 
-// #include "SubWidgetPrivateData.hpp"
+#include "SubWidgetPrivateData.hpp"
 // #include "TopLevelWidgetPrivateData.hpp"
 // #include "WidgetPrivateData.hpp"
 #include "WindowPrivateData.hpp"
@@ -371,33 +371,28 @@ static void drawOpenGLImage(const OpenGLImage& image, const Point<int>& pos, con
         setupCalled = true;
     }
 
+    const GLfloat x = static_cast<GLfloat>(pos.getX());
+    const GLfloat y = static_cast<GLfloat>(pos.getY());
+    const GLfloat w = static_cast<GLfloat>(image.getWidth());
+    const GLfloat h = static_cast<GLfloat>(image.getHeight());
+
+    const GLfloat vertices[] = { x, y, x + w, y, x + w, y + h, x, y + h };
+    static constexpr const GLfloat texCoords[] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f };
+
     glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 
     glEnable(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, textureId);
 
-    glBegin(GL_QUADS);
-
-    {
-        const int x = pos.getX();
-        const int y = pos.getY();
-        const int w = static_cast<int>(image.getWidth());
-        const int h = static_cast<int>(image.getHeight());
-
-        glTexCoord2f(0.0f, 0.0f);
-        glVertex2d(x, y);
-
-        glTexCoord2f(1.0f, 0.0f);
-        glVertex2d(x+w, y);
-
-        glTexCoord2f(1.0f, 1.0f);
-        glVertex2d(x+w, y+h);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, vertices);
+    glTexCoordPointer(2, GL_FLOAT, 0, texCoords);
 
-        glTexCoord2f(0.0f, 1.0f);
-        glVertex2d(x, y+h);
-    }
+    glDrawArrays(GL_QUADS, 0, 4);
 
-    glEnd();
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
 
     glBindTexture(GL_TEXTURE_2D, 0);
     glDisable(GL_TEXTURE_2D);
@@ -425,6 +420,46 @@ void OpenGLImage::drawAt(const Point<int>& pos)
 }
 #endif
 
+// --------------------------------------------------------------------------------------------------------------------
+// OpenGLImageBatch
+
+void OpenGLImageBatch::draw(const GraphicsContext&)
+{
+    if (vertices.empty())
+        return;
+
+    const GLuint textureId = atlas.prepareTexture();
+
+    if (textureId == 0)
+    {
+        vertices.clear();
+        return;
+    }
+
+    // x, y, then texture coordinates
+    static constexpr const GLsizei stride = sizeof(GLfloat) * 4;
+
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(2, GL_FLOAT, stride, vertices.data());
+    glTexCoordPointer(2, GL_FLOAT, stride, vertices.data() + 2);
+
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size() / 4));
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+
+    vertices.clear();
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // ImageBaseAboutWindow
 
@@ -547,6 +582,67 @@ template class ImageBaseSlider<OpenGLImage>;
 
 template class ImageBaseSwitch<OpenGLImage>;
 
+// --------------------------------------------------------------------------------------------------------------------
+// SubWidget cached drawing
+
+void SubWidget::PrivateData::drawCache()
+{
+    // cached contents use premultiplied alpha
+    GLboolean blendEnabled;
+    GLint blendSrc, blendDst;
+    glGetBooleanv(GL_BLEND, &blendEnabled);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSrc);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDst);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    glViewport(cache.area.getX(), cache.area.getY(), cache.area.getWidth(), cache.area.getHeight());
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    static constexpr const GLfloat vertices[] = {
+        -1.f,  1.f, 0.f, 1.f,
+        -1.f, -1.f, 0.f, 0.f,
+         1.f, -1.f, 1.f, 0.f,
+         1.f,  1.f, 1.f, 1.f,
+    };
+    static constexpr const GLsizei stride = sizeof(GLfloat) * 4;
+
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, cache.texture);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(2, GL_FLOAT, stride, vertices);
+    glTexCoordPointer(2, GL_FLOAT, stride, vertices + 2);
+
+    glDrawArrays(GL_QUADS, 0, 4);
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+
+    if (! blendEnabled)
+        glDisable(GL_BLEND);
+
+    glBlendFunc(blendSrc, blendDst);
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 
 void Window::PrivateData::createContextIfNeeded()
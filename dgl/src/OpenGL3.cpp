@@ -23,6 +23,7 @@
 #include "../Color.hpp"
 #include "../ImageWidgets.hpp"
 
+#include "SubWidgetPrivateData.hpp"
 #include "WindowPrivateData.hpp"
 
 // templated classes
@@ -643,6 +644,62 @@ void OpenGLImage::drawAt(const Point<int>& pos)
 }
 #endif
 
+// --------------------------------------------------------------------------------------------------------------------
+// OpenGLImageBatch
+
+void OpenGLImageBatch::draw(const GraphicsContext& context)
+{
+    if (vertices.empty())
+        return;
+
+    const OpenGL3GraphicsContext& gl3context = static_cast<const OpenGL3GraphicsContext&>(context);
+    const GLuint textureId = gl3context.program != 0 ? atlas.prepareTexture() : 0;
+
+    if (textureId == 0)
+    {
+        vertices.clear();
+        return;
+    }
+
+    // x, y, then texture coordinates
+    static constexpr const uint floatsPerVertex = 4;
+
+    // convert positions to -1.0 to +1.0 range
+    const GLfloat scaleX = 2.f / static_cast<GLfloat>(gl3context.width);
+    const GLfloat scaleY = -2.f / static_cast<GLfloat>(gl3context.height);
+
+    for (std::size_t i = 0, count = vertices.size(); i < count; i += floatsPerVertex)
+    {
+        vertices[i] = vertices[i] * scaleX - 1.f;
+        vertices[i + 1] = vertices[i + 1] * scaleY + 1.f;
+    }
+
+    const GLfloat color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glUniform4fv(gl3context.color, 1, color);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glUniform1i(gl3context.usingTexture, 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, gl3context.buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * vertices.size(), vertices.data(), GL_STREAM_DRAW);
+    glEnableVertexAttribArray(gl3context.bounds);
+    glEnableVertexAttribArray(gl3context.textureMap);
+    glVertexAttribPointer(gl3context.bounds, 2, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * floatsPerVertex, nullptr);
+    glVertexAttribPointer(gl3context.textureMap, 2, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * floatsPerVertex,
+                          reinterpret_cast<void*>(sizeof(GLfloat) * 2));
+
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size() / floatsPerVertex));
+
+    glDisableVertexAttribArray(gl3context.textureMap);
+    glDisableVertexAttribArray(gl3context.bounds);
+    glUniform1i(gl3context.usingTexture, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    vertices.clear();
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // ImageBaseAboutWindow
 
@@ -831,6 +888,69 @@ template class ImageBaseSlider<OpenGLImage>;
 
 template class ImageBaseSwitch<OpenGLImage>;
 
+// --------------------------------------------------------------------------------------------------------------------
+// SubWidget cached drawing
+
+void SubWidget::PrivateData::drawCache()
+{
+    const OpenGL3GraphicsContext& gl3context = static_cast<const OpenGL3GraphicsContext&>(self->getGraphicsContext());
+
+    if (gl3context.program == 0)
+        return;
+
+    // cached contents use premultiplied alpha
+    GLboolean blendEnabled;
+    GLint blendSrc, blendDst;
+    glGetBooleanv(GL_BLEND, &blendEnabled);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSrc);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDst);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    // the widget drawing might have used a different program
+    glUseProgram(gl3context.program);
+
+    glViewport(cache.area.getX(), cache.area.getY(), cache.area.getWidth(), cache.area.getHeight());
+
+    const GLfloat color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glUniform4fv(gl3context.color, 1, color);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, cache.texture);
+    glUniform1i(gl3context.usingTexture, 1);
+
+    // framebuffer textures start at the bottom
+    static constexpr const GLfloat vertices[] = {
+        -1.f, 1.f, -1.f, -1.f, 1.f, -1.f, 1.f, 1.f,
+        0.f, 1.f, 0.f, 0.f, 1.f, 0.f, 1.f, 1.f,
+    };
+    glBindBuffer(GL_ARRAY_BUFFER, gl3context.buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(gl3context.bounds);
+    glEnableVertexAttribArray(gl3context.textureMap);
+    glVertexAttribPointer(gl3context.bounds, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glVertexAttribPointer(gl3context.textureMap, 2, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<void*>(sizeof(GLfloat) * 8));
+
+    static constexpr const GLubyte order[] = { 0, 1, 2, 0, 2, 3 };
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gl3context.buffers[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(order), order, GL_STATIC_DRAW);
+
+    glDrawElements(GL_TRIANGLES, ARRAY_SIZE(order), GL_UNSIGNED_BYTE, nullptr);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glDisableVertexAttribArray(gl3context.textureMap);
+    glDisableVertexAttribArray(gl3context.bounds);
+    glUniform1i(gl3context.usingTexture, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (! blendEnabled)
+        glDisable(GL_BLEND);
+
+    glBlendFunc(blendSrc, blendDst);
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 
 static void shaderCreationFail(const GLuint shaderErr, const GLuint shader2 = 0)
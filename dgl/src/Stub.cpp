@@ -200,7 +200,22 @@ template class Rectangle<ushort>;
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void SubWidget::PrivateData::display(uint, uint, double)
+bool SubWidget::PrivateData::updateCache(const Rectangle<int>&)
+{
+    return false;
+}
+
+void SubWidget::PrivateData::drawCache()
+{
+}
+
+void SubWidget::PrivateData::destroyCache()
+{
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void SubWidget::PrivateData::display(uint, uint, double, const Rectangle<int>&)
 {
 }
 
@@ -212,6 +227,13 @@ void TopLevelWidget::PrivateData::display()
 
 // --------------------------------------------------------------------------------------------------------------------
 
+bool Window::PrivateData::canRedrawPartially() const
+{
+    return false;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
 void Window::PrivateData::renderToPicture(const char*, const GraphicsContext&, uint, uint)
 {
     notImplemented("Window::PrivateData::renderToPicture");
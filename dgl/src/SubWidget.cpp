@@ -133,6 +133,17 @@ Widget* SubWidget::getParentWidget() const noexcept
 
 void SubWidget::repaint() noexcept
 {
+    // widgets reusing their parent context are drawn by it, so its cached drawing needs updating too
+    for (SubWidget* widget = this; widget != nullptr;)
+    {
+        widget->pData->cache.needsUpdate = true;
+
+        if (! widget->pData->skipDrawing)
+            break;
+
+        widget = dynamic_cast<SubWidget*>(widget->pData->parentWidget);
+    }
+
     if (! isVisible())
         return;
 
@@ -178,6 +189,15 @@ void SubWidget::setSkipDrawing(const bool skipDrawing)
     pData->skipDrawing = skipDrawing;
 }
 
+void SubWidget::setCachedDrawing(const bool cachedDrawing)
+{
+    pData->cachedDrawing = cachedDrawing;
+    pData->cache.needsUpdate = true;
+
+    if (! cachedDrawing)
+        pData->destroyCache();
+}
+
 void SubWidget::onPositionChanged(const PositionChangedEvent&)
 {
 }
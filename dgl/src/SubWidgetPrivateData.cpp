@@ -30,13 +30,16 @@ SubWidget::PrivateData::PrivateData(SubWidget* const s, Widget* const pw)
       needsFullViewportForDrawing(false),
       needsViewportScaling(false),
       skipDrawing(false),
-      viewportScaleFactor(0.0)
+      cachedDrawing(false),
+      viewportScaleFactor(0.0),
+      cache()
 {
     parentWidget->pData->subWidgets.push_back(self);
 }
 
 SubWidget::PrivateData::~PrivateData()
 {
+    destroyCache();
     parentWidget->pData->subWidgets.remove(self);
 }
 
@@ -32,13 +32,38 @@ struct SubWidget::PrivateData {
     bool needsFullViewportForDrawing; // needed for widgets drawing out of bounds
     bool needsViewportScaling; // needed for NanoVG
     bool skipDrawing; // for context reuse in NanoVG based guis
+    bool cachedDrawing; // reuse the last drawing until a repaint is requested
     double viewportScaleFactor; // auto-scaling for NanoVG
 
+    // last drawing of the widget, used if cachedDrawing is enabled
+    struct Cache {
+        bool needsUpdate;
+        Rectangle<int> area; // area of the window covered by the cache, in pixels
+        void* pattern;       // Cairo only
+        uint framebuffer;    // OpenGL only
+        uint renderbuffer;   // OpenGL only
+        uint texture;        // OpenGL only
+
+        Cache() noexcept
+            : needsUpdate(true),
+              area(),
+              pattern(nullptr),
+              framebuffer(0),
+              renderbuffer(0),
+              texture(0) {}
+    } cache;
+
     explicit PrivateData(SubWidget* const s, Widget* const pw);
     ~PrivateData();
 
     // NOTE display function is different depending on build type, must call displaySubWidgets at the end
-    void display(uint width, uint height, double autoScaleFactor);
+    void display(uint width, uint height, double autoScaleFactor, const Rectangle<int>& exposeArea);
+
+    // NOTE cache functions are different depending on build type
+    // updateCache draws the widget into the cache, returning false if not possible
+    bool updateCache(const Rectangle<int>& area);
+    void drawCache();
+    void destroyCache();
 
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PrivateData)
 };
@@ -235,11 +235,28 @@ VulkanImage& VulkanImage::operator=(const VulkanImage& image) noexcept
 
 // -----------------------------------------------------------------------
 
-void SubWidget::PrivateData::display(const uint width, const uint height, const double autoScaleFactor)
+bool SubWidget::PrivateData::updateCache(const Rectangle<int>&)
+{
+    // the Vulkan backend has no widget cache, cached subwidgets are drawn directly
+    return false;
+}
+
+void SubWidget::PrivateData::drawCache()
+{
+}
+
+void SubWidget::PrivateData::destroyCache()
+{
+}
+
+// -----------------------------------------------------------------------
+
+void SubWidget::PrivateData::display(const uint width, const uint height, const double autoScaleFactor,
+                                     const Rectangle<int>& exposeArea)
 {
     // TODO
 
-    selfw->pData->displaySubWidgets(width, height, autoScaleFactor);
+    selfw->pData->displaySubWidgets(width, height, autoScaleFactor, exposeArea);
 }
 
 // -----------------------------------------------------------------------
@@ -261,7 +278,15 @@ void TopLevelWidget::PrivateData::display()
     self->onDisplay();
 
     // now draw subwidgets if there are any
-    selfw->pData->displaySubWidgets(width, height, autoScaleFactor);
+    selfw->pData->displaySubWidgets(width, height, autoScaleFactor, window.pData->exposeArea);
+}
+
+// -----------------------------------------------------------------------
+
+bool Window::PrivateData::canRedrawPartially() const
+{
+    // the Vulkan backend has no partial redraw, the whole window is always drawn
+    return false;
 }
 
 // -----------------------------------------------------------------------
@@ -56,7 +56,22 @@ Widget::PrivateData::~PrivateData()
     std::free(name);
 }
 
-void Widget::PrivateData::displaySubWidgets(const uint width, const uint height, const double autoScaleFactor)
+static bool isSubWidgetExposed(const SubWidget* const widget, const double autoScaleFactor,
+                               const Rectangle<int>& exposeArea)
+{
+    const double x = widget->getAbsoluteX() * autoScaleFactor;
+    const double y = widget->getAbsoluteY() * autoScaleFactor;
+    const int x1 = static_cast<int>(std::floor(x));
+    const int y1 = static_cast<int>(std::floor(y));
+    const int x2 = static_cast<int>(std::ceil(x + widget->getWidth() * autoScaleFactor));
+    const int y2 = static_cast<int>(std::ceil(y + widget->getHeight() * autoScaleFactor));
+
+    return x1 < exposeArea.getX() + exposeArea.getWidth() && x2 > exposeArea.getX() &&
+           y1 < exposeArea.getY() + exposeArea.getHeight() && y2 > exposeArea.getY();
+}
+
+void Widget::PrivateData::displaySubWidgets(const uint width, const uint height, const double autoScaleFactor,
+                                            const Rectangle<int>& exposeArea)
 {
     if (subWidgets.size() == 0)
         return;
@@ -65,8 +80,15 @@ void Widget::PrivateData::displaySubWidgets(const uint width, const uint height,
     {
         SubWidget* const subwidget(*it);
 
-        if (subwidget->isVisible())
-            subwidget->pData->display(width, height, autoScaleFactor);
+        if (! subwidget->isVisible())
+            continue;
+
+        // widgets that draw out of bounds are always displayed
+        if (subwidget->pData->needsFullViewportForDrawing || isSubWidgetExposed(subwidget, autoScaleFactor, exposeArea))
+            subwidget->pData->display(width, height, autoScaleFactor, exposeArea);
+        // nothing to redraw for this widget, but its children are not necessarily contained within it
+        else
+            subwidget->pData->selfw->pData->displaySubWidgets(width, height, autoScaleFactor, exposeArea);
     }
 }
 
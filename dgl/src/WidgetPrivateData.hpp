@@ -42,7 +42,7 @@ struct Widget::PrivateData {
     explicit PrivateData(Widget* const s, Widget* const pw);
     ~PrivateData();
 
-    void displaySubWidgets(uint width, uint height, double autoScaleFactor);
+    void displaySubWidgets(uint width, uint height, double autoScaleFactor, const Rectangle<int>& exposeArea);
 
     bool giveKeyboardEventForSubWidgets(const KeyboardEvent& ev);
     bool giveCharacterInputEventForSubWidgets(const CharacterInputEvent& ev);
@@ -448,7 +448,7 @@ void Window::repaint() noexcept
     if (pData->usesScheduledRepaints)
         pData->appData->needsRepaint = true;
 
-    puglObscureView(pData->view);
+    pData->requestRepaint(Rectangle<int>());
 }
 
 void Window::repaint(const Rectangle<uint>& rect) noexcept
@@ -474,7 +474,20 @@ void Window::repaint(const Rectangle<uint>& rect) noexcept
         height = d_roundToUnsignedInt(height * autoScaleFactor);
     }
 
-    puglObscureRegion(pData->view, x, y, width, height);
+    if (width == 0 || height == 0)
+        return;
+
+    pData->requestRepaint(Rectangle<int>(x, y, static_cast<int>(width), static_cast<int>(height)));
+}
+
+Window::FrameStatistics Window::getFrameStatistics() const noexcept
+{
+    return pData->frameStatistics;
+}
+
+void Window::resetFrameStatistics() noexcept
+{
+    pData->frameStatistics = FrameStatistics();
 }
 
 void Window::renderToPicture(const char* const filename)
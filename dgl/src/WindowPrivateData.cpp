@@ -126,6 +126,11 @@ Window::PrivateData::PrivateData(Application& a, Window* const s)
       waitingForClipboardEvents(false),
       clipboardTypeId(0),
       filenameToRenderInto(nullptr),
+      exposeArea(),
+      lastFrameStartTime(0.0),
+      hasDeferredRepaint(false),
+      deferredRepaintArea(),
+      frameStatistics(),
      #ifdef DGL_USE_FILE_BROWSER
       fileBrowserHandle(nullptr),
      #endif
@@ -159,6 +164,11 @@ Window::PrivateData::PrivateData(Application& a, Window* const s, PrivateData* c
       waitingForClipboardEvents(false),
       clipboardTypeId(0),
       filenameToRenderInto(nullptr),
+      exposeArea(),
+      lastFrameStartTime(0.0),
+      hasDeferredRepaint(false),
+      deferredRepaintArea(),
+      frameStatistics(),
      #ifdef DGL_USE_FILE_BROWSER
       fileBrowserHandle(nullptr),
      #endif
@@ -194,6 +204,11 @@ Window::PrivateData::PrivateData(Application& a, Window* const s,
       waitingForClipboardEvents(false),
       clipboardTypeId(0),
       filenameToRenderInto(nullptr),
+      exposeArea(),
+      lastFrameStartTime(0.0),
+      hasDeferredRepaint(false),
+      deferredRepaintArea(),
+      frameStatistics(),
      #ifdef DGL_USE_FILE_BROWSER
       fileBrowserHandle(nullptr),
      #endif
@@ -232,6 +247,11 @@ Window::PrivateData::PrivateData(Application& a, Window* const s,
       waitingForClipboardEvents(false),
       clipboardTypeId(0),
       filenameToRenderInto(nullptr),
+      exposeArea(),
+      lastFrameStartTime(0.0),
+      hasDeferredRepaint(false),
+      deferredRepaintArea(),
+      frameStatistics(),
      #ifdef DGL_USE_FILE_BROWSER
       fileBrowserHandle(nullptr),
      #endif
@@ -299,6 +319,10 @@ void Window::PrivateData::initPre(const uint width, const uint height, const boo
     puglSetViewHint(view, PUGL_DEPTH_BITS, 16);
    #endif
     puglSetViewHint(view, PUGL_STENCIL_BITS, 8);
+   #if defined(DGL_USE_SINGLE_BUFFER) && DGL_USE_SINGLE_BUFFER
+    // allows partial redraws, see canRedrawPartially()
+    puglSetViewHint(view, PUGL_DOUBLE_BUFFER, PUGL_FALSE);
+   #endif
 
     // PUGL_SAMPLES ??
     puglSetEventFunc(view, puglEventCallback);
@@ -637,6 +661,91 @@ void Window::PrivateData::runAsModal(const bool blockWait)
     }
 }
 
+// -----------------------------------------------------------------------
+// frame pacing
+
+double Window::PrivateData::getFrameInterval() const
+{
+    uint frameRate = appData->maxFrameRate;
+
+    if (frameRate == 0)
+    {
+        const int refreshRate = view != nullptr ? puglGetViewHint(view, PUGL_REFRESH_RATE) : 0;
+        frameRate = refreshRate > 0 ? static_cast<uint>(refreshRate) : 60;
+    }
+
+    return 1.0 / frameRate;
+}
+
+void Window::PrivateData::requestRepaint(const Rectangle<int>& area)
+{
+    // hosts that schedule repaints already pace them
+    if (! usesScheduledRepaints)
+    {
+        if (hasDeferredRepaint)
+        {
+            // merge with the pending area, an invalid area means the full window
+            if (deferredRepaintArea.isValid() && area.isValid())
+            {
+                const int x1 = std::min(deferredRepaintArea.getX(), area.getX());
+                const int y1 = std::min(deferredRepaintArea.getY(), area.getY());
+                const int x2 = std::max(deferredRepaintArea.getX() + deferredRepaintArea.getWidth(),
+                                        area.getX() + area.getWidth());
+                const int y2 = std::max(deferredRepaintArea.getY() + deferredRepaintArea.getHeight(),
+                                        area.getY() + area.getHeight());
+                deferredRepaintArea = Rectangle<int>(x1, y1, x2 - x1, y2 - y1);
+            }
+            else
+            {
+                deferredRepaintArea = Rectangle<int>();
+            }
+
+            ++frameStatistics.coalescedRepaints;
+            return;
+        }
+
+        if (appData->getTime() - lastFrameStartTime < getFrameInterval())
+        {
+            hasDeferredRepaint = true;
+            deferredRepaintArea = area;
+            ++frameStatistics.coalescedRepaints;
+            return;
+        }
+    }
+
+    if (area.isValid())
+        puglObscureRegion(view, area.getX(), area.getY(), area.getWidth(), area.getHeight());
+    else
+        puglObscureView(view);
+}
+
+double Window::PrivateData::flushDeferredRepaint(const double time)
+{
+    if (! hasDeferredRepaint)
+        return 0.0;
+
+    const double remaining = lastFrameStartTime + getFrameInterval() - time;
+
+    if (remaining > 0.0)
+        return remaining;
+
+    hasDeferredRepaint = false;
+
+    if (view == nullptr)
+        return 0.0;
+
+    if (deferredRepaintArea.isValid())
+        puglObscureRegion(view,
+                          deferredRepaintArea.getX(),
+                          deferredRepaintArea.getY(),
+                          deferredRepaintArea.getWidth(),
+                          deferredRepaintArea.getHeight());
+    else
+        puglObscureView(view);
+
+    return 0.0;
+}
+
 // -----------------------------------------------------------------------
 // pugl events
 
@@ -695,11 +804,37 @@ void Window::PrivateData::onPuglConfigure(const uint width, const uint height)
     puglObscureView(view);
 }
 
-void Window::PrivateData::onPuglExpose()
+void Window::PrivateData::onPuglExpose(const int x, const int y, const int width, const int height)
 {
     // DGL_DBG("PUGL: onPuglExpose\n");
 
-    puglOnDisplayPrepare(view);
+    const double frameStartTime = appData->getTime();
+
+    const PuglArea size = puglGetSizeHint(view, PUGL_CURRENT_SIZE);
+    const int viewWidth = static_cast<int>(size.width);
+    const int viewHeight = static_cast<int>(size.height);
+
+    // only redraw the damaged area if possible, rendering into a picture always needs the full contents
+   #ifndef DPF_TEST_WINDOW_CPP
+    const bool partialRedraw = filenameToRenderInto == nullptr && canRedrawPartially();
+   #else
+    const bool partialRedraw = false;
+   #endif
+
+    if (partialRedraw)
+    {
+        const int x1 = std::max(0, std::min(x, viewWidth));
+        const int y1 = std::max(0, std::min(y, viewHeight));
+        const int x2 = std::max(x1, std::min(x + width, viewWidth));
+        const int y2 = std::max(y1, std::min(y + height, viewHeight));
+        exposeArea = Rectangle<int>(x1, y1, x2 - x1, y2 - y1);
+    }
+    else
+    {
+        exposeArea = Rectangle<int>(0, 0, viewWidth, viewHeight);
+    }
+
+    puglOnDisplayPrepare(view, exposeArea.getX(), exposeArea.getY(), exposeArea.getWidth(), exposeArea.getHeight());
 
 #ifndef DPF_TEST_WINDOW_CPP
     startContext();
@@ -714,7 +849,6 @@ void Window::PrivateData::onPuglExpose()
 
     if (char* const filename = filenameToRenderInto)
     {
-        const PuglArea size = puglGetSizeHint(view, PUGL_CURRENT_SIZE);
         filenameToRenderInto = nullptr;
         renderToPicture(filename, getGraphicsContext(), size.width, size.height);
         std::free(filename);
@@ -722,6 +856,28 @@ void Window::PrivateData::onPuglExpose()
 
     endContext();
 #endif
+
+    // a full redraw covers any deferred repaint too
+    if (! partialRedraw)
+        hasDeferredRepaint = false;
+
+    const double frameTime = appData->getTime() - frameStartTime;
+    const uint32_t frameCount = ++frameStatistics.frameCount;
+
+    frameStatistics.lastFrameTime = frameTime;
+    frameStatistics.averageFrameTime += (frameTime - frameStatistics.averageFrameTime) / frameCount;
+
+    if (frameTime > frameStatistics.maxFrameTime)
+        frameStatistics.maxFrameTime = frameTime;
+
+    if (frameCount > 1)
+    {
+        const double frameInterval = frameStartTime - lastFrameStartTime;
+        frameStatistics.averageFrameInterval += (frameInterval - frameStatistics.averageFrameInterval)
+                                              / (frameCount - 1);
+    }
+
+    lastFrameStartTime = frameStartTime;
 }
 
 void Window::PrivateData::onPuglClose()
@@ -1013,8 +1169,10 @@ PuglStatus Window::PrivateData::puglEventCallback(PuglView* const view, const Pu
 
     ///< View must be drawn, a #PuglExposeEvent
     case PUGL_EXPOSE:
-        // unused x, y, width, height (double)
-        pData->onPuglExpose();
+        pData->onPuglExpose(static_cast<int>(event->expose.x),
+                            static_cast<int>(event->expose.y),
+                            static_cast<int>(event->expose.width),
+                            static_cast<int>(event->expose.height));
         break;
 
     ///< View will be closed, a #PuglCloseEvent
@@ -94,6 +94,19 @@ struct Window::PrivateData : IdleCallback {
     /** Render to a picture file when non-null, automatically free+unset after saving. */
     char* filenameToRenderInto;
 
+    /** Area of the window being redrawn during an expose event, in pixels.
+        Covers the full window unless the graphics backend can keep the contents outside of it. */
+    Rectangle<int> exposeArea;
+
+    /** Frame pacing, repaints requested before the next frame is due are merged and deferred until it is.
+        The deferred area is in pixels, an invalid area means the full window. */
+    double lastFrameStartTime;
+    bool hasDeferredRepaint;
+    Rectangle<int> deferredRepaintArea;
+
+    /** Frame timing statistics, updated on every expose event. */
+    Window::FrameStatistics frameStatistics;
+
    #ifdef DGL_USE_FILE_BROWSER
     /** Handle for file browser dialog operations. */
     DGL_NAMESPACE::FileBrowserHandle fileBrowserHandle;
@@ -190,6 +203,14 @@ struct Window::PrivateData : IdleCallback {
 
     static void renderToPicture(const char* filename, const GraphicsContext& context, uint width, uint height);
 
+    // whether the current graphics context keeps its contents between exposes, allowing partial redraws
+    bool canRedrawPartially() const;
+
+    // frame pacing, see Application::setMaxFrameRate
+    double getFrameInterval() const;
+    void requestRepaint(const Rectangle<int>& area);
+    double flushDeferredRepaint(double time);
+
     // modal handling
     void startModal();
     void stopModal();
@@ -197,7 +218,7 @@ struct Window::PrivateData : IdleCallback {
 
     // pugl events
     void onPuglConfigure(uint width, uint height);
-    void onPuglExpose();
+    void onPuglExpose(int x, int y, int width, int height);
     void onPuglClose();
     void onPuglFocus(bool focus, CrossingMode mode);
     void onPuglKey(const Widget::KeyboardEvent& ev);
@@ -87,6 +87,12 @@
 #define NVG_MAX_FONTIMAGE_SIZE   2048
 #define NVG_MAX_FONTIMAGES       4
 
+// Glyph runs and text box layouts are cached between frames, for strings up to NVG_TEXT_CACHE_MAX_LENGTH bytes.
+#ifndef NVG_TEXT_CACHE_SIZE
+#define NVG_TEXT_CACHE_SIZE        64
+#endif
+#define NVG_TEXT_CACHE_MAX_LENGTH  256
+
 #define NVG_INIT_COMMANDS_SIZE 256
 #define NVG_INIT_POINTS_SIZE 128
 #define NVG_INIT_PATHS_SIZE 16
@@ -158,11 +164,51 @@ struct NVGpathCache {
 };
 typedef struct NVGpathCache NVGpathCache;
 
+struct NVGtextCacheKey {
+	unsigned int hash;
+	int fontId;
+	float size;
+	float spacing;
+	float blur;
+	float param;		// Fractional part of the text origin for glyph runs, row width for layouts.
+	float param2;
+	int align;
+	int length;
+};
+typedef struct NVGtextCacheKey NVGtextCacheKey;
+
+struct NVGtextCacheRow {	// Same as NVGtextRow, with offsets into the string instead of pointers.
+	int start, end, next;
+	float width, minx, maxx;
+};
+typedef struct NVGtextCacheRow NVGtextCacheRow;
+
+struct NVGtextCacheEntry {
+	NVGtextCacheKey key;
+	int valid;
+	unsigned int lastUsed;
+	char* string;
+	void* items;		// FONSquad for glyph runs, NVGtextCacheRow for layouts.
+	int nitems;
+	int citems;
+	float nextx;		// Glyph runs only.
+};
+typedef struct NVGtextCacheEntry NVGtextCacheEntry;
+
+struct NVGtextCache {
+	NVGtextCacheEntry entries[NVG_TEXT_CACHE_SIZE];
+	unsigned int counter;
+	int generation;		// Incremented on every clear, so entries in use know they became invalid.
+};
+typedef struct NVGtextCache NVGtextCache;
+
 struct NVGfontContext {  // Fontstash context plus font images; shared between shared NanoVG contexts.
 	int refCount;
 	struct FONScontext* fs;
 	int fontImages[NVG_MAX_FONTIMAGES];
 	int fontImageIdx;
+	NVGtextCache* glyphRuns;	// Positioned glyph quads, relative to the integer text origin.
+	NVGtextCache* layouts;		// Text box rows.
 };
 typedef struct NVGfontContext NVGfontContext;
 
@@ -338,6 +384,106 @@ static NVGstate* nvg__getState(NVGcontext* ctx)
 	return &ctx->states[ctx->nstates-1];
 }
 
+static void nvg__clearTextCache(NVGtextCache* cache)
+{
+	int i;
+	if (cache == NULL) return;
+	for (i = 0; i < NVG_TEXT_CACHE_SIZE; i++) {
+		cache->entries[i].valid = 0;
+		cache->entries[i].nitems = 0;
+	}
+	cache->generation++;
+}
+
+static void nvg__deleteTextCache(NVGtextCache* cache)
+{
+	int i;
+	if (cache == NULL) return;
+	for (i = 0; i < NVG_TEXT_CACHE_SIZE; i++) {
+		free(cache->entries[i].string);
+		free(cache->entries[i].items);
+	}
+	free(cache);
+}
+
+static NVGtextCacheKey nvg__textCacheKey(int fontId, float size, float spacing, float blur, int align,
+										 float param, float param2, const char* string, const char* end)
+{
+	NVGtextCacheKey key;
+	const unsigned char* s;
+	unsigned int hash = 2166136261u; // FNV-1a
+	for (s = (const unsigned char*)string; s < (const unsigned char*)end; s++)
+		hash = (hash ^ *s) * 16777619u;
+	memset(&key, 0, sizeof(key));
+	key.hash = hash;
+	key.fontId = fontId;
+	key.size = size;
+	key.spacing = spacing;
+	key.blur = blur;
+	key.param = param;
+	key.param2 = param2;
+	key.align = align;
+	key.length = (int)(end - string);
+	return key;
+}
+
+static NVGtextCacheEntry* nvg__findTextCache(NVGtextCache* cache, const NVGtextCacheKey* key, const char* string)
+{
+	int i;
+	if (cache == NULL) return NULL;
+	for (i = 0; i < NVG_TEXT_CACHE_SIZE; i++) {
+		NVGtextCacheEntry* entry = &cache->entries[i];
+		if (entry->valid && memcmp(&entry->key, key, sizeof(NVGtextCacheKey)) == 0
+			&& memcmp(entry->string, string, key->length) == 0) {
+			entry->lastUsed = ++cache->counter;
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+// Returns the least recently used entry, reset for storing the string of 'key'; must be made valid once filled.
+static NVGtextCacheEntry* nvg__allocTextCache(NVGtextCache** pcache, const NVGtextCacheKey* key, const char* string)
+{
+	NVGtextCache* cache = *pcache;
+	NVGtextCacheEntry* entry;
+	int i;
+	if (cache == NULL) {
+		cache = (NVGtextCache*)malloc(sizeof(NVGtextCache));
+		if (cache == NULL) return NULL;
+		memset(cache, 0, sizeof(NVGtextCache));
+		*pcache = cache;
+	}
+	entry = &cache->entries[0];
+	for (i = 1; i < NVG_TEXT_CACHE_SIZE && entry->valid; i++) {
+		if (!cache->entries[i].valid || cache->entries[i].lastUsed < entry->lastUsed)
+			entry = &cache->entries[i];
+	}
+	if (entry->string == NULL) {
+		entry->string = (char*)malloc(NVG_TEXT_CACHE_MAX_LENGTH);
+		if (entry->string == NULL) return NULL;
+	}
+	memcpy(entry->string, string, key->length);
+	entry->key = *key;
+	entry->valid = 0;
+	entry->lastUsed = ++cache->counter;
+	entry->nitems = 0;
+	entry->nextx = 0;
+	return entry;
+}
+
+static void* nvg__addTextCacheItem(NVGtextCacheEntry* entry, int itemSize)
+{
+	if (entry->nitems+1 > entry->citems) {
+		int citems = nvg__maxi(entry->nitems+1, 16) + entry->citems/2;
+		void* items = realloc(entry->items, itemSize * citems);
+		if (items == NULL) return NULL;
+		entry->items = items;
+		entry->citems = citems;
+	}
+	return (char*)entry->items + itemSize * entry->nitems++;
+}
+
 NVGcontext* nvgCreateInternal(NVGparams* params, NVGcontext* other)  // Share the fonts and images of 'other' if it's non-NULL.
 {
 	FONSparams fontParams;
@@ -356,6 +502,8 @@ NVGcontext* nvgCreateInternal(NVGparams* params, NVGcontext* other)  // Share th
 		for (i = 0; i < NVG_MAX_FONTIMAGES; i++)
 			ctx->fontContext->fontImages[i] = 0;
 		ctx->fontContext->refCount = 1;
+		ctx->fontContext->glyphRuns = NULL;
+		ctx->fontContext->layouts = NULL;
 	}
 
 	ctx->commands = (float*)malloc(sizeof(float)*NVG_INIT_COMMANDS_SIZE);
@@ -428,6 +576,8 @@ void nvgDeleteInternal(NVGcontext* ctx)
 			}
 		}
 
+		nvg__deleteTextCache(ctx->fontContext->glyphRuns);
+		nvg__deleteTextCache(ctx->fontContext->layouts);
 		free(ctx->fontContext);
 	}
 
@@ -447,6 +597,10 @@ void nvgBeginFrame(NVGcontext* ctx, float windowWidth, float windowHeight, float
 	nvgSave(ctx);
 	nvgReset(ctx);
 
+	// Cached glyphs were rasterized for the previous scale
+	if (ctx->devicePxRatio != devicePixelRatio)
+		nvg__clearTextCache(ctx->fontContext->glyphRuns);
+
 	nvg__setDevicePixelRatio(ctx, devicePixelRatio);
 
 	ctx->params.renderViewport(ctx->params.userPtr, windowWidth, windowHeight, devicePixelRatio);
@@ -2428,6 +2582,8 @@ int nvgFindFont(NVGcontext* ctx, const char* name)
 int nvgAddFallbackFontId(NVGcontext* ctx, int baseFont, int fallbackFont)
 {
 	if(baseFont == -1 || fallbackFont == -1) return 0;
+	nvg__clearTextCache(ctx->fontContext->glyphRuns);
+	nvg__clearTextCache(ctx->fontContext->layouts);
 	return fonsAddFallbackFont(ctx->fontContext->fs, baseFont, fallbackFont);
 }
 
@@ -2438,6 +2594,8 @@ int nvgAddFallbackFont(NVGcontext* ctx, const char* baseFont, const char* fallba
 
 void nvgResetFallbackFontsId(NVGcontext* ctx, int baseFont)
 {
+	nvg__clearTextCache(ctx->fontContext->glyphRuns);
+	nvg__clearTextCache(ctx->fontContext->layouts);
 	fonsResetFallbackFont(ctx->fontContext->fs, baseFont);
 }
 
@@ -2541,6 +2699,8 @@ static int nvg__allocTextAtlas(NVGcontext* ctx)
 	}
 	++ctx->fontContext->fontImageIdx;
 	fonsResetAtlas(ctx->fontContext->fs, iw, ih);
+	// Cached glyph runs point into the old atlas
+	nvg__clearTextCache(ctx->fontContext->glyphRuns);
 	return 1;
 }
 
@@ -2571,6 +2731,38 @@ static int nvg__isTransformFlipped(const float *xform)
 	return( det < 0);
 }
 
+static int nvg__addGlyphQuad(NVGvertex* verts, int nverts, int cverts, const float* xform, int isFlipped,
+							 FONSquad q, float invscale)
+{
+	float c[4*2];
+	if(isFlipped) {
+		float tmp;
+
+		tmp = q.y0; q.y0 = q.y1; q.y1 = tmp;
+		tmp = q.t0; q.t0 = q.t1; q.t1 = tmp;
+	}
+	// Transform corners.
+	nvgTransformPoint(&c[0],&c[1], xform, q.x0*invscale, q.y0*invscale);
+	nvgTransformPoint(&c[2],&c[3], xform, q.x1*invscale, q.y0*invscale);
+	nvgTransformPoint(&c[4],&c[5], xform, q.x1*invscale, q.y1*invscale);
+	nvgTransformPoint(&c[6],&c[7], xform, q.x0*invscale, q.y1*invscale);
+	// Create triangles
+	if (nverts+6 <= cverts) {
+#if NVG_FONT_TEXTURE_FLAGS
+		// align font kerning to integer pixel positions
+		for (int i = 0; i < 8; ++i)
+			c[i] = (int)(c[i] + 0.5f);
+#endif
+		nvg__vset(&verts[nverts], c[0], c[1], q.s0, q.t0); nverts++;
+		nvg__vset(&verts[nverts], c[4], c[5], q.s1, q.t1); nverts++;
+		nvg__vset(&verts[nverts], c[2], c[3], q.s1, q.t0); nverts++;
+		nvg__vset(&verts[nverts], c[0], c[1], q.s0, q.t0); nverts++;
+		nvg__vset(&verts[nverts], c[6], c[7], q.s0, q.t1); nverts++;
+		nvg__vset(&verts[nverts], c[4], c[5], q.s1, q.t1); nverts++;
+	}
+	return nverts;
+}
+
 float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char* end)
 {
 	NVGstate* state = nvg__getState(ctx);
@@ -2582,12 +2774,41 @@ float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char*
 	int cverts = 0;
 	int nverts = 0;
 	int isFlipped = nvg__isTransformFlipped(state->xform);
+	// Glyph quads only depend on the fractional part of the origin, so runs are cached relative to its integer part.
+	float ox = floorf(x*scale), oy = floorf(y*scale);
+	NVGtextCacheEntry* run = NULL;
+	int generation = 0;
+	int i;
 
 	if (end == NULL)
 		end = string + strlen(string);
 
 	if (state->fontId == FONS_INVALID) return x;
 
+	if (end - string <= NVG_TEXT_CACHE_MAX_LENGTH) {
+		NVGtextCacheKey key = nvg__textCacheKey(state->fontId, state->fontSize*scale, state->letterSpacing*scale,
+												state->fontBlur*scale, state->textAlign,
+												x*scale - ox, y*scale - oy, string, end);
+		run = nvg__findTextCache(ctx->fontContext->glyphRuns, &key, string);
+		if (run != NULL) {
+			const FONSquad* quads = (const FONSquad*)run->items;
+			cverts = nvg__maxi(1, run->nitems) * 6;
+			verts = nvg__allocTempVerts(ctx, cverts);
+			if (verts == NULL) return x;
+			for (i = 0; i < run->nitems; i++) {
+				q = quads[i];
+				q.x0 += ox; q.x1 += ox;
+				q.y0 += oy; q.y1 += oy;
+				nverts = nvg__addGlyphQuad(verts, nverts, cverts, state->xform, isFlipped, q, invscale);
+			}
+			nvg__renderText(ctx, verts, nverts);
+			return (run->nextx + ox) / scale;
+		}
+		run = nvg__allocTextCache(&ctx->fontContext->glyphRuns, &key, string);
+		if (run != NULL)
+			generation = ctx->fontContext->glyphRuns->generation;
+	}
+
 	fonsSetSize(ctx->fontContext->fs, state->fontSize*scale);
 	fonsSetSpacing(ctx->fontContext->fs, state->letterSpacing*scale);
 	fonsSetBlur(ctx->fontContext->fs, state->fontBlur*scale);
@@ -2601,7 +2822,6 @@ float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char*
 	fonsTextIterInit(ctx->fontContext->fs, &iter, x*scale, y*scale, string, end, FONS_GLYPH_BITMAP_REQUIRED);
 	prevIter = iter;
 	while (fonsTextIterNext(ctx->fontContext->fs, &iter, &q)) {
-		float c[4*2];
 		if (iter.prevGlyphIndex == -1) { // can not retrieve glyph?
 			if (nverts != 0) {
 				nvg__renderText(ctx, verts, nverts);
@@ -2615,31 +2835,23 @@ float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char*
 				break;
 		}
 		prevIter = iter;
-		if(isFlipped) {
-			float tmp;
-
-			tmp = q.y0; q.y0 = q.y1; q.y1 = tmp;
-			tmp = q.t0; q.t0 = q.t1; q.t1 = tmp;
-		}
-		// Transform corners.
-		nvgTransformPoint(&c[0],&c[1], state->xform, q.x0*invscale, q.y0*invscale);
-		nvgTransformPoint(&c[2],&c[3], state->xform, q.x1*invscale, q.y0*invscale);
-		nvgTransformPoint(&c[4],&c[5], state->xform, q.x1*invscale, q.y1*invscale);
-		nvgTransformPoint(&c[6],&c[7], state->xform, q.x0*invscale, q.y1*invscale);
-		// Create triangles
-		if (nverts+6 <= cverts) {
-#if NVG_FONT_TEXTURE_FLAGS
-			// align font kerning to integer pixel positions
-			for (int i = 0; i < 8; ++i)
-				c[i] = (int)(c[i] + 0.5f);
-#endif
-			nvg__vset(&verts[nverts], c[0], c[1], q.s0, q.t0); nverts++;
-			nvg__vset(&verts[nverts], c[4], c[5], q.s1, q.t1); nverts++;
-			nvg__vset(&verts[nverts], c[2], c[3], q.s1, q.t0); nverts++;
-			nvg__vset(&verts[nverts], c[0], c[1], q.s0, q.t0); nverts++;
-			nvg__vset(&verts[nverts], c[6], c[7], q.s0, q.t1); nverts++;
-			nvg__vset(&verts[nverts], c[4], c[5], q.s1, q.t1); nverts++;
+		if (run != NULL) {
+			FONSquad* cq = (FONSquad*)nvg__addTextCacheItem(run, sizeof(FONSquad));
+			if (cq != NULL) {
+				*cq = q;
+				cq->x0 -= ox; cq->x1 -= ox;
+				cq->y0 -= oy; cq->y1 -= oy;
+			} else {
+				run = NULL;
+			}
 		}
+		nverts = nvg__addGlyphQuad(verts, nverts, cverts, state->xform, isFlipped, q, invscale);
+	}
+
+	// Only keep runs which did not switch to a new font atlas half-way
+	if (run != NULL && generation == ctx->fontContext->glyphRuns->generation) {
+		run->nextx = iter.nextx - ox;
+		run->valid = 1;
 	}
 
 	// TODO: add back-end bit to do this just once per frame.
@@ -2650,10 +2862,22 @@ float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char*
 	return iter.nextx / scale;
 }
 
+static void nvg__textBoxRow(NVGcontext* ctx, float x, float y, float breakRowWidth, int haling,
+							const char* start, const char* end, float width)
+{
+	if (haling & NVG_ALIGN_LEFT)
+		nvgText(ctx, x, y, start, end);
+	else if (haling & NVG_ALIGN_CENTER)
+		nvgText(ctx, x + breakRowWidth*0.5f - width*0.5f, y, start, end);
+	else if (haling & NVG_ALIGN_RIGHT)
+		nvgText(ctx, x + breakRowWidth - width, y, start, end);
+}
+
 void nvgTextBox(NVGcontext* ctx, float x, float y, float breakRowWidth, const char* string, const char* end)
 {
 	NVGstate* state = nvg__getState(ctx);
 	NVGtextRow rows[2];
+	NVGtextCacheEntry* layout = NULL;
 	int nrows = 0, i;
 	int oldAlign = state->textAlign;
 	int haling = state->textAlign & (NVG_ALIGN_LEFT | NVG_ALIGN_CENTER | NVG_ALIGN_RIGHT);
@@ -2662,22 +2886,61 @@ void nvgTextBox(NVGcontext* ctx, float x, float y, float breakRowWidth, const ch
 
 	if (state->fontId == FONS_INVALID) return;
 
+	if (end == NULL)
+		end = string + strlen(string);
+
 	nvgTextMetrics(ctx, NULL, NULL, &lineh);
 
 	state->textAlign = NVG_ALIGN_LEFT | valign;
 
-	while ((nrows = nvgTextBreakLines(ctx, string, end, breakRowWidth, rows, 2))) {
-		for (i = 0; i < nrows; i++) {
-			NVGtextRow* row = &rows[i];
-			if (haling & NVG_ALIGN_LEFT)
-				nvgText(ctx, x, y, row->start, row->end);
-			else if (haling & NVG_ALIGN_CENTER)
-				nvgText(ctx, x + breakRowWidth*0.5f - row->width*0.5f, y, row->start, row->end);
-			else if (haling & NVG_ALIGN_RIGHT)
-				nvgText(ctx, x + breakRowWidth - row->width, y, row->start, row->end);
+	// Reuse the row layout from previous frames if possible
+	if (end - string <= NVG_TEXT_CACHE_MAX_LENGTH) {
+		float scale = nvg__getFontScale(state) * ctx->devicePxRatio;
+		NVGtextCacheKey key = nvg__textCacheKey(state->fontId, state->fontSize*scale, state->letterSpacing*scale,
+												state->fontBlur*scale, state->textAlign,
+												breakRowWidth*scale, scale, string, end);
+		layout = nvg__findTextCache(ctx->fontContext->layouts, &key, string);
+		if (layout == NULL) {
+			layout = nvg__allocTextCache(&ctx->fontContext->layouts, &key, string);
+			if (layout != NULL) {
+				const char* start = string;
+				while (layout != NULL && (nrows = nvgTextBreakLines(ctx, start, end, breakRowWidth, rows, 2))) {
+					for (i = 0; i < nrows; i++) {
+						NVGtextCacheRow* row = (NVGtextCacheRow*)nvg__addTextCacheItem(layout, sizeof(NVGtextCacheRow));
+						if (row == NULL) {
+							layout = NULL;
+							break;
+						}
+						row->start = (int)(rows[i].start - string);
+						row->end = (int)(rows[i].end - string);
+						row->next = (int)(rows[i].next - string);
+						row->width = rows[i].width;
+						row->minx = rows[i].minx;
+						row->maxx = rows[i].maxx;
+					}
+					start = rows[nrows-1].next;
+				}
+				if (layout != NULL)
+					layout->valid = 1;
+			}
+		}
+	}
+
+	if (layout != NULL) {
+		const NVGtextCacheRow* crows = (const NVGtextCacheRow*)layout->items;
+		for (i = 0; i < layout->nitems; i++) {
+			nvg__textBoxRow(ctx, x, y, breakRowWidth, haling, string + crows[i].start, string + crows[i].end, crows[i].width);
 			y += lineh * state->lineHeight;
 		}
-		string = rows[nrows-1].next;
+	} else {
+		while ((nrows = nvgTextBreakLines(ctx, string, end, breakRowWidth, rows, 2))) {
+			for (i = 0; i < nrows; i++) {
+				NVGtextRow* row = &rows[i];
+				nvg__textBoxRow(ctx, x, y, breakRowWidth, haling, row->start, row->end, row->width);
+				y += lineh * state->lineHeight;
+			}
+			string = rows[nrows-1].next;
+		}
 	}
 
 	state->textAlign = oldAlign;
@@ -425,13 +425,35 @@ PuglStatus puglSetSizeAndDefault(PuglView* const view, const uint width, const u
 // --------------------------------------------------------------------------------------------------------------------
 // DGL specific, build-specific drawing prepare
 
-void puglOnDisplayPrepare(PuglView*)
+void puglOnDisplayPrepare(PuglView* const view, const int x, const int y, const int width, const int height)
 {
   #ifdef DGL_OPENGL
+    const PuglArea size = puglGetSizeHint(view, PUGL_CURRENT_SIZE);
+    const bool partialRedraw = x != 0 || y != 0
+                            || width != static_cast<int>(size.width) || height != static_cast<int>(size.height);
+
+    // keep contents outside of the area being redrawn
+    if (partialRedraw)
+    {
+        glScissor(x, static_cast<int>(size.height) - y - height, width, height);
+        glEnable(GL_SCISSOR_TEST);
+    }
+
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    if (partialRedraw)
+        glDisable(GL_SCISSOR_TEST);
+
    #ifndef DGL_USE_OPENGL3
     glLoadIdentity();
    #endif
+  #else
+    // unused
+    (void)view;
+    (void)x;
+    (void)y;
+    (void)width;
+    (void)height;
   #endif
 }
 
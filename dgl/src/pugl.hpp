@@ -81,8 +81,8 @@ void puglSetResizable(PuglView* view, bool resizable);
 // set window size while also changing default
 PuglStatus puglSetSizeAndDefault(PuglView* view, uint width, uint height);
 
-// DGL specific, build-specific drawing prepare
-void puglOnDisplayPrepare(PuglView* view);
+// DGL specific, build-specific drawing prepare, for the area being redrawn
+void puglOnDisplayPrepare(PuglView* view, int x, int y, int width, int height);
 
 // DGL specific, build-specific fallback resize
 void puglFallbackOnResize(PuglView* view, uint width, uint height);
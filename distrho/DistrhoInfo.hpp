@@ -512,6 +512,13 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_HAS_UI 1
 
+/**
+   Whether the plugin provides a lightweight metadata-only instance, see createPluginMetadata().@n
+   When enabled, plugin wrappers use such instance for host scans instead of creating a full plugin,
+   so that plugins with expensive constructors can be scanned quickly.
+ */
+#define DISTRHO_PLUGIN_HAS_METADATA 1
+
 /**
    Whether the plugin processing is realtime-safe.@n
    TODO - list rtsafe requirements
@@ -547,6 +554,24 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_WANT_DIRECT_ACCESS 0
 
+/**
+   Whether the plugin supports double precision (64-bit) audio processing.@n
+   When enabled the plugin advertises 64-bit processing support to the host,
+   which then might call the double precision variant of Plugin::run() instead of the regular one.@n
+   The plugin does not claim to prefer 64-bit processing, so the choice is left to the host.@n
+   Implementing the double precision run() is optional, by default audio is converted to single precision.@n
+   Currently only supported in CLAP and VST3 formats.
+ */
+#define DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION 1
+
+/**
+   Whether the plugin wants to know about offline rendering in LV2 hosts.@n
+   LV2 signals this through a dedicated freewheeling control port, which is only added when this macro is enabled.@n
+   Other formats provide this information regardless of this macro.
+   @see Plugin::isOffline()
+ */
+#define DISTRHO_PLUGIN_WANT_FREEWHEELING 1
+
 /**
    Whether the plugin introduces latency during audio or midi processing.
    @see Plugin::setLatency(uint32_t)
@@ -565,6 +590,14 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_WANT_MIDI_INPUT 1
 
+/**
+   The minimum number of MIDI input events the plugin can receive per audio block.@n
+   Wrappers preallocate space for this many events, or one per frame if the buffer size is bigger.
+   Events received beyond that are dropped.@n
+   Default is 512.
+ */
+#define DISTRHO_PLUGIN_MAX_MIDI_EVENTS 512
+
 /**
    Whether the plugin wants MIDI output.
    @see Plugin::writeMidiEvent(const MidiEvent&)
@@ -579,6 +612,14 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST 1
 
+/**
+   Whether the plugin wants to split its processing into tasks that run in parallel.@n
+   CLAP hosts with the thread-pool extension run these tasks in their own audio worker threads,
+   for other hosts and formats the plugin starts its own pool of threads while active.
+   @see Plugin::requestParallelExecution(uint32_t, ParallelTaskFunc, void*)
+ */
+#define DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION 1
+
 /**
    Whether the plugin provides its own internal programs.
    @see Plugin::initProgramName(uint32_t, String&)
@@ -586,6 +627,16 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_WANT_PROGRAMS 1
 
+/**
+   Whether the plugin wants sample-accurate parameter changes.@n
+   When enabled, the plugin wrapper splits each host audio block at the offsets of incoming parameter changes,
+   calling Plugin::run() once per sub-block with the audio buffers and MIDI event frames adjusted accordingly.
+   This way parameter changes are applied exactly at the frame the host requested, instead of at the start of the block.
+   Currently only supported in CLAP and VST3 formats, others behave as if this macro was disabled.
+   @note Plugin::run() can be called with very small frame counts when this is enabled.
+ */
+#define DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS 1
+
 /**
    Whether the plugin uses internal non-parameter data.
    @see Plugin::initState(uint32_t, String&, String&)
@@ -603,6 +654,15 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_WANT_FULL_STATE 1
 
+/**
+   Whether the plugin wants its state saved in a compact binary format, instead of the default text format.@n
+   The binary format stores parameter values as raw floats and state values with their size,
+   so saving and loading large states is much faster.@n
+   States saved in the text format can still be loaded, but older plugin builds cannot load binary states.
+   @note Only CLAP and VST3 formats implement this at the moment
+ */
+#define DISTRHO_PLUGIN_WANT_BINARY_STATE 1
+
 /**
    Whether the plugin wants time position information from the host.
    @see Plugin::getTimePosition()
@@ -685,6 +745,18 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_UI_WEB_VIEW 1
 
+/**
+   Maximum rate, in Hz, at which parameter changes are sent between the plugin and a web view %UI.@n
+   Changes are coalesced per parameter and sent in a single batch, in both directions.@n
+   On the web side, a `parametersChanged(indexes, values)` function receives each batch as typed arrays if defined,
+   otherwise `parameterChanged(index, value)` is called once per parameter.@n
+   Setting this to 0 sends batches on every idle call or JavaScript event loop iteration.@n
+   On Linux/X11, where the web view runs in a separate process, parameter values from the plugin are instead
+   mirrored through shared memory and polled by that process at animation-frame rate.@n
+   By default this is 60.
+ */
+#define DISTRHO_UI_WEB_VIEW_PARAMETER_RATE 60
+
 /**
    The %UI URI when exporting in LV2 format.@n
    By default this is set to @ref DISTRHO_PLUGIN_URI with "#UI" as suffix.
@@ -56,6 +56,9 @@ START_NAMESPACE_DISTRHO
 
    The process function run() changes wherever DISTRHO_PLUGIN_WANT_MIDI_INPUT is enabled or not.@n
    When enabled it provides midi input events.
+
+   DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION activates a double precision variant of run().@n
+   When enabled you can optionally implement it, otherwise audio is converted to single precision.
  */
 class Plugin
 {
@@ -90,6 +93,15 @@ public:
     */
     double getSampleRate() const noexcept;
 
+   /**
+      Check if the host is currently rendering offline, that is, without realtime constraints.@n
+      This is the case during bounces, exports and freewheeling,
+      plugins can use this to switch to higher-quality or more CPU intensive algorithms.
+      @note Not all plugin formats and hosts provide this information, the default is false (realtime).
+      @see processModeChanged(bool)
+    */
+    bool isOffline() const noexcept;
+
    /**
       Get the bundle path where the plugin resides.
       Can return null if the plugin is not available in a bundle (if it is a single binary).
@@ -126,6 +138,17 @@ public:
     const TimePosition& getTimePosition() const noexcept;
 #endif
 
+#if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+   /**
+      Get the number of MIDI input events dropped since the plugin was created.@n
+      Events are dropped when the host sends more of them in a single block than DPF can store,
+      which is DISTRHO_PLUGIN_MAX_MIDI_EVENTS or one event per frame of the buffer size, whichever is higher.@n
+      Can be called from any thread, which makes it useful for diagnostics.
+      @note This function is only available if DISTRHO_PLUGIN_WANT_MIDI_INPUT is enabled.
+    */
+    uint32_t getDroppedMidiEventCount() const noexcept;
+#endif
+
 #if DISTRHO_PLUGIN_WANT_LATENCY
    /**
       Change the plugin audio output latency to @a frames.@n
@@ -144,6 +167,24 @@ public:
     bool writeMidiEvent(const MidiEvent& midiEvent) noexcept;
 #endif
 
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+   /**
+      Function called for each task of requestParallelExecution(), possibly from several threads at once.
+    */
+    typedef void (*ParallelTaskFunc)(void* userData, uint32_t taskIndex);
+
+   /**
+      Call @a func once for each task index from 0 to @a numTasks - 1, spreading the calls across several threads.@n
+      Returns once all tasks are complete.@n
+      In CLAP hosts that support the thread-pool extension the tasks run in the host's own audio worker threads,
+      otherwise a pool of threads owned by the plugin (started during activation) is used.
+      If neither is possible, the tasks run in sequence in the calling thread.
+      This function must only be called during run(), and not from inside a task.
+      @note This function is only available if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION is enabled.
+    */
+    void requestParallelExecution(uint32_t numTasks, ParallelTaskFunc func, void* userData) noexcept;
+#endif
+
 #if DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
    /**
       Check if parameter value change requests will work with the current plugin host.
@@ -334,6 +375,23 @@ protected:
     */
     virtual void setParameterValue(uint32_t index, float value);
 
+   /**
+      Get the current values of several parameters at once.@n
+      The default implementation calls getParameterValue() for each index,
+      reimplement this if your plugin can read many values in a cheaper way (for example under a single lock).@n
+      The host may call this function from any context, including realtime processing.
+    */
+    virtual void getParameterValues(const uint32_t* indexes, float* values, uint32_t count) const;
+
+   /**
+      Change several parameter values at once, typically used for state and program restore.@n
+      The default implementation calls setParameterValue() for each index,
+      reimplement this if your plugin can apply many values in a cheaper way (for example under a single lock).@n
+      The same rules as setParameterValue() apply.
+      @note This function will only be called for parameter inputs.
+    */
+    virtual void setParameterValues(const uint32_t* indexes, const float* values, uint32_t count);
+
 #if DISTRHO_PLUGIN_WANT_PROGRAMS
    /**
       Load a program.@n
@@ -389,6 +447,27 @@ protected:
     virtual void run(const float** inputs, float** outputs, uint32_t frames) = 0;
 #endif
 
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+# if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+   /**
+      Double precision run/process function for plugins with MIDI input.@n
+      Called instead of the single precision variant when the host processes audio in 64-bit.@n
+      The default implementation converts audio to and from single precision and calls the regular run().
+      @note Some parameters might be null if there are no audio inputs/outputs or MIDI events.
+    */
+    virtual void run(const double** inputs, double** outputs, uint32_t frames,
+                     const MidiEvent* midiEvents, uint32_t midiEventCount);
+# else
+   /**
+      Double precision run/process function for plugins without MIDI input.@n
+      Called instead of the single precision variant when the host processes audio in 64-bit.@n
+      The default implementation converts audio to and from single precision and calls the regular run().
+      @note Some parameters might be null if there are no audio inputs or outputs.
+    */
+    virtual void run(const double** inputs, double** outputs, uint32_t frames);
+# endif
+#endif
+
    /* --------------------------------------------------------------------------------------------------------
     * Callbacks (optional) */
 
@@ -408,6 +487,16 @@ protected:
     */
     virtual void sampleRateChanged(double newSampleRate);
 
+   /**
+      Optional callback to inform the plugin about a change between realtime and offline processing.@n
+      This function will only be called when the plugin is deactivated.@n
+      LV2 hosts can switch to freewheeling while the plugin is active,
+      in that case isOffline() changes right away and this callback happens on the next activation.
+      @see isOffline()
+      @see DISTRHO_PLUGIN_WANT_FREEWHEELING
+    */
+    virtual void processModeChanged(bool offline);
+
    /**
       Optional callback to inform the plugin about audio port IO changes.@n
       This function will only be called when the plugin is deactivated.@n
@@ -444,6 +533,20 @@ private:
  */
 extern Plugin* createPlugin();
 
+#if DISTRHO_PLUGIN_HAS_METADATA
+/**
+   Create a metadata-only instance of the Plugin class.@n
+   Used by plugin wrappers during host scans, to fetch plugin information, audio ports, parameters, port groups,
+   programs and states without creating a full plugin instance.@n
+   Such instance is never activated or run, so it can skip all DSP related allocations.
+   It must still report exactly the same information as a regular instance created via createPlugin().@n
+   A typical setup is to have a base Plugin class with only the metadata-related functions,
+   which the full plugin class extends with DSP code.
+   @see DISTRHO_PLUGIN_HAS_METADATA
+ */
+extern Plugin* createPluginMetadata();
+#endif
+
 /** @} */
 
 // -----------------------------------------------------------------------------------------------------------
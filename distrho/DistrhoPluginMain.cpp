@@ -18,6 +18,8 @@
 
 #if defined(DISTRHO_PLUGIN_TARGET_AU)
 # include "src/DistrhoPluginAU.cpp"
+#elif defined(DISTRHO_PLUGIN_TARGET_BENCH)
+# include "src/DistrhoPluginBench.cpp"
 #elif defined(DISTRHO_PLUGIN_TARGET_CARLA)
 # include "src/DistrhoPluginCarla.cpp"
 #elif defined(DISTRHO_PLUGIN_TARGET_CLAP)
@@ -45,7 +47,7 @@ END_NAMESPACE_DISTRHO
 # error unsupported format
 #endif
 
-#if defined(DISTRHO_PLUGIN_TARGET_JACK)
+#if defined(DISTRHO_PLUGIN_TARGET_JACK) || defined(DISTRHO_PLUGIN_TARGET_BENCH)
 # define DISTRHO_IS_STANDALONE 1
 #else
 # define DISTRHO_IS_STANDALONE 0
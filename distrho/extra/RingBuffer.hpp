@@ -19,6 +19,12 @@
 
 #include "../DistrhoUtils.hpp"
 
+#ifdef _MSC_VER
+# include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+# include <immintrin.h>
+#endif
+
 START_NAMESPACE_DISTRHO
 
 // -----------------------------------------------------------------------
@@ -119,6 +125,65 @@ struct HugeStackBuffer {
     uint8_t  buf[size];
 };
 
+/**
+   Amount of padding used by AlignedHeapBuffer to keep its writing and reading sides apart.
+   This is bigger than the usual 64 byte cache line, so that it also covers 128 byte lines
+   and CPUs that prefetch cache lines in pairs.
+ */
+static const uint32_t kRingBufferCacheLinePadding = 128;
+
+/**
+   RingBufferControl compatible struct for heap memory, laid out for a writer and a reader running on different cores.
+   Positions changed by the writing side and by the reading side are placed on separate cache lines,
+   so that one side writing never invalidates the cache line the other side is using.
+
+   Each side also keeps a cached copy of the other side's position.
+   The real position is only loaded from the other side's cache line when the cached one does not
+   leave enough data to read or enough space to write.
+   @see HeapBuffer
+ */
+struct AlignedHeapBuffer {
+    uint32_t size;
+    uint8_t* buf;
+    uint8_t  padding1[kRingBufferCacheLinePadding];
+
+    // writing side
+    uint32_t head, wrtn;
+    uint32_t cachedTail;
+    bool     invalidateCommit;
+    uint8_t  padding2[kRingBufferCacheLinePadding];
+
+    // reading side
+    uint32_t tail;
+    uint32_t cachedHead;
+    uint8_t  padding3[kRingBufferCacheLinePadding];
+};
+
+// -----------------------------------------------------------------------
+// Buffer span
+
+/**
+   A view over a region of ring buffer memory, used for reading and writing data in place.
+   Because the region can wrap around the end of the buffer, it is split in up to 2 contiguous parts.
+   When there is no wrap the second part is empty, with @a data2 being null and @a size2 being 0.
+   @see RingBufferControl::reserveWrite(uint32_t, RingBufferSpan&)
+   @see RingBufferControl::peekRead(RingBufferSpan&)
+ */
+struct RingBufferSpan {
+    uint8_t* data1;
+    uint32_t size1;
+    uint8_t* data2;
+    uint32_t size2;
+
+   /**
+      Get the total size of the span, in bytes.
+    */
+    uint32_t getSize() const noexcept
+    {
+        return size1 + size2;
+    }
+};
+
 // -----------------------------------------------------------------------
 // RingBufferControl templated class
 
@@ -128,6 +193,8 @@ struct HugeStackBuffer {
 
    This is meant for single-writer, single-reader type of control.
    Writing and reading is wait and lock-free.
+   The write position is published with release semantics on commitWrite() and loaded with acquire semantics
+   by the reading side, the same happens to the read position in the other direction.
 
    Typically usage involves:
    ```
@@ -153,6 +220,24 @@ struct HugeStackBuffer {
    }
    ```
 
+   Data can also be written and read in place, without going through intermediate copies:
+   ```
+   // writing data
+   RingBufferSpan span;
+   if (myHeapBuffer.reserveWrite(size, span))
+   {
+      // fill span.data1 and span.data2 (if not null)
+      myHeapBuffer.commitWrite();
+   }
+
+   // reading data
+   if (myHeapBuffer.peekRead(span) != 0)
+   {
+      // use data from span.data1 and span.data2 (if not null)
+      myHeapBuffer.consumeRead(span.getSize());
+   }
+   ```
+
    @see HeapBuffer
  */
 template <class BufferStruct>
@@ -179,17 +264,33 @@ public:
 
     /*
      * Check if there is any data available for reading, regardless of size.
+     * Safe to call from both the reading and writing sides.
      */
     bool isDataAvailableForReading() const noexcept;
 
     /*
      * Check if ring buffer is empty (that is, there is nothing to read).
+     * Safe to call from both the reading and writing sides.
      */
     bool isEmpty() const noexcept
     {
         DISTRHO_SAFE_ASSERT_RETURN(buffer != nullptr, false);
 
-        return (buffer->buf == nullptr || buffer->head == buffer->tail);
+        return (buffer->buf == nullptr || loadAcquire(buffer->head) == loadAcquire(buffer->tail));
+    }
+
+    /*
+     * Check if there is enough space for writing @a size bytes, without marking a write as failed.
+     */
+    bool isSpaceAvailableForWriting(const uint32_t size) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(buffer != nullptr, false);
+
+        const uint32_t wrtn = buffer->wrtn;
+        const uint32_t tail = getTailForWriting(wrtn, size);
+        const uint32_t wrap = tail > wrtn ? 0 : buffer->size;
+
+        return size < wrap + tail - wrtn;
     }
 
     /*
@@ -202,14 +303,17 @@ public:
 
     /*
      * Get the size of the data available to read.
+     * Safe to call from both the reading and writing sides.
      */
     uint32_t getReadableDataSize() const noexcept
     {
         DISTRHO_SAFE_ASSERT_RETURN(buffer != nullptr, 0);
 
-        const uint32_t wrap = buffer->head >= buffer->tail ? 0 : buffer->size;
+        const uint32_t tail = loadAcquire(buffer->tail);
+        const uint32_t head = loadAcquire(buffer->head);
+        const uint32_t wrap = head >= tail ? 0 : buffer->size;
 
-        return wrap + buffer->head - buffer->tail;
+        return wrap + head - tail;
     }
 
     /*
@@ -219,9 +323,11 @@ public:
     {
         DISTRHO_SAFE_ASSERT_RETURN(buffer != nullptr, 0);
 
-        const uint32_t wrap = buffer->tail > buffer->wrtn ? 0 : buffer->size;
+        const uint32_t wrtn = buffer->wrtn;
+        const uint32_t tail = getTailForWriting(wrtn, buffer->size);
+        const uint32_t wrap = tail > wrtn ? 0 : buffer->size;
 
-        return wrap + buffer->tail - buffer->wrtn - 1;
+        return wrap + tail - wrtn - 1;
     }
 
     // -------------------------------------------------------------------
@@ -239,6 +345,7 @@ public:
         buffer->tail = 0;
         buffer->wrtn = 0;
         buffer->invalidateCommit = false;
+        resetCachedPositions();
 
         std::memset(buffer->buf, 0, buffer->size);
     }
@@ -253,6 +360,7 @@ public:
 
         buffer->head = buffer->tail = buffer->wrtn = 0;
         buffer->invalidateCommit = false;
+        resetCachedPositions();
 
         errorWriting = false;
     }
@@ -426,6 +534,77 @@ public:
         return false;
     }
 
+    // -------------------------------------------------------------------
+    // zero-copy read operations
+
+    /*
+     * Get all data currently available for reading, as a span pointing to the ring buffer memory.
+     * The read position does not advance, call consumeRead() after processing the data.
+     * Returns the number of bytes available, which can be 0.
+     */
+    uint32_t peekRead(RingBufferSpan& span) const noexcept
+    {
+        std::memset(&span, 0, sizeof(span));
+
+        DISTRHO_SAFE_ASSERT_RETURN(buffer != nullptr, 0);
+       #if defined(__clang__)
+        #pragma clang diagnostic push
+        #pragma clang diagnostic ignored "-Wtautological-pointer-compare"
+       #endif
+        DISTRHO_SAFE_ASSERT_RETURN(buffer->buf != nullptr, 0);
+       #if defined(__clang__)
+        #pragma clang diagnostic pop
+       #endif
+
+        const uint32_t tail = buffer->tail;
+        const uint32_t head = getHeadForReading(tail, buffer->size);
+
+        if (head == tail)
+            return 0;
+
+        span.data1 = buffer->buf + tail;
+
+        if (head > tail)
+        {
+            span.size1 = head - tail;
+        }
+        else
+        {
+            span.size1 = buffer->size - tail;
+
+            if (head != 0)
+            {
+                span.data2 = buffer->buf;
+                span.size2 = head;
+            }
+        }
+
+        return span.getSize();
+    }
+
+    /*
+     * Advance the read position by @a size bytes, typically after a call to peekRead().
+     * Returns false if there is not enough data available.
+     */
+    bool consumeRead(const uint32_t size) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(buffer != nullptr, false);
+        DISTRHO_SAFE_ASSERT_RETURN(size > 0, false);
+
+        const uint32_t tail = buffer->tail;
+        const uint32_t head = getHeadForReading(tail, size);
+        const uint32_t wrap = head >= tail ? 0 : buffer->size;
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(size <= wrap + head - tail, size, wrap + head - tail, false);
+
+        uint32_t readto = tail + size;
+
+        if (readto >= buffer->size)
+            readto -= buffer->size;
+
+        storeRelease(buffer->tail, readto);
+        return true;
+    }
+
     // -------------------------------------------------------------------
     // write operations
 
@@ -531,6 +710,56 @@ public:
         return tryWrite(&type, sizeof(T));
     }
 
+    /*!
+     * Reserve @a size bytes for writing in place, as a span pointing to the ring buffer memory.
+     * The caller must fill the whole span and then call commitWrite(), like with the other write operations.
+     * On failure the pending commit is invalidated, just as if a regular write had failed.
+     */
+    bool reserveWrite(const uint32_t size, RingBufferSpan& span) noexcept
+    {
+        std::memset(&span, 0, sizeof(span));
+
+        DISTRHO_SAFE_ASSERT_RETURN(buffer != nullptr, false);
+        DISTRHO_SAFE_ASSERT_RETURN(size > 0, false);
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(size < buffer->size, size, buffer->size, false);
+
+        const uint32_t wrtn = buffer->wrtn;
+        const uint32_t tail = getTailForWriting(wrtn, size);
+        const uint32_t wrap = tail > wrtn ? 0 : buffer->size;
+
+        if (size >= wrap + tail - wrtn)
+        {
+            if (! errorWriting)
+            {
+                errorWriting = true;
+                d_stderr2("RingBuffer::reserveWrite(%lu): failed, not enough space", (ulong)size);
+            }
+            buffer->invalidateCommit = true;
+            return false;
+        }
+
+        uint32_t writeto = wrtn + size;
+        span.data1 = buffer->buf + wrtn;
+
+        if (writeto > buffer->size)
+        {
+            writeto -= buffer->size;
+            span.size1 = buffer->size - wrtn;
+            span.data2 = buffer->buf;
+            span.size2 = writeto;
+        }
+        else
+        {
+            span.size1 = size;
+
+            if (writeto == buffer->size)
+                writeto = 0;
+        }
+
+        buffer->wrtn = writeto;
+        return true;
+    }
+
     // -------------------------------------------------------------------
 
     /*!
@@ -556,7 +785,7 @@ public:
         }
 
         // all ok
-        buffer->head = buffer->wrtn;
+        storeRelease(buffer->head, buffer->wrtn);
         errorWriting = false;
         return true;
     }
@@ -595,14 +824,15 @@ protected:
         DISTRHO_SAFE_ASSERT_RETURN(size > 0, false);
         DISTRHO_SAFE_ASSERT_RETURN(size < buffer->size, false);
 
+        const uint32_t tail = buffer->tail;
+        const uint32_t head = getHeadForReading(tail, size);
+
         // empty
-        if (buffer->head == buffer->tail)
+        if (head == tail)
             return false;
 
         uint8_t* const bytebuf = static_cast<uint8_t*>(buf);
 
-        const uint32_t head = buffer->head;
-        const uint32_t tail = buffer->tail;
         const uint32_t wrap = head > tail ? 0 : buffer->size;
 
         if (size > wrap + head - tail)
@@ -640,7 +870,7 @@ protected:
                 readto = 0;
         }
 
-        buffer->tail = readto;
+        storeRelease(buffer->tail, readto);
         errorReading = false;
         return true;
     }
@@ -661,14 +891,15 @@ protected:
         DISTRHO_SAFE_ASSERT_RETURN(size > 0, false);
         DISTRHO_SAFE_ASSERT_RETURN(size < buffer->size, false);
 
+        const uint32_t tail = buffer->tail;
+        const uint32_t head = getHeadForReading(tail, size);
+
         // empty
-        if (buffer->head == buffer->tail)
+        if (head == tail)
             return false;
 
         uint8_t* const bytebuf = static_cast<uint8_t*>(buf);
 
-        const uint32_t head = buffer->head;
-        const uint32_t tail = buffer->tail;
         const uint32_t wrap = head > tail ? 0 : buffer->size;
 
         if (size > wrap + head - tail)
@@ -712,8 +943,8 @@ protected:
 
         const uint8_t* const bytebuf = static_cast<const uint8_t*>(buf);
 
-        const uint32_t tail = buffer->tail;
         const uint32_t wrtn = buffer->wrtn;
+        const uint32_t tail = getTailForWriting(wrtn, size);
         const uint32_t wrap = tail > wrtn ? 0 : buffer->size;
 
         if (size >= wrap + tail - wrtn)
@@ -757,6 +988,43 @@ protected:
     }
 
 private:
+    /** @internal get the write position for reading @a size bytes, which may be a cached value.
+        Only for the read path, as it can update the cache owned by the reading side. */
+    uint32_t getHeadForReading(uint32_t tail, uint32_t size) const noexcept;
+
+    /** @internal get the read position for writing @a size bytes, which may be a cached value.
+        Only for the write path, as it can update the cache owned by the writing side. */
+    uint32_t getTailForWriting(uint32_t wrtn, uint32_t size) const noexcept;
+
+    /** @internal reset cached positions, after the buffer positions are reset. */
+    void resetCachedPositions() noexcept;
+
+    /** @internal load a position written by the other side of the buffer. */
+    static uint32_t loadAcquire(const uint32_t& pos) noexcept
+    {
+       #if defined(_MSC_VER) && defined(_M_ARM64)
+        // ldar only reads, the intrinsic just lacks a const variant
+        return __ldar32(const_cast<volatile unsigned __int32*>(reinterpret_cast<const volatile unsigned __int32*>(&pos)));
+       #elif defined(_MSC_VER)
+        // x86 loads already have acquire semantics, only compiler reordering needs to be prevented
+        const uint32_t value = *static_cast<const volatile uint32_t*>(&pos);
+        _ReadWriteBarrier();
+        return value;
+       #else
+        return __atomic_load_n(&pos, __ATOMIC_ACQUIRE);
+       #endif
+    }
+
+    /** @internal publish a position to the other side of the buffer. */
+    static void storeRelease(uint32_t& pos, const uint32_t value) noexcept
+    {
+       #ifdef _MSC_VER
+        _InterlockedExchange(reinterpret_cast<volatile long*>(&pos), static_cast<long>(value));
+       #else
+        __atomic_store_n(&pos, value, __ATOMIC_RELEASE);
+       #endif
+    }
+
     /** Buffer struct pointer. */
     BufferStruct* buffer;
 
@@ -770,18 +1038,196 @@ private:
     DISTRHO_DECLARE_NON_COPYABLE(RingBufferControl)
 };
 
+template <class BufferStruct>
+inline uint32_t RingBufferControl<BufferStruct>::getHeadForReading(uint32_t, uint32_t) const noexcept
+{
+    return loadAcquire(buffer->head);
+}
+
+template <class BufferStruct>
+inline uint32_t RingBufferControl<BufferStruct>::getTailForWriting(uint32_t, uint32_t) const noexcept
+{
+    return loadAcquire(buffer->tail);
+}
+
+template <class BufferStruct>
+inline void RingBufferControl<BufferStruct>::resetCachedPositions() noexcept {}
+
+template <>
+inline uint32_t RingBufferControl<AlignedHeapBuffer>::getHeadForReading(const uint32_t tail,
+                                                                        const uint32_t size) const noexcept
+{
+    uint32_t head = buffer->cachedHead;
+
+    if ((head >= tail ? head - tail : buffer->size + head - tail) < size)
+        buffer->cachedHead = head = loadAcquire(buffer->head);
+
+    return head;
+}
+
+template <>
+inline uint32_t RingBufferControl<AlignedHeapBuffer>::getTailForWriting(const uint32_t wrtn,
+                                                                        const uint32_t size) const noexcept
+{
+    uint32_t tail = buffer->cachedTail;
+
+    if ((tail > wrtn ? tail - wrtn : buffer->size + tail - wrtn) <= size)
+        buffer->cachedTail = tail = loadAcquire(buffer->tail);
+
+    return tail;
+}
+
+template <>
+inline void RingBufferControl<AlignedHeapBuffer>::resetCachedPositions() noexcept
+{
+    buffer->cachedHead = buffer->cachedTail = 0;
+}
+
 template <class BufferStruct>
 inline bool RingBufferControl<BufferStruct>::isDataAvailableForReading() const noexcept
 {
-    return (buffer != nullptr && buffer->head != buffer->tail);
+    return (buffer != nullptr && loadAcquire(buffer->head) != loadAcquire(buffer->tail));
 }
 
 template <>
 inline bool RingBufferControl<HeapBuffer>::isDataAvailableForReading() const noexcept
 {
-    return (buffer != nullptr && buffer->buf != nullptr && buffer->head != buffer->tail);
+    return (buffer != nullptr && buffer->buf != nullptr && loadAcquire(buffer->head) != loadAcquire(buffer->tail));
+}
+
+template <>
+inline bool RingBufferControl<AlignedHeapBuffer>::isDataAvailableForReading() const noexcept
+{
+    return (buffer != nullptr && buffer->buf != nullptr && loadAcquire(buffer->head) != loadAcquire(buffer->tail));
 }
 
+// -----------------------------------------------------------------------
+// RingBufferControl variant for multiple writers
+
+/**
+   RingBufferControl variant that allows several threads to write into the same ring buffer.
+   Reading must still happen from a single thread, and stays wait and lock-free.
+
+   Writers serialize on a light spin-lock, which must be held during a full write + commit sequence.
+   The easiest way to do so is with a ScopedWriteLocker:
+   ```
+   {
+       const MultiWriterRingBufferControl<SmallStackBuffer>::ScopedWriteLocker swl(myRingBuffer);
+       myRingBuffer.writeCustomData(data, size);
+       myRingBuffer.commitWrite();
+   }
+   ```
+
+   Realtime threads that need to write should use tryLockWrite() instead, and skip writing if it fails.
+ */
+template <class BufferStruct>
+class MultiWriterRingBufferControl : public RingBufferControl<BufferStruct>
+{
+public:
+    /*
+     * Constructor for uninitialised ring buffer.
+     */
+    MultiWriterRingBufferControl() noexcept
+        : RingBufferControl<BufferStruct>(),
+          writeLock(0) {}
+
+    /*
+     * Lock the writing side, waiting for other writers to finish.
+     */
+    void lockWrite() noexcept
+    {
+        while (! tryLockWrite())
+        {
+            // wait with plain loads until the lock looks free, letting the holder's core run meanwhile
+            do {
+                pause();
+            } while (isWriteLocked());
+        }
+    }
+
+    /*
+     * Try to lock the writing side, returning false if another writer holds the lock.
+     */
+    bool tryLockWrite() noexcept
+    {
+       #ifdef _MSC_VER
+        return _InterlockedCompareExchange(&writeLock, 1, 0) == 0;
+       #else
+        int32_t expected = 0;
+        return __atomic_compare_exchange_n(&writeLock, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+       #endif
+    }
+
+    /*
+     * Unlock the writing side.
+     */
+    void unlockWrite() noexcept
+    {
+       #ifdef _MSC_VER
+        _InterlockedExchange(&writeLock, 0);
+       #else
+        __atomic_store_n(&writeLock, 0, __ATOMIC_RELEASE);
+       #endif
+    }
+
+    /**
+       Helper class to lock the writing side of a MultiWriterRingBufferControl during a scope.
+     */
+    class ScopedWriteLocker
+    {
+    public:
+        ScopedWriteLocker(MultiWriterRingBufferControl& rb) noexcept
+            : ringBuffer(rb)
+        {
+            ringBuffer.lockWrite();
+        }
+
+        ~ScopedWriteLocker() noexcept
+        {
+            ringBuffer.unlockWrite();
+        }
+
+    private:
+        MultiWriterRingBufferControl& ringBuffer;
+
+        DISTRHO_PREVENT_HEAP_ALLOCATION
+        DISTRHO_DECLARE_NON_COPYABLE(ScopedWriteLocker)
+    };
+
+private:
+    /** @internal check if the lock is held, without trying to take it. */
+    bool isWriteLocked() const noexcept
+    {
+       #ifdef _MSC_VER
+        return writeLock != 0;
+       #else
+        return __atomic_load_n(&writeLock, __ATOMIC_RELAXED) != 0;
+       #endif
+    }
+
+    /** @internal CPU hint for spin-wait loops, same as used in ThreadPool. */
+    static void pause() noexcept
+    {
+       #if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+        _mm_pause();
+       #elif defined(_MSC_VER) && defined(_M_ARM64)
+        __yield();
+       #elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+       #endif
+    }
+
+    /** Lock shared by all writers. */
+   #ifdef _MSC_VER
+    volatile long writeLock;
+   #else
+    int32_t writeLock;
+   #endif
+
+    DISTRHO_PREVENT_VIRTUAL_HEAP_ALLOCATION
+    DISTRHO_DECLARE_NON_COPYABLE(MultiWriterRingBufferControl)
+};
+
 // -----------------------------------------------------------------------
 // RingBuffer using heap space
 
@@ -853,6 +1299,71 @@ private:
     DISTRHO_DECLARE_NON_COPYABLE(HeapRingBuffer)
 };
 
+// -----------------------------------------------------------------------
+// RingBuffer using heap space, with a cache-line aware layout
+
+/**
+   RingBufferControl with an AlignedHeapBuffer.
+   Works just like HeapRingBuffer, but is better suited for a writer and a reader running on different cores,
+   like the audio thread sending data to the UI thread.
+   Requires the use of createBuffer(uint32_t) to make the ring buffer usable.
+*/
+class AlignedHeapRingBuffer : public RingBufferControl<AlignedHeapBuffer>
+{
+public:
+    /** Constructor. */
+    AlignedHeapRingBuffer() noexcept
+    {
+        std::memset(&heapBuffer, 0, sizeof(heapBuffer));
+    }
+
+    /** Destructor. */
+    ~AlignedHeapRingBuffer() noexcept override
+    {
+        if (heapBuffer.buf == nullptr)
+            return;
+
+        delete[] heapBuffer.buf;
+        heapBuffer.buf = nullptr;
+    }
+
+    /** Create a buffer of the specified size. */
+    bool createBuffer(const uint32_t size) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(heapBuffer.buf == nullptr, false);
+        DISTRHO_SAFE_ASSERT_RETURN(size > 0,  false);
+
+        const uint32_t p2size = d_nextPowerOf2(size);
+
+        try {
+            heapBuffer.buf = new uint8_t[p2size];
+        } DISTRHO_SAFE_EXCEPTION_RETURN("AlignedHeapRingBuffer::createBuffer", false);
+
+        heapBuffer.size = p2size;
+        setRingBuffer(&heapBuffer, true);
+        return true;
+    }
+
+    /** Delete the previously allocated buffer. */
+    void deleteBuffer() noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(heapBuffer.buf != nullptr,);
+
+        setRingBuffer(nullptr, false);
+
+        delete[] heapBuffer.buf;
+        heapBuffer.buf  = nullptr;
+        heapBuffer.size = 0;
+    }
+
+private:
+    /** The heap buffer used for this class. */
+    AlignedHeapBuffer heapBuffer;
+
+    DISTRHO_PREVENT_VIRTUAL_HEAP_ALLOCATION
+    DISTRHO_DECLARE_NON_COPYABLE(AlignedHeapRingBuffer)
+};
+
 // -----------------------------------------------------------------------
 // RingBuffer using small stack space
 
@@ -28,6 +28,108 @@
 
 START_NAMESPACE_DISTRHO
 
+class String;
+
+// -----------------------------------------------------------------------
+// StringView class
+
+/*
+ * Non-owning reference to a sequence of characters, for lookups and comparisons without copying.
+ * The referenced data must outlive the view, and does not need to be null-terminated.
+ */
+class StringView
+{
+public:
+    /*
+     * Empty view.
+     */
+    StringView() noexcept
+        : fData(""),
+          fLength(0) {}
+
+    /*
+     * View of a null-terminated string.
+     */
+    StringView(const char* const strBuf) noexcept
+        : fData(strBuf != nullptr ? strBuf : ""),
+          fLength(strBuf != nullptr ? std::strlen(strBuf) : 0) {}
+
+    /*
+     * View of a String, which becomes invalid once the string is modified or deleted.
+     */
+    StringView(const String& str) noexcept;
+
+    /*
+     * View of the first 'length' characters of 'data'.
+     */
+    StringView(const char* const data, const size_t length) noexcept
+        : fData(data != nullptr ? data : ""),
+          fLength(data != nullptr ? length : 0) {}
+
+    /*
+     * Direct access to the viewed characters, not necessarily null-terminated.
+     */
+    const char* data() const noexcept
+    {
+        return fData;
+    }
+
+    /*
+     * Get length of the view.
+     */
+    size_t length() const noexcept
+    {
+        return fLength;
+    }
+
+    /*
+     * Check if the view is empty.
+     */
+    bool isEmpty() const noexcept
+    {
+        return fLength == 0;
+    }
+
+    /*
+     * Check if the view is not empty.
+     */
+    bool isNotEmpty() const noexcept
+    {
+        return fLength != 0;
+    }
+
+    /*
+     * Check if the view starts with another one.
+     */
+    bool startsWith(const StringView& prefix) const noexcept
+    {
+        return fLength >= prefix.fLength && std::memcmp(fData, prefix.fData, prefix.fLength) == 0;
+    }
+
+    /*
+     * Check if the view ends with another one.
+     */
+    bool endsWith(const StringView& suffix) const noexcept
+    {
+        return fLength >= suffix.fLength &&
+               std::memcmp(fData + (fLength - suffix.fLength), suffix.fData, suffix.fLength) == 0;
+    }
+
+    friend bool operator==(const StringView& a, const StringView& b) noexcept
+    {
+        return a.fLength == b.fLength && std::memcmp(a.fData, b.fData, a.fLength) == 0;
+    }
+
+    friend bool operator!=(const StringView& a, const StringView& b) noexcept
+    {
+        return !(a == b);
+    }
+
+private:
+    const char* fData;
+    size_t fLength;
+};
+
 // -----------------------------------------------------------------------
 // String class
 
@@ -88,6 +190,19 @@ public:
         _dup(strBuf);
     }
 
+    /*
+     * Copy of a string view.
+     */
+    explicit String(const StringView& strView) noexcept
+        : fBuffer(_null()),
+          fBufferLen(0),
+          fBufferAlloc(false)
+    {
+        // views are not null terminated, so an empty one must not be given to _dup (which would use strlen)
+        if (strView.length() != 0)
+            _dup(strView.data(), strView.length());
+    }
+
    #if __cplusplus >= 201703L
     /*
      * std::string_view compatible variant.
@@ -97,7 +212,8 @@ public:
           fBufferLen(0),
           fBufferAlloc(false)
     {
-        _dup(strView.data(), strView.size());
+        if (strView.size() != 0)
+            _dup(strView.data(), strView.size());
     }
    #endif
 
@@ -242,8 +358,21 @@ public:
           fBufferLen(0),
           fBufferAlloc(false)
     {
-        _dup(str.fBuffer);
+        _dup(str.fBuffer, str.fBufferLen);
+    }
+
+   #ifdef DISTRHO_PROPER_CPP11_SUPPORT
+    /*
+     * Move constructor, takes over the contents of another string without copying.
+     */
+    String(String&& str) noexcept
+        : fBuffer(_null()),
+          fBufferLen(0),
+          fBufferAlloc(false)
+    {
+        _move(str);
     }
+   #endif
 
     // -------------------------------------------------------------------
     // destructor
@@ -677,7 +806,25 @@ public:
      */
     char* getAndReleaseBuffer() noexcept
     {
-        char* ret = fBufferLen > 0 ? fBuffer : nullptr;
+        char* ret = nullptr;
+
+        if (fBufferLen > 0)
+        {
+            if (fBufferAlloc)
+            {
+                ret = fBuffer;
+            }
+            // short strings are not allocated, make a copy for the caller
+            else if ((ret = static_cast<char*>(std::malloc(fBufferLen + 1))) != nullptr)
+            {
+                std::memcpy(ret, fBuffer, fBufferLen + 1);
+            }
+        }
+        else if (fBufferAlloc)
+        {
+            std::free(fBuffer);
+        }
+
         fBuffer = _null();
         fBufferLen = 0;
         fBufferAlloc = false;
@@ -878,7 +1025,9 @@ public:
 
         *newbufptr = '\0';
 
-        std::free(fBuffer);
+        if (fBufferAlloc)
+            std::free(fBuffer);
+
         fBuffer = newbuf;
         fBufferLen = std::strlen(newbuf);
         fBufferAlloc = true;
@@ -939,7 +1088,9 @@ public:
 
         *newbufptr = '\0';
 
-        std::free(fBuffer);
+        if (fBufferAlloc)
+            std::free(fBuffer);
+
         fBuffer = newbuf;
         fBufferLen = std::strlen(newbuf);
         fBufferAlloc = true;
@@ -1005,10 +1156,23 @@ public:
 
     String& operator=(const String& str) noexcept
     {
-        _dup(str.fBuffer);
+        _dup(str.fBuffer, str.fBufferLen);
+
+        return *this;
+    }
+
+   #ifdef DISTRHO_PROPER_CPP11_SUPPORT
+    String& operator=(String&& str) noexcept
+    {
+        if (this != &str)
+        {
+            _dup(nullptr);
+            _move(str);
+        }
 
         return *this;
     }
+   #endif
 
     String& operator+=(const char* const strBuf) noexcept
     {
@@ -1024,10 +1188,21 @@ public:
             return *this;
         }
 
-        // we have some data ourselves, reallocate to add the new stuff
+        // we have some data ourselves, try to keep it in the inline buffer
+        if (! fBufferAlloc && fBufferLen + strBufLen < kInlineBufferSize)
+        {
+            std::memmove(fInlineBuffer + fBufferLen, strBuf, strBufLen + 1);
+            fBufferLen += strBufLen;
+            return *this;
+        }
+
+        // otherwise reallocate to add the new stuff
         char* const newBuf = static_cast<char*>(std::realloc(fBufferAlloc ? fBuffer : nullptr, fBufferLen + strBufLen + 1));
         DISTRHO_SAFE_ASSERT_RETURN(newBuf != nullptr, *this);
 
+        if (! fBufferAlloc)
+            std::memcpy(newBuf, fBuffer, fBufferLen);
+
         std::memcpy(newBuf + fBufferLen, strBuf, strBufLen + 1);
 
         fBuffer = newBuf;
@@ -1074,9 +1249,13 @@ public:
     // -------------------------------------------------------------------
 
 private:
+    // strings shorter than this are stored inline, without allocating
+    static const size_t kInlineBufferSize = 24;
+
     char*       fBuffer;      // the actual string buffer
-    size_t fBufferLen;   // string length
-    bool        fBufferAlloc; // wherever the buffer is allocated, not using _null()
+    size_t      fBufferLen;   // string length
+    bool        fBufferAlloc; // wherever the buffer is allocated, not using _null() or fInlineBuffer
+    char        fInlineBuffer[kInlineBufferSize];
 
     /*
      * Static null string.
@@ -1094,23 +1273,57 @@ private:
      *
      * Notes:
      * - Allocates string only if 'strBuf' is not null and new string contents are different
+     * - Short strings are copied into the inline buffer instead of allocating
+     * - Existing allocations are resized instead of replaced, unless 'strBuf' points into them
      * - If 'strBuf' is null, 'size' must be 0
      */
     void _dup(const char* const strBuf, const size_t size = 0) noexcept
     {
         if (strBuf != nullptr)
         {
+            const size_t strBufLen = (size > 0) ? size : std::strlen(strBuf);
+
             // don't recreate string if contents match
-            if (std::strcmp(fBuffer, strBuf) == 0)
+            if (fBufferLen == strBufLen && std::memcmp(fBuffer, strBuf, strBufLen) == 0)
                 return;
 
-            if (fBufferAlloc)
-                std::free(fBuffer);
+            if (strBufLen == 0)
+            {
+                _dup(nullptr);
+                return;
+            }
+
+            if (strBufLen < kInlineBufferSize)
+            {
+                // 'strBuf' might point into our own buffer, so copy before releasing it
+                std::memmove(fInlineBuffer, strBuf, strBufLen);
+                fInlineBuffer[strBufLen] = '\0';
+
+                if (fBufferAlloc)
+                    std::free(fBuffer);
+
+                fBuffer      = fInlineBuffer;
+                fBufferLen   = strBufLen;
+                fBufferAlloc = false;
+                return;
+            }
+
+            // resize our own allocation if possible, so big values can be updated in place
+            const bool resize = fBufferAlloc && (strBuf < fBuffer || strBuf > fBuffer + fBufferLen);
 
-            fBufferLen = (size > 0) ? size : std::strlen(strBuf);
-            fBuffer    = static_cast<char*>(std::malloc(fBufferLen + 1));
+            char* const newBuf = static_cast<char*>(resize ? std::realloc(fBuffer, strBufLen + 1)
+                                                           : std::malloc(strBufLen + 1));
 
-            if (fBuffer == nullptr)
+            if (newBuf != nullptr)
+            {
+                std::memcpy(newBuf, strBuf, strBufLen);
+                newBuf[strBufLen] = '\0';
+            }
+
+            if (fBufferAlloc && ! (resize && newBuf != nullptr))
+                std::free(fBuffer);
+
+            if (newBuf == nullptr)
             {
                 fBuffer      = _null();
                 fBufferLen   = 0;
@@ -1118,21 +1331,23 @@ private:
                 return;
             }
 
+            fBuffer      = newBuf;
+            fBufferLen   = strBufLen;
             fBufferAlloc = true;
-
-            std::strcpy(fBuffer, strBuf);
-            fBuffer[fBufferLen] = '\0';
         }
         else
         {
             DISTRHO_SAFE_ASSERT_UINT(size == 0, static_cast<uint>(size));
 
             // don't recreate null string
-            if (! fBufferAlloc)
+            if (fBuffer == _null())
                 return;
 
-            DISTRHO_SAFE_ASSERT(fBuffer != nullptr);
-            std::free(fBuffer);
+            if (fBufferAlloc)
+            {
+                DISTRHO_SAFE_ASSERT(fBuffer != nullptr);
+                std::free(fBuffer);
+            }
 
             fBuffer      = _null();
             fBufferLen   = 0;
@@ -1140,11 +1355,44 @@ private:
         }
     }
 
+   #ifdef DISTRHO_PROPER_CPP11_SUPPORT
+    /*
+     * Helper function.
+     * Takes over the contents of 'str', leaving it empty.
+     * This string must be empty when called.
+     */
+    void _move(String& str) noexcept
+    {
+        if (str.fBufferAlloc)
+        {
+            fBuffer      = str.fBuffer;
+            fBufferAlloc = true;
+        }
+        else if (str.fBuffer == str.fInlineBuffer)
+        {
+            std::memcpy(fInlineBuffer, str.fInlineBuffer, str.fBufferLen + 1);
+            fBuffer = fInlineBuffer;
+        }
+
+        fBufferLen = str.fBufferLen;
+
+        str.fBuffer      = _null();
+        str.fBufferLen   = 0;
+        str.fBufferAlloc = false;
+    }
+   #endif
+
     DISTRHO_PREVENT_HEAP_ALLOCATION
 };
 
 // -----------------------------------------------------------------------
 
+inline StringView::StringView(const String& str) noexcept
+    : fData(str.buffer()),
+      fLength(str.length()) {}
+
+// -----------------------------------------------------------------------
+
 static inline
 String operator+(const String& strBefore, const char* const strBufAfter) noexcept
 {
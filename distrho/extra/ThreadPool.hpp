@@ -0,0 +1,467 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_THREAD_POOL_HPP_INCLUDED
+#define DISTRHO_THREAD_POOL_HPP_INCLUDED
+
+#include "Thread.hpp"
+
+#if defined(DISTRHO_OS_LINUX)
+# include <linux/futex.h>
+# include <sys/syscall.h>
+#elif defined(DISTRHO_OS_MAC)
+# include <dispatch/dispatch.h>
+#elif !defined(DISTRHO_OS_WINDOWS)
+# include <semaphore.h>
+#endif
+
+#if defined(__i386__) || defined(__x86_64__)
+# include <immintrin.h>
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+// ThreadPoolSemaphore class
+
+/*
+ * Counting semaphore used to park idle pool workers.
+ * Posting is realtime-safe, it never blocks nor allocates.
+ * Uses a futex on Linux and the native semaphore type elsewhere.
+ */
+class ThreadPoolSemaphore
+{
+public:
+    ThreadPoolSemaphore() noexcept
+    {
+       #if defined(DISTRHO_OS_LINUX)
+        fCount = 0;
+       #elif defined(DISTRHO_OS_MAC)
+        fSemaphore = dispatch_semaphore_create(0);
+       #elif defined(DISTRHO_OS_WINDOWS)
+        fSemaphore = ::CreateSemaphoreA(nullptr, 0, LONG_MAX, nullptr);
+       #else
+        sem_init(&fSemaphore, 0, 0);
+       #endif
+    }
+
+    ~ThreadPoolSemaphore() noexcept
+    {
+       #if defined(DISTRHO_OS_LINUX)
+       #elif defined(DISTRHO_OS_MAC)
+        dispatch_release(fSemaphore);
+       #elif defined(DISTRHO_OS_WINDOWS)
+        ::CloseHandle(fSemaphore);
+       #else
+        sem_destroy(&fSemaphore);
+       #endif
+    }
+
+    void post() noexcept
+    {
+       #if defined(DISTRHO_OS_LINUX)
+        __atomic_fetch_add(&fCount, 1, __ATOMIC_RELEASE);
+        syscall(SYS_futex, &fCount, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+       #elif defined(DISTRHO_OS_MAC)
+        dispatch_semaphore_signal(fSemaphore);
+       #elif defined(DISTRHO_OS_WINDOWS)
+        ::ReleaseSemaphore(fSemaphore, 1, nullptr);
+       #else
+        sem_post(&fSemaphore);
+       #endif
+    }
+
+    void wait() noexcept
+    {
+       #if defined(DISTRHO_OS_LINUX)
+        for (;;)
+        {
+            int32_t count = __atomic_load_n(&fCount, __ATOMIC_ACQUIRE);
+
+            while (count > 0)
+            {
+                if (__atomic_compare_exchange_n(&fCount, &count, count - 1, true,
+                                                __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+                    return;
+            }
+
+            syscall(SYS_futex, &fCount, FUTEX_WAIT_PRIVATE, 0, nullptr, nullptr, 0);
+        }
+       #elif defined(DISTRHO_OS_MAC)
+        dispatch_semaphore_wait(fSemaphore, DISPATCH_TIME_FOREVER);
+       #elif defined(DISTRHO_OS_WINDOWS)
+        ::WaitForSingleObject(fSemaphore, INFINITE);
+       #else
+        while (sem_wait(&fSemaphore) != 0 && errno == EINTR) {}
+       #endif
+    }
+
+private:
+   #if defined(DISTRHO_OS_LINUX)
+    int32_t fCount;
+   #elif defined(DISTRHO_OS_MAC)
+    dispatch_semaphore_t fSemaphore;
+   #elif defined(DISTRHO_OS_WINDOWS)
+    HANDLE fSemaphore;
+   #else
+    sem_t fSemaphore;
+   #endif
+
+    DISTRHO_DECLARE_NON_COPYABLE(ThreadPoolSemaphore)
+};
+
+// -----------------------------------------------------------------------
+// ThreadPool class
+
+/**
+   Pool of worker threads for splitting work of a single plugin instance across several CPU cores.
+
+   Workers are meant to be started in Plugin::activate() and stopped in Plugin::deactivate(),
+   so that run() only has to hand them work through parallelFor().
+   Between calls to parallelFor() the workers are parked, and do not use any CPU.
+
+   Work is split in equal ranges of indexes, one per thread, with the calling thread taking part too.
+   Threads that finish their own range early steal half of the remaining work from other threads,
+   so uneven workloads (like voices with different CPU usage) are still balanced.
+
+   Example usage:
+   ```
+   static void renderVoice(void* const userData, const uint32_t index)
+   {
+       MySynth* const self = static_cast<MySynth*>(userData);
+       self->fVoices[index].render(self->fFrames);
+   }
+
+   void activate() override
+   {
+       fThreadPool.start();
+   }
+
+   void deactivate() override
+   {
+       fThreadPool.stop();
+   }
+
+   void run(const float**, float** outputs, uint32_t frames, const MidiEvent*, uint32_t) override
+   {
+       fFrames = frames;
+       fThreadPool.parallelFor(kNumVoices, renderVoice, this);
+       // all voices are rendered at this point, mix them into outputs
+   }
+   ```
+ */
+class ThreadPool
+{
+public:
+    /**
+       Function called for each index in parallelFor().
+     */
+    typedef void (*ParallelForFunc)(void* userData, uint32_t index);
+
+    /**
+       Constructor.
+       Does not create any threads, see start().
+     */
+    ThreadPool(const char* const threadName = "dpf-pool") noexcept
+        : fThreadName(threadName),
+          fWorkers(nullptr),
+          fSlots(nullptr),
+          fNumWorkers(0),
+          fNumSlots(0),
+          fPending(0),
+          fFunc(nullptr),
+          fUserData(nullptr) {}
+
+    /**
+       Destructor.
+       Stops all workers if still running.
+     */
+    ~ThreadPool() noexcept
+    {
+        stop();
+    }
+
+    /**
+       Start the pool workers.
+       With @a numWorkers as 0 the number of CPU cores minus 1 is used, as the calling thread also takes part of the work.
+       Must not be called from the realtime/audio thread, typically called in Plugin::activate().
+     */
+    bool start(uint32_t numWorkers = 0, const bool withRealtimePriority = true) noexcept
+    {
+        stop();
+
+        if (numWorkers == 0)
+        {
+            const uint32_t numCores = getNumberOfCores();
+            numWorkers = numCores > 1 ? numCores - 1 : 0;
+        }
+
+        if (numWorkers == 0)
+            return true;
+
+        fSlots = new Slot[numWorkers + 1];
+        fWorkers = new Worker*[numWorkers];
+
+        for (uint32_t i = 0; i < numWorkers; ++i)
+        {
+            String name(fThreadName);
+            name += "-";
+            name += String(i + 1);
+
+            fWorkers[i] = new Worker(*this, i + 1, name);
+
+            if (! fWorkers[i]->startThread(withRealtimePriority))
+            {
+                delete fWorkers[i];
+                break;
+            }
+
+            ++fNumWorkers;
+        }
+
+        return fNumWorkers == numWorkers;
+    }
+
+    /**
+       Stop and delete all pool workers.
+       Must not be called from the realtime/audio thread, typically called in Plugin::deactivate().
+     */
+    void stop() noexcept
+    {
+        for (uint32_t i = 0; i < fNumWorkers; ++i)
+        {
+            fWorkers[i]->signalThreadShouldExit();
+            fWorkers[i]->fSemaphore.post();
+            fWorkers[i]->stopThread(-1);
+            delete fWorkers[i];
+        }
+
+        delete[] fWorkers;
+        delete[] fSlots;
+        fWorkers = nullptr;
+        fSlots = nullptr;
+        fNumWorkers = 0;
+    }
+
+    /**
+       Get the number of running worker threads, not counting the caller of parallelFor().
+     */
+    uint32_t getNumWorkers() const noexcept
+    {
+        return fNumWorkers;
+    }
+
+    /**
+       Call @a func for each index from 0 to @a count - 1, spreading the calls across the pool workers.
+       Returns once all calls are complete.
+       Does not allocate or lock, so it is safe to call from the realtime/audio thread.
+       Only one thread at a time can call this function, and @a func must not call it either.
+       If the pool has no workers everything runs directly in the calling thread.
+     */
+    void parallelFor(const uint32_t count, const ParallelForFunc func, void* const userData) noexcept
+    {
+        if (count == 0)
+            return;
+
+        if (fNumWorkers == 0 || count == 1)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+                func(userData, i);
+            return;
+        }
+
+        fNumSlots = std::min(fNumWorkers + 1, count);
+        fFunc = func;
+        fUserData = userData;
+
+        for (uint32_t i = 0; i < fNumSlots; ++i)
+        {
+            const uint64_t begin = static_cast<uint64_t>(count) * i / fNumSlots;
+            const uint64_t end = static_cast<uint64_t>(count) * (i + 1) / fNumSlots;
+            __atomic_store_n(&fSlots[i].range, makeRange(static_cast<uint32_t>(begin), static_cast<uint32_t>(end)),
+                             __ATOMIC_RELAXED);
+        }
+
+        __atomic_store_n(&fPending, fNumSlots - 1, __ATOMIC_RELEASE);
+
+        // the semaphore post makes all of the above visible to the workers
+        for (uint32_t i = 1; i < fNumSlots; ++i)
+            fWorkers[i - 1]->fSemaphore.post();
+
+        runSlot(0);
+
+        // other threads are finishing their last task by now, no point in sleeping
+        while (__atomic_load_n(&fPending, __ATOMIC_ACQUIRE) != 0)
+            pause();
+    }
+
+    /**
+       Get the number of CPU cores available in the system.
+     */
+    static uint32_t getNumberOfCores() noexcept
+    {
+       #ifdef DISTRHO_OS_WINDOWS
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        return static_cast<uint32_t>(info.dwNumberOfProcessors);
+       #else
+        const long numCores = sysconf(_SC_NPROCESSORS_ONLN);
+        return numCores > 0 ? static_cast<uint32_t>(numCores) : 1;
+       #endif
+    }
+
+private:
+    class Worker : public Thread
+    {
+    public:
+        Worker(ThreadPool& pool, const uint32_t slot, const char* const name) noexcept
+            : Thread(name),
+              fSemaphore(),
+              fPool(pool),
+              fSlot(slot) {}
+
+        ThreadPoolSemaphore fSemaphore;
+
+    protected:
+        void run() override
+        {
+            for (;;)
+            {
+                fSemaphore.wait();
+
+                if (shouldThreadExit())
+                    break;
+
+                fPool.runSlot(fSlot);
+                __atomic_sub_fetch(&fPool.fPending, 1, __ATOMIC_RELEASE);
+            }
+        }
+
+    private:
+        ThreadPool& fPool;
+        const uint32_t fSlot;
+
+        DISTRHO_DECLARE_NON_COPYABLE(Worker)
+    };
+
+    // range of remaining indexes for a single thread, begin in the low bits and end in the high bits.
+    // padded to a full cache line so threads do not invalidate each other's ranges
+    struct Slot {
+        uint64_t range;
+        char padding[64 - sizeof(uint64_t)];
+
+        Slot() noexcept
+            : range(0) {}
+    };
+
+    const String fThreadName;
+    Worker** fWorkers;
+    Slot* fSlots;
+    uint32_t fNumWorkers;
+    uint32_t fNumSlots;
+    uint32_t fPending;
+    ParallelForFunc fFunc;
+    void* fUserData;
+
+    static uint64_t makeRange(const uint32_t begin, const uint32_t end) noexcept
+    {
+        return static_cast<uint64_t>(begin) | (static_cast<uint64_t>(end) << 32);
+    }
+
+    static void pause() noexcept
+    {
+       #if defined(__i386__) || defined(__x86_64__)
+        _mm_pause();
+       #elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+       #endif
+    }
+
+    // take the next index from the front of our own range
+    bool popFront(Slot& slot, uint32_t& index) noexcept
+    {
+        uint64_t range = __atomic_load_n(&slot.range, __ATOMIC_ACQUIRE);
+
+        for (;;)
+        {
+            const uint32_t begin = static_cast<uint32_t>(range);
+            const uint32_t end = static_cast<uint32_t>(range >> 32);
+
+            if (begin >= end)
+                return false;
+
+            if (__atomic_compare_exchange_n(&slot.range, &range, makeRange(begin + 1, end), true,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                index = begin;
+                return true;
+            }
+        }
+    }
+
+    // take half of the remaining indexes from the back of another thread's range, and make them our own
+    bool steal(Slot& victim, Slot& thief) noexcept
+    {
+        uint64_t range = __atomic_load_n(&victim.range, __ATOMIC_ACQUIRE);
+
+        for (;;)
+        {
+            const uint32_t begin = static_cast<uint32_t>(range);
+            const uint32_t end = static_cast<uint32_t>(range >> 32);
+
+            if (begin >= end)
+                return false;
+
+            const uint32_t middle = end - std::max(1u, (end - begin) / 2);
+
+            if (__atomic_compare_exchange_n(&victim.range, &range, makeRange(begin, middle), true,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                // our own range is empty, so nobody else can be modifying it right now
+                __atomic_store_n(&thief.range, makeRange(middle, end), __ATOMIC_RELEASE);
+                return true;
+            }
+        }
+    }
+
+    void runSlot(const uint32_t slotIndex) noexcept
+    {
+        Slot& slot(fSlots[slotIndex]);
+        uint32_t index;
+
+        for (;;)
+        {
+            while (popFront(slot, index))
+                fFunc(fUserData, index);
+
+            bool stolen = false;
+
+            for (uint32_t i = 1; i < fNumSlots && ! stolen; ++i)
+                stolen = steal(fSlots[(slotIndex + i) % fNumSlots], slot);
+
+            if (! stolen)
+                break;
+        }
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(ThreadPool)
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DISTRHO_THREAD_POOL_HPP_INCLUDED
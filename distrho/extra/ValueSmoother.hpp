@@ -20,8 +20,67 @@
 
 #include "../DistrhoUtils.hpp"
 
+#if defined(__AVX__)
+# include <immintrin.h>
+#elif defined(__SSE2_MATH__)
+# include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+# include <arm_neon.h>
+#endif
+
 START_NAMESPACE_DISTRHO
 
+// --------------------------------------------------------------------------------------------------------------------
+// Vector operations used by the block methods, the best available instruction set is picked at build time
+
+#if defined(__AVX__) || defined(__SSE2_MATH__) || defined(__ARM_NEON)
+# define DISTRHO_VALUE_SMOOTHER_USE_SIMD 1
+#else
+# define DISTRHO_VALUE_SMOOTHER_USE_SIMD 0
+#endif
+
+#if DISTRHO_VALUE_SMOOTHER_USE_SIMD
+struct ValueSmootherVector {
+   #if defined(__AVX__)
+    typedef __m256 type;
+    enum { kSize = 8 };
+
+    static inline type load(const float* const p) noexcept { return _mm256_loadu_ps(p); }
+    static inline void store(float* const p, const type v) noexcept { _mm256_storeu_ps(p, v); }
+    static inline type set1(const float v) noexcept { return _mm256_set1_ps(v); }
+    static inline type add(const type a, const type b) noexcept { return _mm256_add_ps(a, b); }
+    static inline type sub(const type a, const type b) noexcept { return _mm256_sub_ps(a, b); }
+    static inline type mul(const type a, const type b) noexcept { return _mm256_mul_ps(a, b); }
+    static inline type min(const type a, const type b) noexcept { return _mm256_min_ps(a, b); }
+    static inline type max(const type a, const type b) noexcept { return _mm256_max_ps(a, b); }
+   #elif defined(__SSE2_MATH__)
+    typedef __m128 type;
+    enum { kSize = 4 };
+
+    static inline type load(const float* const p) noexcept { return _mm_loadu_ps(p); }
+    static inline void store(float* const p, const type v) noexcept { _mm_storeu_ps(p, v); }
+    static inline type set1(const float v) noexcept { return _mm_set1_ps(v); }
+    static inline type add(const type a, const type b) noexcept { return _mm_add_ps(a, b); }
+    static inline type sub(const type a, const type b) noexcept { return _mm_sub_ps(a, b); }
+    static inline type mul(const type a, const type b) noexcept { return _mm_mul_ps(a, b); }
+    static inline type min(const type a, const type b) noexcept { return _mm_min_ps(a, b); }
+    static inline type max(const type a, const type b) noexcept { return _mm_max_ps(a, b); }
+   #else
+    typedef float32x4_t type;
+    enum { kSize = 4 };
+
+    static inline type load(const float* const p) noexcept { return vld1q_f32(p); }
+    static inline void store(float* const p, const type v) noexcept { vst1q_f32(p, v); }
+    static inline type set1(const float v) noexcept { return vdupq_n_f32(v); }
+    static inline type add(const type a, const type b) noexcept { return vaddq_f32(a, b); }
+    static inline type sub(const type a, const type b) noexcept { return vsubq_f32(a, b); }
+    static inline type mul(const type a, const type b) noexcept { return vmulq_f32(a, b); }
+    static inline type min(const type a, const type b) noexcept { return vminq_f32(a, b); }
+    static inline type max(const type a, const type b) noexcept { return vmaxq_f32(a, b); }
+   #endif
+};
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 
 /**
@@ -101,6 +160,78 @@ public:
         return (mem = mem * coef + target * (1.f - coef));
     }
 
+    /**
+       Write the next @a frames values into @a out.
+       Same as calling next() for each frame, up to rounding differences.
+     */
+    void fill(float* out, uint32_t frames) noexcept
+    {
+       #if DISTRHO_VALUE_SMOOTHER_USE_SIMD
+        typedef ValueSmootherVector V;
+
+        if (frames >= V::kSize)
+        {
+            // the value at frame n is target + (mem - target) * coef^n
+            float powers[V::kSize];
+            float power = coef;
+            for (uint32_t i = 0; i < V::kSize; ++i, power *= coef)
+                powers[i] = power;
+
+            const V::type vtarget = V::set1(target);
+            const V::type vcoef = V::set1(powers[V::kSize - 1]);
+            V::type vdiff = V::mul(V::set1(mem - target), V::load(powers));
+
+            for (; frames >= V::kSize; frames -= V::kSize, out += V::kSize)
+            {
+                V::store(out, V::add(vtarget, vdiff));
+                vdiff = V::mul(vdiff, vcoef);
+            }
+
+            mem = out[-1];
+        }
+       #endif
+
+        for (; frames != 0; --frames)
+            *out++ = next();
+    }
+
+    /**
+       Multiply @a frames samples of @a buffer in place by the next smoothed values.
+       Useful for applying a smoothed gain.
+     */
+    void multiply(float* buffer, uint32_t frames) noexcept
+    {
+       #if DISTRHO_VALUE_SMOOTHER_USE_SIMD
+        typedef ValueSmootherVector V;
+
+        if (frames >= V::kSize)
+        {
+            float powers[V::kSize];
+            float power = coef;
+            for (uint32_t i = 0; i < V::kSize; ++i, power *= coef)
+                powers[i] = power;
+
+            const V::type vtarget = V::set1(target);
+            const V::type vcoef = V::set1(powers[V::kSize - 1]);
+            V::type vdiff = V::mul(V::set1(mem - target), V::load(powers));
+            V::type vgain = vtarget;
+
+            for (; frames >= V::kSize; frames -= V::kSize, buffer += V::kSize)
+            {
+                vgain = V::add(vtarget, vdiff);
+                V::store(buffer, V::mul(V::load(buffer), vgain));
+                vdiff = V::mul(vdiff, vcoef);
+            }
+
+            V::store(powers, vgain);
+            mem = powers[V::kSize - 1];
+        }
+       #endif
+
+        for (; frames != 0; --frames)
+            *buffer++ *= next();
+    }
+
 private:
     void updateCoef() noexcept
     {
@@ -190,6 +321,92 @@ public:
         return (mem = y0 + std::copysign(std::fmin(std::abs(dy), step), dy));
     }
 
+    /**
+       Write the next @a frames values into @a out.
+       Same as calling next() for each frame, up to rounding differences.
+     */
+    void fill(float* out, uint32_t frames) noexcept
+    {
+        if (d_isEqual(mem, target))
+        {
+            for (; frames != 0; --frames)
+                *out++ = target;
+            return;
+        }
+
+       #if DISTRHO_VALUE_SMOOTHER_USE_SIMD
+        typedef ValueSmootherVector V;
+
+        if (frames >= V::kSize)
+        {
+            // the value at frame n is target clamped to [mem - n * step, mem + n * step]
+            float offsets[V::kSize];
+            for (uint32_t i = 0; i < V::kSize; ++i)
+                offsets[i] = static_cast<float>(i + 1) * step;
+
+            const V::type vtarget = V::set1(target);
+            const V::type vmem = V::set1(mem);
+            const V::type vadvance = V::set1(static_cast<float>(V::kSize) * step);
+            V::type voffset = V::load(offsets);
+
+            for (; frames >= V::kSize; frames -= V::kSize, out += V::kSize)
+            {
+                V::store(out, V::max(V::min(vtarget, V::add(vmem, voffset)), V::sub(vmem, voffset)));
+                voffset = V::add(voffset, vadvance);
+            }
+
+            mem = out[-1];
+        }
+       #endif
+
+        for (; frames != 0; --frames)
+            *out++ = next();
+    }
+
+    /**
+       Multiply @a frames samples of @a buffer in place by the next smoothed values.
+       Useful for applying a smoothed gain.
+     */
+    void multiply(float* buffer, uint32_t frames) noexcept
+    {
+        if (d_isEqual(mem, target))
+        {
+            for (; frames != 0; --frames)
+                *buffer++ *= target;
+            return;
+        }
+
+       #if DISTRHO_VALUE_SMOOTHER_USE_SIMD
+        typedef ValueSmootherVector V;
+
+        if (frames >= V::kSize)
+        {
+            float offsets[V::kSize];
+            for (uint32_t i = 0; i < V::kSize; ++i)
+                offsets[i] = static_cast<float>(i + 1) * step;
+
+            const V::type vtarget = V::set1(target);
+            const V::type vmem = V::set1(mem);
+            const V::type vadvance = V::set1(static_cast<float>(V::kSize) * step);
+            V::type voffset = V::load(offsets);
+            V::type vgain = vmem;
+
+            for (; frames >= V::kSize; frames -= V::kSize, buffer += V::kSize)
+            {
+                vgain = V::max(V::min(vtarget, V::add(vmem, voffset)), V::sub(vmem, voffset));
+                V::store(buffer, V::mul(V::load(buffer), vgain));
+                voffset = V::add(voffset, vadvance);
+            }
+
+            V::store(offsets, vgain);
+            mem = offsets[V::kSize - 1];
+        }
+       #endif
+
+        for (; frames != 0; --frames)
+            *buffer++ *= next();
+    }
+
 private:
     void updateStep() noexcept
     {
@@ -199,6 +416,237 @@ private:
 
 // --------------------------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Several exponential smoothers sharing the same time constant
+ *
+ * Behaves like @a count ExponentialValueSmoother instances, but stores their values contiguously
+ * so that all of them can advance at once using vector instructions.
+ * Typical use is smoothing all parameters of a plugin at control rate.
+ */
+template <uint32_t count>
+class ExponentialValueSmootherArray {
+    float coef;
+    float tau;
+    float sampleRate;
+    float targets[count];
+    float mems[count];
+
+public:
+    ExponentialValueSmootherArray()
+        : coef(0.f),
+          tau(0.f),
+          sampleRate(0.f)
+    {
+        std::memset(targets, 0, sizeof(targets));
+        std::memset(mems, 0, sizeof(mems));
+    }
+
+    void setSampleRate(const float newSampleRate) noexcept
+    {
+        if (d_isNotEqual(sampleRate, newSampleRate))
+        {
+            sampleRate = newSampleRate;
+            updateCoef();
+        }
+    }
+
+    void setTimeConstant(const float newT60) noexcept
+    {
+        const float newTau = newT60 * (float)(1.0 / 6.91);
+
+        if (d_isNotEqual(tau, newTau))
+        {
+            tau = newTau;
+            updateCoef();
+        }
+    }
+
+    float getCurrentValue(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < count, index, count, 0.f);
+        return mems[index];
+    }
+
+    const float* getCurrentValues() const noexcept
+    {
+        return mems;
+    }
+
+    float getTargetValue(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < count, index, count, 0.f);
+        return targets[index];
+    }
+
+    void setTargetValue(const uint32_t index, const float newTarget) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < count, index, count,);
+        targets[index] = newTarget;
+    }
+
+    void clearToTargetValues() noexcept
+    {
+        std::memcpy(mems, targets, sizeof(mems));
+    }
+
+    /**
+       Advance all smoothers by @a frames samples, and get their current values.
+     */
+    const float* next(const uint32_t frames = 1) noexcept
+    {
+        const float c = frames == 1 ? coef : std::pow(coef, static_cast<float>(frames));
+        const float t = 1.f - c;
+        uint32_t i = 0;
+
+       #if DISTRHO_VALUE_SMOOTHER_USE_SIMD
+        typedef ValueSmootherVector V;
+
+        const V::type vc = V::set1(c);
+        const V::type vt = V::set1(t);
+
+        for (; i + V::kSize <= count; i += V::kSize)
+            V::store(mems + i, V::add(V::mul(V::load(mems + i), vc), V::mul(V::load(targets + i), vt)));
+       #endif
+
+        for (; i < count; ++i)
+            mems[i] = mems[i] * c + targets[i] * t;
+
+        return mems;
+    }
+
+private:
+    void updateCoef() noexcept
+    {
+        coef = std::exp(-1.f / (tau * sampleRate));
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Several linear smoothers sharing the same time constant
+ *
+ * Behaves like @a count LinearValueSmoother instances, but stores their values contiguously
+ * so that all of them can advance at once using vector instructions.
+ * Typical use is smoothing all parameters of a plugin at control rate.
+ */
+template <uint32_t count>
+class LinearValueSmootherArray {
+    float tau;
+    float sampleRate;
+    float steps[count];
+    float targets[count];
+    float mems[count];
+
+public:
+    LinearValueSmootherArray()
+        : tau(0.f),
+          sampleRate(0.f)
+    {
+        std::memset(steps, 0, sizeof(steps));
+        std::memset(targets, 0, sizeof(targets));
+        std::memset(mems, 0, sizeof(mems));
+    }
+
+    void setSampleRate(const float newSampleRate) noexcept
+    {
+        if (d_isNotEqual(sampleRate, newSampleRate))
+        {
+            sampleRate = newSampleRate;
+            updateSteps();
+        }
+    }
+
+    void setTimeConstant(const float newTau) noexcept
+    {
+        if (d_isNotEqual(tau, newTau))
+        {
+            tau = newTau;
+            updateSteps();
+        }
+    }
+
+    float getCurrentValue(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < count, index, count, 0.f);
+        return mems[index];
+    }
+
+    const float* getCurrentValues() const noexcept
+    {
+        return mems;
+    }
+
+    float getTargetValue(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < count, index, count, 0.f);
+        return targets[index];
+    }
+
+    void setTargetValue(const uint32_t index, const float newTarget) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < count, index, count,);
+
+        if (d_isNotEqual(targets[index], newTarget))
+        {
+            targets[index] = newTarget;
+            updateStep(index);
+        }
+    }
+
+    void clearToTargetValues() noexcept
+    {
+        std::memcpy(mems, targets, sizeof(mems));
+    }
+
+    /**
+       Advance all smoothers by @a frames samples, and get their current values.
+     */
+    const float* next(const uint32_t frames = 1) noexcept
+    {
+        const float n = static_cast<float>(frames);
+        uint32_t i = 0;
+
+       #if DISTRHO_VALUE_SMOOTHER_USE_SIMD
+        typedef ValueSmootherVector V;
+
+        const V::type vn = V::set1(n);
+
+        for (; i + V::kSize <= count; i += V::kSize)
+        {
+            const V::type vmem = V::load(mems + i);
+            const V::type voffset = V::mul(V::load(steps + i), vn);
+            V::store(mems + i, V::max(V::min(V::load(targets + i), V::add(vmem, voffset)), V::sub(vmem, voffset)));
+        }
+       #endif
+
+        for (; i < count; ++i)
+        {
+            const float offset = steps[i] * n;
+            mems[i] = std::fmax(std::fmin(targets[i], mems[i] + offset), mems[i] - offset);
+        }
+
+        return mems;
+    }
+
+private:
+    void updateStep(const uint32_t index) noexcept
+    {
+        const float dy = std::abs(targets[index] - mems[index]);
+
+        // avoid 0/0 when there is nothing to smooth, as NaN would get stuck in the vector code
+        steps[index] = d_isNotZero(dy) ? dy / (tau * sampleRate) : 0.f;
+    }
+
+    void updateSteps() noexcept
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            updateStep(i);
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
 END_NAMESPACE_DISTRHO
 
 #endif // DISTRHO_VALUE_SMOOTHER_HPP_INCLUDED
@@ -269,12 +269,30 @@ struct WebViewSharedBuffer {
     uint8_t  buf[size];
 };
 
+// plain values mirrored to the web page, polled by the child process at animation-frame rate
+struct WebViewSharedValues {
+    static constexpr const uint32_t size = 4096;
+    uint32_t seq, count;
+    float    values[size];
+};
+
 struct WebViewRingBuffer {
     WebViewSharedBuffer server;
     WebViewSharedBuffer client;
+    WebViewSharedValues values;
     bool valid;
 };
 
+// poll interval for shared values in ms, roughly 60fps
+static constexpr const uint kWebViewSharedValuesPollInterval = 16;
+
+// sent from the web page once loaded, handled on the child side to get all shared values again
+#define WEB_VIEW_SHARED_VALUES_REQUEST "dpf-shared-values"
+
+// javascript injected into every page for requesting the above
+#define WEB_VIEW_SHARED_VALUES_REQUEST_JS \
+    "window.addEventListener('load',function(){postMessage('" WEB_VIEW_SHARED_VALUES_REQUEST "')});"
+
 static void webview_wake(ipc_sem_t* const sem)
 {
    #ifdef __linux__
@@ -285,10 +303,10 @@ static void webview_wake(ipc_sem_t* const sem)
    #endif
 }
 
-static bool webview_timedwait(ipc_sem_t* const sem)
+static bool webview_timedwait(ipc_sem_t* const sem, const uint timeoutInMs = 1000)
 {
    #ifdef __linux__
-    const struct timespec timeout = { 1, 0 };
+    const struct timespec timeout = { timeoutInMs / 1000, static_cast<long>(timeoutInMs % 1000) * 1000000 };
     for (;;)
     {
         if (__sync_bool_compare_and_swap(sem, 1, 0))
@@ -302,7 +320,14 @@ static bool webview_timedwait(ipc_sem_t* const sem)
     if (clock_gettime(CLOCK_REALTIME, &timeout) != 0)
         return false;
 
-    timeout.tv_sec += 1;
+    timeout.tv_sec += timeoutInMs / 1000;
+    timeout.tv_nsec += static_cast<long>(timeoutInMs % 1000) * 1000000;
+
+    if (timeout.tv_nsec >= 1000000000)
+    {
+        timeout.tv_sec += 1;
+        timeout.tv_nsec -= 1000000000;
+    }
 
     for (int r;;)
     {
@@ -813,6 +838,29 @@ void webViewEvaluateJS(const WebViewHandle handle, const char* const js)
     (void)js;
 }
 
+bool webViewSetSharedValue(const WebViewHandle handle, const uint32_t index, const float value)
+{
+   #if WEB_VIEW_USING_X11_IPC
+    if (index >= WebViewSharedValues::size)
+        return false;
+
+    WebViewSharedValues& shared(handle->shmptr->values);
+
+    // only written from this side, so no need for compare-and-swap on count
+    __atomic_store(&shared.values[index], &value, __ATOMIC_RELAXED);
+    if (index >= shared.count)
+        __atomic_store_n(&shared.count, index + 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&shared.seq, 1, __ATOMIC_RELEASE);
+    return true;
+   #else
+    // unused
+    (void)handle;
+    (void)index;
+    (void)value;
+    return false;
+   #endif
+}
+
 void webViewReload(const WebViewHandle handle)
 {
    #if WEB_VIEW_USING_CHOC
@@ -948,6 +996,73 @@ struct QSize {
     S NAME = reinterpret_cast<S>(dlsym(nullptr, #SN)); \
     DISTRHO_SAFE_ASSERT_RETURN(NAME != nullptr, false);
 
+static struct WebSharedValuesState {
+    uint32_t seq, count, numChanged;
+    uint32_t changed[WebViewSharedValues::size];
+    float values[WebViewSharedValues::size];
+    char js[WebViewSharedValues::size * 32 + 128];
+} webSharedValues;
+
+// send shared values changed since last call to the web page, all in a single javascript call
+static void web_update_shared_values(WebViewRingBuffer* const shmptr)
+{
+    WebViewSharedValues& shared(shmptr->values);
+    WebSharedValuesState& state(webSharedValues);
+
+    const uint32_t seq = __atomic_load_n(&shared.seq, __ATOMIC_ACQUIRE);
+    if (seq == state.seq)
+        return;
+
+    state.seq = seq;
+    state.numChanged = 0;
+
+    uint32_t count = __atomic_load_n(&shared.count, __ATOMIC_RELAXED);
+    if (count > WebViewSharedValues::size)
+        count = WebViewSharedValues::size;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        float value;
+        __atomic_load(&shared.values[i], &value, __ATOMIC_RELAXED);
+
+        if (! std::isfinite(value))
+            value = 0.f;
+        if (i < state.count && d_isEqual(state.values[i], value))
+            continue;
+
+        state.values[i] = value;
+        state.changed[state.numChanged++] = i;
+    }
+
+    state.count = count;
+
+    if (state.numChanged == 0)
+        return;
+
+    char* js = state.js;
+    js += std::sprintf(js, "typeof(_dpfSharedValuesChanged) === 'function' && _dpfSharedValuesChanged([");
+
+    for (uint32_t i = 0; i < state.numChanged; ++i)
+        js += std::sprintf(js, i == 0 ? "%u" : ",%u", state.changed[i]);
+
+    js += std::sprintf(js, "],[");
+
+    for (uint32_t i = 0; i < state.numChanged; ++i)
+        js += std::sprintf(js, i == 0 ? "%.9g" : ",%.9g", static_cast<double>(state.values[state.changed[i]]));
+
+    std::strcpy(js, "])");
+
+    webFramework->evaluate(state.js);
+}
+
+// forget what was sent to the web page, resending all shared values
+static void web_resend_shared_values(WebViewRingBuffer* const shmptr)
+{
+    webSharedValues.seq = __atomic_load_n(&shmptr->values.seq, __ATOMIC_ACQUIRE) - 1;
+    webSharedValues.count = 0;
+    web_update_shared_values(shmptr);
+}
+
 static int web_wake_idle(void* const ptr)
 {
     WebViewRingBuffer* const shmptr = static_cast<WebViewRingBuffer*>(ptr);
@@ -996,6 +1111,8 @@ static int web_wake_idle(void* const ptr)
     }
 
     free(buffer);
+
+    web_update_shared_values(shmptr);
     return 0;
 }
 
@@ -1022,6 +1139,13 @@ static int gtk3_js_cb(WebKitUserContentManager*, WebKitJavascriptResult* const r
 
     d_debug("js call received with data '%s'", string);
 
+    if (std::strcmp(string, WEB_VIEW_SHARED_VALUES_REQUEST) == 0)
+    {
+        web_resend_shared_values(shmptr);
+        g_free(string);
+        return 0;
+    }
+
     const size_t len = std::strlen(string) + 1;
     RingBufferControl<WebViewSharedBuffer> rbctrl2;
     rbctrl2.setRingBuffer(&shmptr->server, false);
@@ -1173,7 +1297,8 @@ static bool gtk3(Display* const display,
         webkit_user_content_manager_register_script_message_handler(manager, "external");
 
         WebKitUserScript* const mscript = webkit_user_script_new(
-            "function postMessage(m){window.webkit.messageHandlers.external.postMessage(m)}", 0, 0, nullptr, nullptr);
+            "function postMessage(m){window.webkit.messageHandlers.external.postMessage(m)}"
+            WEB_VIEW_SHARED_VALUES_REQUEST_JS, 0, 0, nullptr, nullptr);
         webkit_user_content_manager_add_script(manager, mscript);
 
         if (initialJS != nullptr)
@@ -1442,13 +1567,20 @@ public:
 
         d_debug("js call received with data '%s'", value);
 
-        const size_t len = std::strlen(value) + 1;
-        RingBufferControl<WebViewSharedBuffer> rbctrl2;
-        rbctrl2.setRingBuffer(&_rb->server, false);
-        rbctrl2.writeUInt(kWebViewMessageCallback) &&
-        rbctrl2.writeUInt(len) &&
-        rbctrl2.writeCustomData(value, len);
-        rbctrl2.commitWrite();
+        if (std::strcmp(value, WEB_VIEW_SHARED_VALUES_REQUEST) == 0)
+        {
+            web_resend_shared_values(_rb);
+        }
+        else
+        {
+            const size_t len = std::strlen(value) + 1;
+            RingBufferControl<WebViewSharedBuffer> rbctrl2;
+            rbctrl2.setRingBuffer(&_rb->server, false);
+            rbctrl2.writeUInt(kWebViewMessageCallback) &&
+            rbctrl2.writeUInt(len) &&
+            rbctrl2.writeCustomData(value, len);
+            rbctrl2.commitWrite();
+        }
 
         // QByteArray and QString destructors are inlined and can't be called from here, call their next closest thing
         QByteArray_clear(&data);
@@ -1696,7 +1828,7 @@ static bool qtwebengine(const int qtVersion,
             \"object\": \"external\", \
             \"method\": \"sendMessage\",\
             \"args\":[{\"m\":m}], \
-        }));}";
+        }));}" WEB_VIEW_SHARED_VALUES_REQUEST_JS;
         const size_t mcode_len = std::strlen(mcode_src);
         ushort* const mcode_qchar = new ushort[mcode_len + 1];
 
@@ -1937,9 +2069,25 @@ static void* threadHandler(void* const ptr)
 {
     WebViewRingBuffer* const shmptr = static_cast<WebViewRingBuffer*>(ptr);
 
+    uint32_t seq = 0;
+
     while (running && shmptr->valid)
     {
-        if (webview_timedwait(&shmptr->client.sem) && running)
+        // poll shared values at animation-frame rate once in use, only waking up main thread on changes
+        const uint timeout = __atomic_load_n(&shmptr->values.count, __ATOMIC_RELAXED) != 0
+                           ? kWebViewSharedValuesPollInterval
+                           : 1000;
+
+        bool wake = webview_timedwait(&shmptr->client.sem, timeout);
+
+        const uint32_t newseq = __atomic_load_n(&shmptr->values.seq, __ATOMIC_ACQUIRE);
+        if (seq != newseq)
+        {
+            seq = newseq;
+            wake = true;
+        }
+
+        if (wake && running)
             webFramework->wake(shmptr);
     }
 
@@ -2067,6 +2215,9 @@ END_NAMESPACE_DISTRHO
 #undef MACRO_NAME
 #undef MACRO_NAME2
 
+#undef WEB_VIEW_SHARED_VALUES_REQUEST
+#undef WEB_VIEW_SHARED_VALUES_REQUEST_JS
+
 #undef WEB_VIEW_DISTRHO_NAMESPACE
 #undef WEB_VIEW_DGL_NAMESPACE
 #undef WEB_VIEW_NAMESPACE
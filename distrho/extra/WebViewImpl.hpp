@@ -114,6 +114,16 @@ void webViewIdle(WebViewHandle webview);
 */
 void webViewEvaluateJS(WebViewHandle webview, const char* js);
 
+/**
+  Set a value to be mirrored to the web view, without going through regular message passing.
+
+  Only the latest value per index is kept, changes are delivered to the web page at animation-frame rate
+  as a single `_dpfSharedValuesChanged(indexes, values)` JavaScript call.
+  Returns false if not supported by the current platform or if @p index is out of range,
+  in which case values need to be sent via webViewEvaluateJS().
+*/
+bool webViewSetSharedValue(WebViewHandle webview, uint32_t index, float value);
+
 /**
   Reload the web view current page.
 */
@@ -26,6 +26,7 @@ double      d_nextSampleRate = 0.0;
 const char* d_nextBundlePath = nullptr;
 bool        d_nextPluginIsDummy = false;
 bool        d_nextPluginIsSelfTest = false;
+bool        d_nextPluginIsMetadataOnly = false;
 bool        d_nextCanRequestParameterValueChanges = false;
 
 /* ------------------------------------------------------------------------------------------------------------
@@ -107,6 +108,11 @@ const char* Plugin::getBundlePath() const noexcept
     return pData->bundlePath;
 }
 
+bool Plugin::isOffline() const noexcept
+{
+    return pData->isOffline;
+}
+
 bool Plugin::isDummyInstance() const noexcept
 {
     return pData->isDummy;
@@ -124,6 +130,13 @@ const TimePosition& Plugin::getTimePosition() const noexcept
 }
 #endif
 
+#if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+uint32_t Plugin::getDroppedMidiEventCount() const noexcept
+{
+    return pData->midiEvents.getOverflowCount();
+}
+#endif
+
 #if DISTRHO_PLUGIN_WANT_LATENCY
 void Plugin::setLatency(const uint32_t frames) noexcept
 {
@@ -138,6 +151,13 @@ bool Plugin::writeMidiEvent(const MidiEvent& midiEvent) noexcept
 }
 #endif
 
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+void Plugin::requestParallelExecution(const uint32_t numTasks, const ParallelTaskFunc func, void* const userData) noexcept
+{
+    pData->requestParallelExecution(numTasks, func, userData);
+}
+#endif
+
 #if DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
 bool Plugin::canRequestParameterValueChanges() const noexcept
 {
@@ -229,6 +249,18 @@ void Plugin::initState(const uint32_t index, State& state)
 float Plugin::getParameterValue(uint32_t) const { return 0.0f; }
 void Plugin::setParameterValue(uint32_t, float) {}
 
+void Plugin::getParameterValues(const uint32_t* const indexes, float* const values, const uint32_t count) const
+{
+    for (uint32_t i=0; i < count; ++i)
+        values[i] = getParameterValue(indexes[i]);
+}
+
+void Plugin::setParameterValues(const uint32_t* const indexes, const float* const values, const uint32_t count)
+{
+    for (uint32_t i=0; i < count; ++i)
+        setParameterValue(indexes[i], values[i]);
+}
+
 #if DISTRHO_PLUGIN_WANT_PROGRAMS
 void Plugin::loadProgram(uint32_t) {}
 #endif
@@ -241,11 +273,80 @@ String Plugin::getState(const char*) const { return String(); }
 void Plugin::setState(const char*, const char*) {}
 #endif
 
+/* ------------------------------------------------------------------------------------------------------------
+ * Audio/MIDI Processing */
+
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+# if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+void Plugin::run(const double** const inputs, double** const outputs, const uint32_t frames,
+                 const MidiEvent* const midiEvents, const uint32_t midiEventCount)
+# else
+void Plugin::run(const double** const inputs, double** const outputs, const uint32_t frames)
+# endif
+{
+   #if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+    DISTRHO_SAFE_ASSERT_UINT2_RETURN(frames <= pData->bufferSize, frames, pData->bufferSize,);
+
+    float* buffer = pData->singlePrecisionBuffers;
+   #endif
+
+   #if DISTRHO_PLUGIN_NUM_INPUTS > 0
+    const float* inputs32[DISTRHO_PLUGIN_NUM_INPUTS];
+
+    for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i, buffer += pData->bufferSize)
+    {
+        if (inputs[i] == nullptr)
+        {
+            inputs32[i] = nullptr;
+            continue;
+        }
+
+        for (uint32_t j=0; j < frames; ++j)
+            buffer[j] = static_cast<float>(inputs[i][j]);
+
+        inputs32[i] = buffer;
+    }
+   #else
+    const float** const inputs32 = nullptr;
+    (void)inputs;
+   #endif
+
+   #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+    float* outputs32[DISTRHO_PLUGIN_NUM_OUTPUTS];
+
+    for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i, buffer += pData->bufferSize)
+        outputs32[i] = outputs[i] != nullptr ? buffer : nullptr;
+   #else
+    float** const outputs32 = nullptr;
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    run(inputs32, outputs32, frames, midiEvents, midiEventCount);
+   #else
+    run(inputs32, outputs32, frames);
+   #endif
+
+   #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+    for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+    {
+        if (outputs[i] == nullptr)
+            continue;
+
+        for (uint32_t j=0; j < frames; ++j)
+            outputs[i][j] = outputs32[i][j];
+    }
+   #else
+    (void)outputs;
+   #endif
+}
+#endif
+
 /* ------------------------------------------------------------------------------------------------------------
  * Callbacks (optional) */
 
 void Plugin::bufferSizeChanged(uint32_t) {}
 void Plugin::sampleRateChanged(double) {}
+void Plugin::processModeChanged(bool) {}
 void Plugin::ioChanged(uint16_t, uint16_t) {}
 
 // -----------------------------------------------------------------------------------------------------------
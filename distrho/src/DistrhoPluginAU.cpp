@@ -351,7 +351,7 @@ public:
           fBypassParameterIndex(UINT32_MAX),
           fResetParameterIndex(UINT32_MAX)
        #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        , fMidiEventCount(0)
+        , fMidiEvents(fPlugin.getMidiEventPool())
        #endif
        #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
         , fMidiOutputDataOffset(0)
@@ -371,10 +371,16 @@ public:
             fLastParameterValues = new float[fParameterCount];
             std::memset(fLastParameterValues, 0, sizeof(float) * fParameterCount);
 
+            fParameterChanges.setup(fParameterCount);
+            fOutputParameters.setup(fParameterCount);
+
             for (uint32_t i=0; i<fParameterCount; ++i)
             {
                 fLastParameterValues[i] = fPlugin.getParameterValue(i);
 
+                if (fPlugin.isParameterOutputOrTrigger(i))
+                    fOutputParameters.add(i);
+
                 switch (fPlugin.getParameterDesignation(i))
                 {
                 case kParameterDesignationNull:
@@ -395,10 +401,6 @@ public:
         fInputRenderCallback.inputProcRefCon = nullptr;
        #endif
 
-       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        std::memset(&fMidiEvents, 0, sizeof(fMidiEvents));
-       #endif
-
        #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
         if ((fMidiOutputPackets = static_cast<MIDIPacketList*>(std::malloc(kMIDIPacketListSize))) != nullptr)
             std::memset(fMidiOutputPackets, 0, kMIDIPacketListSize);
@@ -484,7 +486,7 @@ public:
        #endif
 
        #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        fMidiEventCount = 0;
+        fMidiEvents.clear();
        #endif
        #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
         fMidiOutputDataOffset = 0;
@@ -689,6 +691,13 @@ public:
             return kAudioUnitErr_InvalidProperty;
            #endif
 
+        case kAudioUnitProperty_OfflineRender:
+            DISTRHO_SAFE_ASSERT_UINT_RETURN(inScope == kAudioUnitScope_Global, inScope, kAudioUnitErr_InvalidScope);
+            DISTRHO_SAFE_ASSERT_UINT_RETURN(inElement == 0, inElement, kAudioUnitErr_InvalidElement);
+            outDataSize = sizeof(UInt32);
+            outWritable = true;
+            return noErr;
+
         case kAudioUnitProperty_PresentPreset:
             DISTRHO_SAFE_ASSERT_UINT_RETURN(inScope == kAudioUnitScope_Global, inScope, kAudioUnitErr_InvalidScope);
             DISTRHO_SAFE_ASSERT_UINT_RETURN(inElement == 0, inElement, kAudioUnitErr_InvalidElement);
@@ -1063,6 +1072,10 @@ public:
             return noErr;
        #endif
 
+        case kAudioUnitProperty_OfflineRender:
+            *static_cast<UInt32*>(outData) = fPlugin.isOffline() ? 1 : 0;
+            return noErr;
+
         case kAudioUnitProperty_PresentPreset:
            #if DISTRHO_PLUGIN_WANT_PROGRAMS
             if (fCurrentProgram >= 0)
@@ -1511,6 +1524,21 @@ public:
             // nothing to do
             return noErr;
 
+        case kAudioUnitProperty_OfflineRender:
+            DISTRHO_SAFE_ASSERT_UINT_RETURN(inScope == kAudioUnitScope_Global, inScope, kAudioUnitErr_InvalidScope);
+            DISTRHO_SAFE_ASSERT_UINT_RETURN(inElement == 0, inElement, kAudioUnitErr_InvalidElement);
+            DISTRHO_SAFE_ASSERT_UINT_RETURN(inDataSize == sizeof(UInt32), inDataSize, kAudioUnitErr_InvalidPropertyValue);
+            {
+                const bool offline = *static_cast<const UInt32*>(inData) != 0;
+
+                if (fPlugin.isOffline() != offline)
+                {
+                    fPlugin.setOffline(offline, true);
+                    notifyPropertyListeners(inProp, inScope, inElement);
+                }
+            }
+            return noErr;
+
         case kAudioUnitProperty_PresentPreset:
             DISTRHO_SAFE_ASSERT_UINT_RETURN(inScope == kAudioUnitScope_Global, inScope, kAudioUnitErr_InvalidScope);
             DISTRHO_SAFE_ASSERT_UINT_RETURN(inElement == 0, inElement, kAudioUnitErr_InvalidElement);
@@ -1861,7 +1889,7 @@ public:
         }
 
        #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        fMidiEventCount = 0;
+        fMidiEvents.clear();
        #endif
        #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
         fMidiOutputDataOffset = 0;
@@ -2084,14 +2112,15 @@ public:
                          const UInt32 inData2,
                          const UInt32 inOffsetSampleFrame)
     {
-        if (fMidiEventCount >= kMaxMidiEvents)
+        MidiEvent* const midiEvent = fMidiEvents.allocate();
+
+        if (midiEvent == nullptr)
             return noErr;
 
-        MidiEvent& midiEvent(fMidiEvents[fMidiEventCount++]);
-        midiEvent.frame   = inOffsetSampleFrame;
-        midiEvent.data[0] = inStatus;
-        midiEvent.data[1] = inData1;
-        midiEvent.data[2] = inData2;
+        midiEvent->frame   = inOffsetSampleFrame;
+        midiEvent->data[0] = inStatus;
+        midiEvent->data[1] = inData1;
+        midiEvent->data[2] = inData2;
 
         switch (inStatus & 0xF0)
         {
@@ -2100,11 +2129,11 @@ public:
         case 0xA0:
         case 0xB0:
         case 0xE0:
-            midiEvent.size = 3;
+            midiEvent->size = 3;
             break;
         case 0xC0:
         case 0xD0:
-            midiEvent.size = 2;
+            midiEvent->size = 2;
             break;
         case 0xF0:
             switch (inStatus & 0x0F)
@@ -2121,7 +2150,7 @@ public:
             case 0x2:
             case 0x3:
             case 0xE:
-                midiEvent.size = 3;
+                midiEvent->size = 3;
                 break;
             case 0x6:
             case 0x8:
@@ -2129,14 +2158,14 @@ public:
             case 0xB:
             case 0xC:
             case 0xF:
-                midiEvent.size = 1;
+                midiEvent->size = 1;
                 break;
             }
             break;
         default:
             // invalid
             d_debug("auMIDIEvent received invalid event %u %u %u %u @ %u",
-                    inStatus, inData1, inData2, inOffsetSampleFrame, fMidiEventCount);
+                    inStatus, inData1, inData2, inOffsetSampleFrame, fMidiEvents.getCount());
             return kAudioUnitErr_InvalidPropertyValue;
         }
 
@@ -2150,22 +2179,24 @@ public:
 
     OSStatus auSysEx(const UInt8* const inData, const UInt32 inLength)
     {
-        if (fMidiEventCount >= kMaxMidiEvents)
+        const uint32_t frame = fMidiEvents.getLastFrame();
+        MidiEvent* const midiEvent = fMidiEvents.allocate();
+
+        if (midiEvent == nullptr)
             return noErr;
 
-        MidiEvent& midiEvent(fMidiEvents[fMidiEventCount++]);
-        midiEvent.frame = fMidiEventCount != 1 ? fMidiEvents[fMidiEventCount - 1].frame : 0;
-        midiEvent.size  = inLength;
+        midiEvent->frame = frame;
+        midiEvent->size  = inLength;
 
         // FIXME who owns inData ??
         if (inLength > MidiEvent::kDataSize)
         {
-            std::memset(midiEvent.data, 0, MidiEvent::kDataSize);
-            midiEvent.dataExt = inData;
+            std::memset(midiEvent->data, 0, MidiEvent::kDataSize);
+            midiEvent->dataExt = inData;
         }
         else
         {
-            std::memcpy(midiEvent.data, inData, inLength);
+            std::memcpy(midiEvent->data, inData, inLength);
         }
 
        #if DISTRHO_PLUGIN_NUM_INPUTS + DISTRHO_PLUGIN_NUM_OUTPUTS == 0
@@ -2212,12 +2243,13 @@ private:
     // Caching
     const uint32_t fParameterCount;
     float* fLastParameterValues;
+    ParameterValueList fParameterChanges; // for batched state save and restore
+    ParameterValueList fOutputParameters; // fixed list of output and trigger parameters
     uint32_t fBypassParameterIndex;
     uint32_t fResetParameterIndex;
 
    #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-    uint32_t fMidiEventCount;
-    MidiEvent fMidiEvents[kMaxMidiEvents];
+    MidiEventPool& fMidiEvents;
     SmallStackRingBuffer fNotesRingBuffer;
    #endif
 
@@ -2277,22 +2309,24 @@ private:
     void run(const float** inputs, float** outputs, const uint32_t frames, const AudioTimeStamp* const inTimeStamp)
     {
        #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        if (fMidiEventCount != kMaxMidiEvents && fNotesRingBuffer.isDataAvailableForReading())
+        if (! fMidiEvents.isFull() && fNotesRingBuffer.isDataAvailableForReading())
         {
             uint8_t midiData[3];
-            const uint32_t frame = fMidiEventCount != 0 ? fMidiEvents[fMidiEventCount - 1].frame : 0;
+            const uint32_t frame = fMidiEvents.getLastFrame();
 
             while (fNotesRingBuffer.isDataAvailableForReading())
             {
                 if (! fNotesRingBuffer.readCustomData(midiData, 3))
                     break;
 
-                MidiEvent& midiEvent(fMidiEvents[fMidiEventCount++]);
-                midiEvent.frame = frame;
-                midiEvent.size  = 3;
-                std::memcpy(midiEvent.data, midiData, 3);
+                MidiEvent* const midiEvent = fMidiEvents.allocate();
+                DISTRHO_SAFE_ASSERT_BREAK(midiEvent != nullptr);
+
+                midiEvent->frame = frame;
+                midiEvent->size  = 3;
+                std::memcpy(midiEvent->data, midiData, 3);
 
-                if (fMidiEventCount == kMaxMidiEvents)
+                if (fMidiEvents.isFull())
                     break;
             }
         }
@@ -2370,8 +2404,8 @@ private:
        #endif
 
        #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        fPlugin.run(inputs, outputs, frames, fMidiEvents, fMidiEventCount);
-        fMidiEventCount = 0;
+        fPlugin.run(inputs, outputs, frames, fMidiEvents.getEvents(), fMidiEvents.getCount());
+        fMidiEvents.clear();
        #else
         fPlugin.run(inputs, outputs, frames);
        #endif
@@ -2395,22 +2429,22 @@ private:
         event.mArgument.mParameter.mAudioUnit = fComponent;
         event.mArgument.mParameter.mScope     = kAudioUnitScope_Global;
 
-        for (uint32_t i=0; i<fParameterCount; ++i)
+        fPlugin.getParameterValues(fOutputParameters);
+
+        for (uint32_t i=0, count=fOutputParameters.getCount(); i<count; ++i)
         {
-            if (fPlugin.isParameterOutputOrTrigger(i))
-            {
-                value = fPlugin.getParameterValue(i);
+            const uint32_t index = fOutputParameters.getIndex(i);
+            value = fOutputParameters.getValue(i);
 
-                if (d_isEqual(fLastParameterValues[i], value))
-                    continue;
+            if (d_isEqual(fLastParameterValues[index], value))
+                continue;
 
-                fLastParameterValues[i] = value;
+            fLastParameterValues[index] = value;
 
-                // TODO flag param only, notify listeners later on bg thread (sem_post etc)
-                event.mArgument.mParameter.mParameterID = i;
-                AUEventListenerNotify(NULL, NULL, &event);
-                notifyPropertyListeners('DPFp', kAudioUnitScope_Global, i);
-            }
+            // TODO flag param only, notify listeners later on bg thread (sem_post etc)
+            event.mArgument.mParameter.mParameterID = index;
+            AUEventListenerNotify(NULL, NULL, &event);
+            notifyPropertyListeners('DPFp', kAudioUnitScope_Global, index);
         }
     }
 
@@ -2559,20 +2593,9 @@ private:
                     const String& value(cit->second);
 
                    #if DISTRHO_PLUGIN_WANT_DIRECT_ACCESS && ! DISTRHO_PLUGIN_HAS_UI
-                    bool wantStateKey = true;
-
-                    for (uint32_t i=0; i<fStateCount; ++i)
-                    {
-                        if (fPlugin.getStateKey(i) == key)
-                        {
-                            if (fPlugin.getStateHints(i) & kStateIsOnlyForUI)
-                                wantStateKey = false;
-
-                            break;
-                        }
-                    }
-
-                    if (! wantStateKey)
+                    uint32_t stateIndex;
+                    if (fPlugin.getStateIndex(key, stateIndex) &&
+                        (fPlugin.getStateHints(stateIndex) & kStateIsOnlyForUI) != 0x0)
                         continue;
                    #endif
 
@@ -2603,15 +2626,23 @@ private:
                                                                          fParameterCount,
                                                                          &kCFTypeArrayCallBacks))
             {
+                // get all parameter values in a single call
+                fParameterChanges.clear();
+
                 for (uint32_t i=0; i<fParameterCount; ++i)
                 {
-                    if (fPlugin.isParameterOutputOrTrigger(i))
-                        continue;
+                    if (! fPlugin.isParameterOutputOrTrigger(i))
+                        fParameterChanges.add(i);
+                }
+
+                fPlugin.getParameterValues(fParameterChanges);
 
-                    const float value = fPlugin.getParameterValue(i);
+                for (uint32_t i=0, count=fParameterChanges.getCount(); i<count; ++i)
+                {
+                    const float value = fParameterChanges.getValue(i);
 
                     CFStringRef keyRef = CFStringCreateWithCString(nullptr,
-                                                                   fPlugin.getParameterSymbol(i),
+                                                                   fPlugin.getParameterSymbol(fParameterChanges.getIndex(i)),
                                                                    kCFStringEncodingASCII);
                     CFNumberRef valueRef = CFNumberCreate(nullptr, kCFNumberFloat32Type, &value);
 
@@ -2704,7 +2735,8 @@ private:
                 }
                 DISTRHO_SAFE_ASSERT_BREAK(CFStringGetCString(keyRef, key, keyLen + 1, kCFStringEncodingASCII));
 
-                if (! fPlugin.wantStateKey(key))
+                uint32_t stateIndex;
+                if (! fPlugin.getStateIndex(key, stateIndex))
                     continue;
 
                 const CFIndex valueRefLen = CFStringGetLength(valueRef);
@@ -2715,20 +2747,11 @@ private:
                 }
                 DISTRHO_SAFE_ASSERT_BREAK(CFStringGetCString(valueRef, value, valueLen + 1, kCFStringEncodingUTF8));
 
-                const String dkey(key);
-                fStateMap[dkey] = value;
+                fStateMap[fPlugin.getStateKey(stateIndex)] = value;
                 fPlugin.setState(key, value);
 
-                for (uint32_t j=0; j<fStateCount; ++j)
-                {
-                    if (fPlugin.getStateKey(j) == key)
-                    {
-                        if ((fPlugin.getStateHints(i) & kStateIsOnlyForDSP) == 0x0)
-                            notifyPropertyListeners('DPFs', kAudioUnitScope_Global, j);
-
-                        break;
-                    }
-                }
+                if ((fPlugin.getStateHints(stateIndex) & kStateIsOnlyForDSP) == 0x0)
+                    notifyPropertyListeners('DPFs', kAudioUnitScope_Global, stateIndex);
             }
 
             std::free(key);
@@ -2744,6 +2767,9 @@ private:
             char* symbol = nullptr;
             CFIndex symbolLen = -1;
 
+            // parameter values are collected and given to the plugin all at once at the end
+            fParameterChanges.clear();
+
             for (CFIndex i=0; i<numParams; ++i)
             {
                 const CFDictionaryRef param = static_cast<CFDictionaryRef>(CFArrayGetValueAtIndex(paramsRef, i));
@@ -2777,17 +2803,23 @@ private:
                         continue;
 
                     fLastParameterValues[j] = value;
-                    fPlugin.setParameterValue(j, value);
-                    notifyPropertyListeners('DPFp', kAudioUnitScope_Global, j);
-
-                    if (fBypassParameterIndex == j)
-                        notifyPropertyListeners(kAudioUnitProperty_BypassEffect, kAudioUnitScope_Global, 0);
-
+                    fParameterChanges.add(j, value);
                     break;
                 }
             }
 
             std::free(symbol);
+
+            fPlugin.setParameterValues(fParameterChanges);
+
+            for (uint32_t i=0, count=fParameterChanges.getCount(); i<count; ++i)
+            {
+                const uint32_t index = fParameterChanges.getIndex(i);
+                notifyPropertyListeners('DPFp', kAudioUnitScope_Global, index);
+
+                if (fBypassParameterIndex == index)
+                    notifyPropertyListeners(kAudioUnitProperty_BypassEffect, kAudioUnitScope_Global, 0);
+            }
         }
     }
 
@@ -2849,18 +2881,15 @@ private:
     {
         fPlugin.setState(key, newValue);
 
-        for (uint32_t i=0; i<fStateCount; ++i)
+        uint32_t index;
+        if (fPlugin.getStateIndex(key, index))
         {
-            if (fPlugin.getStateKey(i) == key)
-            {
-                const String dkey(key);
-                fStateMap[dkey] = newValue;
+            fStateMap[fPlugin.getStateKey(index)] = newValue;
 
-                if ((fPlugin.getStateHints(i) & kStateIsOnlyForDSP) == 0x0)
-                    notifyPropertyListeners('DPFs', kAudioUnitScope_Global, i);
+            if ((fPlugin.getStateHints(index) & kStateIsOnlyForDSP) == 0x0)
+                notifyPropertyListeners('DPFs', kAudioUnitScope_Global, index);
 
-                return true;
-            }
+            return true;
         }
 
         d_stderr("Failed to find plugin state with key \"%s\"", key);
@@ -0,0 +1,1039 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2025 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "DistrhoPluginInternal.hpp"
+#include "../extra/Time.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <new>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+# ifdef _MSC_VER
+#  include <intrin.h>
+# else
+#  include <x86intrin.h>
+# endif
+# define DISTRHO_BENCH_HAS_CYCLES 1
+#else
+# define DISTRHO_BENCH_HAS_CYCLES 0
+#endif
+
+#if defined(__cpp_aligned_new) && defined(_WIN32)
+# include <malloc.h>
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+// Allocation tracking, only counted while the plugin is processing
+
+static bool sTrackAllocations = false;
+static uint32_t sAllocationCount = 0;
+
+static inline
+void countAllocation() noexcept
+{
+    if (__atomic_load_n(&sTrackAllocations, __ATOMIC_RELAXED))
+        __atomic_add_fetch(&sAllocationCount, 1, __ATOMIC_RELAXED);
+}
+
+#ifdef __GLIBC__
+// catch C allocations too, forwarding to the regular glibc allocator
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void* __libc_valloc(size_t);
+void* __libc_pvalloc(size_t);
+void __libc_free(void*);
+
+void* malloc(const size_t size)
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(const size_t count, const size_t size)
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* const ptr, const size_t size)
+{
+    countAllocation();
+    return __libc_realloc(ptr, size);
+}
+
+static inline
+bool isValidAlignment(const size_t alignment) noexcept
+{
+    return alignment != 0 && (alignment & (alignment - 1)) == 0;
+}
+
+// libstdc++ implements the C++17 aligned operator new on top of aligned_alloc, so it is counted here too
+void* aligned_alloc(const size_t alignment, const size_t size)
+{
+    if (! isValidAlignment(alignment))
+    {
+        errno = EINVAL;
+        return nullptr;
+    }
+
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+void* memalign(const size_t alignment, const size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** const ptr, const size_t alignment, const size_t size)
+{
+    if (! isValidAlignment(alignment) || alignment % sizeof(void*) != 0)
+        return EINVAL;
+
+    countAllocation();
+
+    void* const mem = __libc_memalign(alignment, size);
+    if (mem == nullptr)
+        return ENOMEM;
+
+    *ptr = mem;
+    return 0;
+}
+
+void* valloc(const size_t size)
+{
+    countAllocation();
+    return __libc_valloc(size);
+}
+
+void* pvalloc(const size_t size)
+{
+    countAllocation();
+    return __libc_pvalloc(size);
+}
+
+void free(void* const ptr)
+{
+    __libc_free(ptr);
+}
+}
+#endif
+
+void* operator new(const std::size_t size)
+{
+   #ifndef __GLIBC__
+    countAllocation();
+   #endif
+
+    if (void* const ptr = std::malloc(size != 0 ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* const ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* const ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* const ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* const ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#ifdef __cpp_aligned_new
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+   #ifndef __GLIBC__
+    countAllocation();
+   #endif
+
+    const std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+
+   #ifdef _WIN32
+    if (void* const ptr = _aligned_malloc(size != 0 ? size : 1, align))
+        return ptr;
+   #else
+    void* ptr;
+    if (posix_memalign(&ptr, align, size != 0 ? size : 1) == 0)
+        return ptr;
+   #endif
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* const ptr, std::align_val_t) noexcept
+{
+   #ifdef _WIN32
+    _aligned_free(ptr);
+   #else
+    std::free(ptr);
+   #endif
+}
+
+void operator delete[](void* const ptr, const std::align_val_t alignment) noexcept
+{
+    operator delete(ptr, alignment);
+}
+
+void operator delete(void* const ptr, std::size_t, const std::align_val_t alignment) noexcept
+{
+    operator delete(ptr, alignment);
+}
+
+void operator delete[](void* const ptr, std::size_t, const std::align_val_t alignment) noexcept
+{
+    operator delete(ptr, alignment);
+}
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#if ! DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+static constexpr const writeMidiFunc writeMidiCallback = nullptr;
+#endif
+#if ! DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
+static constexpr const requestParameterValueChangeFunc requestParameterValueChangeCallback = nullptr;
+#endif
+#if ! DISTRHO_PLUGIN_WANT_STATE
+static const updateStateValueFunc updateStateValueCallback = nullptr;
+#endif
+
+static constexpr const uint32_t kNumInputs = DISTRHO_PLUGIN_NUM_INPUTS > 0 ? DISTRHO_PLUGIN_NUM_INPUTS : 1;
+static constexpr const uint32_t kNumOutputs = DISTRHO_PLUGIN_NUM_OUTPUTS > 0 ? DISTRHO_PLUGIN_NUM_OUTPUTS : 1;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+enum BenchSignal {
+    kBenchSignalSilence,
+    kBenchSignalNoise,
+    kBenchSignalSine
+};
+
+struct BenchParameter {
+    String name;
+    float value;
+    float rate;
+};
+
+struct BenchOptions {
+    uint32_t bufferSize;
+    double sampleRate;
+    double duration;
+    uint32_t warmupBlocks;
+    BenchSignal signal;
+    const char* inputFile;
+    double midiNoteRate;
+    bool failOnAllocations;
+    std::vector<BenchParameter> parameters;
+    std::vector<BenchParameter> automation;
+
+    BenchOptions()
+        : bufferSize(512),
+          sampleRate(48000.0),
+          duration(10.0),
+          warmupBlocks(16),
+          signal(kBenchSignalNoise),
+          inputFile(nullptr),
+          midiNoteRate(0.0),
+          failOnAllocations(false),
+          parameters(),
+          automation() {}
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// Audio input, either synthetic or from a WAV file (looped)
+
+static uint16_t readLE16(const uint8_t* const data) noexcept
+{
+    return static_cast<uint16_t>(data[0] | data[1] << 8);
+}
+
+static uint32_t readLE32(const uint8_t* const data) noexcept
+{
+    return static_cast<uint32_t>(data[0] | data[1] << 8 | data[2] << 16) | static_cast<uint32_t>(data[3]) << 24;
+}
+
+static bool loadWaveFile(const char* const filename, std::vector<std::vector<float> >& channels, double& sampleRate)
+{
+    FILE* const file = std::fopen(filename, "rb");
+    if (file == nullptr)
+    {
+        d_stderr("Failed to open '%s'", filename);
+        return false;
+    }
+
+    std::vector<uint8_t> contents;
+    {
+        uint8_t buffer[4096];
+        while (const size_t r = std::fread(buffer, 1, sizeof(buffer), file))
+            contents.insert(contents.end(), buffer, buffer + r);
+        std::fclose(file);
+    }
+
+    if (contents.size() < 12 || std::memcmp(contents.data(), "RIFF", 4) != 0 || std::memcmp(contents.data() + 8, "WAVE", 4) != 0)
+    {
+        d_stderr("'%s' is not a WAV file", filename);
+        return false;
+    }
+
+    uint16_t format = 0, numChannels = 0, bitsPerSample = 0;
+    const uint8_t* samples = nullptr;
+    uint32_t samplesSize = 0;
+
+    for (size_t offset = 12; offset + 8 <= contents.size();)
+    {
+        const uint8_t* const chunk = contents.data() + offset;
+        const uint32_t chunkSize = std::min<size_t>(readLE32(chunk + 4), contents.size() - offset - 8);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16)
+        {
+            format = readLE16(chunk + 8);
+            numChannels = readLE16(chunk + 10);
+            sampleRate = readLE32(chunk + 12);
+            bitsPerSample = readLE16(chunk + 22);
+
+            // WAVE_FORMAT_EXTENSIBLE, format is in the sub-format GUID
+            if (format == 0xfffe && chunkSize >= 26)
+                format = readLE16(chunk + 32);
+        }
+        else if (std::memcmp(chunk, "data", 4) == 0)
+        {
+            samples = chunk + 8;
+            samplesSize = chunkSize;
+        }
+
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    const bool isFloat = format == 3 && bitsPerSample == 32;
+    const bool isInteger = format == 1 && (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+
+    if (samples == nullptr || numChannels == 0 || (! isFloat && ! isInteger))
+    {
+        d_stderr("'%s' has an unsupported format, only 16/24/32-bit integer and 32-bit float are supported", filename);
+        return false;
+    }
+
+    const uint32_t bytesPerSample = bitsPerSample / 8;
+    const uint32_t numFrames = samplesSize / (bytesPerSample * numChannels);
+
+    if (numFrames == 0)
+    {
+        d_stderr("'%s' has no audio", filename);
+        return false;
+    }
+
+    channels.resize(numChannels);
+    for (uint16_t c = 0; c < numChannels; ++c)
+        channels[c].resize(numFrames);
+
+    for (uint32_t i = 0; i < numFrames; ++i)
+    {
+        for (uint16_t c = 0; c < numChannels; ++c)
+        {
+            const uint8_t* const sample = samples + (i * numChannels + c) * bytesPerSample;
+            float value;
+
+            if (isFloat)
+            {
+                const uint32_t bits = readLE32(sample);
+                std::memcpy(&value, &bits, sizeof(float));
+            }
+            else if (bitsPerSample == 16)
+            {
+                value = static_cast<int16_t>(readLE16(sample)) / 32768.f;
+            }
+            else if (bitsPerSample == 24)
+            {
+                value = static_cast<int32_t>(readLE32(sample - 1) & 0xffffff00) / 2147483648.f;
+            }
+            else
+            {
+                value = static_cast<int32_t>(readLE32(sample)) / 2147483648.f;
+            }
+
+            channels[c][i] = value;
+        }
+    }
+
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+ * Headless benchmark host, runs the plugin DSP as fast as possible and reports on its cost.
+ */
+class PluginBench
+{
+public:
+    PluginBench(const BenchOptions& options)
+        : fPlugin(this,
+                  writeMidiCallback,
+                  requestParameterValueChangeCallback,
+                  updateStateValueCallback),
+          fOptions(options),
+          fAutomation(),
+          fFileChannels(),
+          fFilePosition(0),
+          fNoiseState(0x12345678),
+          fSinePhase(0.0),
+         #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+          fMidiNoteCount(0),
+          fMidiNextTime(0.0),
+          fMidiNoteOn(false),
+         #endif
+          fFrame(0)
+    {
+    }
+
+    bool init()
+    {
+        for (size_t i = 0; i < fOptions.parameters.size(); ++i)
+        {
+            const BenchParameter& param(fOptions.parameters[i]);
+            uint32_t index;
+
+            if (! findParameter(param.name, index))
+                return false;
+
+            fPlugin.setParameterValue(index, fPlugin.getParameterRanges(index).getFixedValue(param.value));
+        }
+
+        for (size_t i = 0; i < fOptions.automation.size(); ++i)
+        {
+            const BenchParameter& param(fOptions.automation[i]);
+            Automation automation;
+
+            if (! findParameter(param.name, automation.index))
+                return false;
+
+            automation.rate = param.rate;
+            fAutomation.push_back(automation);
+        }
+
+        if (fOptions.inputFile != nullptr)
+        {
+            double fileSampleRate = 0.0;
+            if (! loadWaveFile(fOptions.inputFile, fFileChannels, fileSampleRate))
+                return false;
+
+            if (d_isNotEqual(fileSampleRate, fOptions.sampleRate))
+                d_stderr("Warning: '%s' sample rate is %.0f Hz, but processing at %.0f Hz without resampling",
+                         fOptions.inputFile, fileSampleRate, fOptions.sampleRate);
+        }
+
+       #if ! DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        if (fOptions.midiNoteRate > 0.0)
+            d_stderr("Warning: plugin does not take MIDI input, ignoring MIDI notes");
+       #endif
+
+        return true;
+    }
+
+    int run()
+    {
+        const uint32_t bufferSize = fOptions.bufferSize;
+        const uint32_t numBlocks = std::max<uint32_t>(1, static_cast<uint32_t>(fOptions.duration * fOptions.sampleRate / bufferSize));
+
+        // all buffers are allocated here, so that nothing is allocated by the host during processing
+        std::vector<float> inputBuffers(kNumInputs * bufferSize);
+        std::vector<float> outputBuffers(kNumOutputs * bufferSize);
+        const float* inputs[kNumInputs];
+        float* outputs[kNumOutputs];
+
+        for (uint32_t i = 0; i < kNumInputs; ++i)
+            inputs[i] = inputBuffers.data() + i * bufferSize;
+        for (uint32_t i = 0; i < kNumOutputs; ++i)
+            outputs[i] = outputBuffers.data() + i * bufferSize;
+
+        std::vector<uint64_t> blockTimes(numBlocks);
+        uint64_t totalCycles = 0;
+
+        fPlugin.activate();
+
+        for (uint32_t b = 0, warmup = fOptions.warmupBlocks; b < numBlocks + warmup; ++b)
+        {
+            const bool measuring = b >= warmup;
+
+            prepareInputs(inputBuffers.data());
+            prepareMidi();
+           #if DISTRHO_PLUGIN_WANT_TIMEPOS
+            prepareTimePosition();
+           #endif
+
+            __atomic_store_n(&sTrackAllocations, measuring, __ATOMIC_RELAXED);
+
+           #if DISTRHO_BENCH_HAS_CYCLES
+            const uint64_t c1 = __rdtsc();
+           #endif
+            const uint64_t t1 = d_gettime_ns();
+
+            // parameter changes are part of the plugin cost, same as a host applying automation
+            runAutomation();
+
+           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+            const MidiEventPool& midiEvents(fPlugin.getMidiEventPool());
+            fPlugin.run(inputs, outputs, bufferSize, midiEvents.getEvents(), midiEvents.getCount());
+           #else
+            fPlugin.run(inputs, outputs, bufferSize);
+           #endif
+
+            const uint64_t t2 = d_gettime_ns();
+           #if DISTRHO_BENCH_HAS_CYCLES
+            const uint64_t c2 = __rdtsc();
+           #endif
+
+            __atomic_store_n(&sTrackAllocations, false, __ATOMIC_RELAXED);
+
+            if (measuring)
+            {
+                blockTimes[b - warmup] = t2 - t1;
+               #if DISTRHO_BENCH_HAS_CYCLES
+                totalCycles += c2 - c1;
+               #endif
+            }
+
+            fFrame += bufferSize;
+        }
+
+        fPlugin.deactivate();
+
+        report(blockTimes, totalCycles);
+
+        if (fOptions.failOnAllocations && sAllocationCount != 0)
+        {
+            d_stderr("Memory was allocated during processing, failing as requested");
+            return 1;
+        }
+
+        return 0;
+    }
+
+private:
+    struct Automation {
+        uint32_t index;
+        float rate;
+    };
+
+    // Plugin
+    PluginExporter fPlugin;
+
+    // Options
+    const BenchOptions& fOptions;
+    std::vector<Automation> fAutomation;
+
+    // Audio input
+    std::vector<std::vector<float> > fFileChannels;
+    uint32_t fFilePosition;
+    uint32_t fNoiseState;
+    double fSinePhase;
+
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    // MIDI input, events go into the plugin pool, same as in the plugin formats
+    uint32_t fMidiNoteCount;
+    double fMidiNextTime;
+    bool fMidiNoteOn;
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_TIMEPOS
+    TimePosition fTimePosition;
+   #endif
+
+    uint64_t fFrame;
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    // find a parameter by index or symbol
+    bool findParameter(const String& name, uint32_t& index) const
+    {
+        const uint32_t count = fPlugin.getParameterCount();
+        char* end = nullptr;
+        const ulong value = std::strtoul(name, &end, 10);
+
+        if (end != nullptr && end != name.buffer() && *end == '\0' && value < count)
+        {
+            index = static_cast<uint32_t>(value);
+        }
+        else
+        {
+            for (index = 0; index < count; ++index)
+            {
+                if (fPlugin.getParameterSymbol(index) == name)
+                    break;
+            }
+
+            if (index == count)
+            {
+                d_stderr("Unknown parameter '%s'", name.buffer());
+                return false;
+            }
+        }
+
+        if (! fPlugin.isParameterInput(index))
+        {
+            d_stderr("Parameter '%s' is not an input", name.buffer());
+            return false;
+        }
+
+        return true;
+    }
+
+    void prepareInputs(float* const buffers)
+    {
+        const uint32_t bufferSize = fOptions.bufferSize;
+
+        if (! fFileChannels.empty())
+        {
+            const uint32_t numFileChannels = static_cast<uint32_t>(fFileChannels.size());
+            const uint32_t numFileFrames = static_cast<uint32_t>(fFileChannels[0].size());
+
+            for (uint32_t i = 0; i < bufferSize; ++i)
+            {
+                for (uint32_t c = 0; c < kNumInputs; ++c)
+                    buffers[c * bufferSize + i] = fFileChannels[c % numFileChannels][fFilePosition];
+
+                if (++fFilePosition == numFileFrames)
+                    fFilePosition = 0;
+            }
+            return;
+        }
+
+        switch (fOptions.signal)
+        {
+        case kBenchSignalSilence:
+            std::memset(buffers, 0, sizeof(float) * kNumInputs * bufferSize);
+            break;
+
+        case kBenchSignalNoise:
+            for (uint32_t i = 0; i < kNumInputs * bufferSize; ++i)
+            {
+                // xorshift32, fast and good enough for test noise
+                fNoiseState ^= fNoiseState << 13;
+                fNoiseState ^= fNoiseState >> 17;
+                fNoiseState ^= fNoiseState << 5;
+                buffers[i] = static_cast<float>(fNoiseState) / 2147483648.f - 1.f;
+            }
+            break;
+
+        case kBenchSignalSine:
+            for (uint32_t i = 0; i < bufferSize; ++i)
+            {
+                const float value = static_cast<float>(std::sin(fSinePhase)) * 0.5f;
+
+                for (uint32_t c = 0; c < kNumInputs; ++c)
+                    buffers[c * bufferSize + i] = value;
+
+                fSinePhase += 2.0 * M_PI * 440.0 / fOptions.sampleRate;
+                if (fSinePhase >= 2.0 * M_PI)
+                    fSinePhase -= 2.0 * M_PI;
+            }
+            break;
+        }
+    }
+
+    // sweep automated parameters over their full range
+    void runAutomation()
+    {
+        const double time = static_cast<double>(fFrame) / fOptions.sampleRate;
+
+        for (size_t i = 0; i < fAutomation.size(); ++i)
+        {
+            const Automation& automation(fAutomation[i]);
+            const uint32_t hints = fPlugin.getParameterHints(automation.index);
+            const ParameterRanges& ranges(fPlugin.getParameterRanges(automation.index));
+
+            const float normalized = 0.5f - 0.5f * static_cast<float>(std::cos(2.0 * M_PI * automation.rate * time));
+            float value = ranges.getUnnormalizedValue(normalized);
+
+            if (hints & kParameterIsBoolean)
+                value = normalized >= 0.5f ? ranges.max : ranges.min;
+            else if (hints & kParameterIsInteger)
+                value = std::round(value);
+
+            fPlugin.setParameterValue(automation.index, value);
+        }
+    }
+
+    // generate notes at a regular rate, each lasting half of the time until the next one
+    // notes that do not fit in the pool are dropped and counted, but keep their timing
+    void prepareMidi()
+    {
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        MidiEventPool& midiEvents(fPlugin.getMidiEventPool());
+        midiEvents.clear();
+
+        if (fOptions.midiNoteRate <= 0.0)
+            return;
+
+        const double halfPeriod = fOptions.sampleRate / fOptions.midiNoteRate / 2.0;
+        const double blockEnd = static_cast<double>(fFrame + fOptions.bufferSize);
+
+        while (fMidiNextTime < blockEnd)
+        {
+            const uint8_t note = static_cast<uint8_t>(36 + (fMidiNoteCount * 7) % 48);
+
+            if (MidiEvent* const event = midiEvents.allocate())
+            {
+                event->frame = static_cast<uint32_t>(std::max(0.0, fMidiNextTime - static_cast<double>(fFrame)));
+                event->size = 3;
+                event->data[0] = fMidiNoteOn ? 0x80 : 0x90;
+                event->data[1] = note;
+                event->data[2] = fMidiNoteOn ? 0 : 100;
+                event->data[3] = 0;
+                event->dataExt = nullptr;
+            }
+
+            if (fMidiNoteOn)
+                ++fMidiNoteCount;
+
+            fMidiNoteOn = ! fMidiNoteOn;
+            fMidiNextTime += halfPeriod;
+        }
+       #endif
+    }
+
+   #if DISTRHO_PLUGIN_WANT_TIMEPOS
+    // always playing at 120 BPM in 4/4
+    void prepareTimePosition()
+    {
+        static constexpr const double kBeatsPerMinute = 120.0;
+        static constexpr const double kTicksPerBeat = 1920.0;
+
+        const double beats = static_cast<double>(fFrame) / fOptions.sampleRate * kBeatsPerMinute / 60.0;
+        const double ticks = beats * kTicksPerBeat;
+
+        fTimePosition.playing = true;
+        fTimePosition.frame = fFrame;
+        fTimePosition.bbt.valid = true;
+        fTimePosition.bbt.bar = static_cast<int32_t>(beats / 4.0) + 1;
+        fTimePosition.bbt.beat = static_cast<int32_t>(std::fmod(beats, 4.0)) + 1;
+        fTimePosition.bbt.tick = std::fmod(ticks, kTicksPerBeat);
+        fTimePosition.bbt.barStartTick = (fTimePosition.bbt.bar - 1) * 4 * kTicksPerBeat;
+        fTimePosition.bbt.beatsPerBar = 4.f;
+        fTimePosition.bbt.beatType = 4.f;
+        fTimePosition.bbt.ticksPerBeat = kTicksPerBeat;
+        fTimePosition.bbt.beatsPerMinute = kBeatsPerMinute;
+
+        fPlugin.setTimePosition(fTimePosition);
+    }
+   #endif
+
+    void report(std::vector<uint64_t>& blockTimes, const uint64_t totalCycles) const
+    {
+        const size_t numBlocks = blockTimes.size();
+        const double numSamples = static_cast<double>(numBlocks) * fOptions.bufferSize;
+        const double blockDuration = fOptions.bufferSize / fOptions.sampleRate * 1000000000.0;
+
+        uint64_t total = 0;
+        for (size_t i = 0; i < numBlocks; ++i)
+            total += blockTimes[i];
+
+        std::sort(blockTimes.begin(), blockTimes.end());
+
+        const double mean = static_cast<double>(total) / numBlocks;
+        const double p50 = percentile(blockTimes, 50.0);
+        const double p90 = percentile(blockTimes, 90.0);
+        const double p99 = percentile(blockTimes, 99.0);
+        const double p999 = percentile(blockTimes, 99.9);
+
+        std::printf("plugin: %s (%s) by %s\n", fPlugin.getName(), fPlugin.getLabel(), fPlugin.getMaker());
+        std::printf("sample rate: %.0f Hz\n", fOptions.sampleRate);
+        std::printf("buffer size: %u frames\n", fOptions.bufferSize);
+        std::printf("blocks: %lu (after %u warm-up blocks)\n", static_cast<ulong>(numBlocks), fOptions.warmupBlocks);
+       #if DISTRHO_PLUGIN_WANT_LATENCY
+        std::printf("latency: %u frames\n", fPlugin.getLatency());
+       #endif
+        std::printf("block time min: %.3f us\n", blockTimes.front() / 1000.0);
+        std::printf("block time mean: %.3f us\n", mean / 1000.0);
+        std::printf("block time p50: %.3f us\n", p50 / 1000.0);
+        std::printf("block time p90: %.3f us\n", p90 / 1000.0);
+        std::printf("block time p99: %.3f us\n", p99 / 1000.0);
+        std::printf("block time p99.9: %.3f us\n", p999 / 1000.0);
+        std::printf("block time max: %.3f us\n", blockTimes.back() / 1000.0);
+        std::printf("realtime load mean: %.2f %%\n", mean / blockDuration * 100.0);
+        std::printf("realtime load p99: %.2f %%\n", p99 / blockDuration * 100.0);
+        std::printf("time per sample: %.3f ns\n", static_cast<double>(total) / numSamples);
+       #if DISTRHO_BENCH_HAS_CYCLES
+        std::printf("cycles per sample: %.2f\n", static_cast<double>(totalCycles) / numSamples);
+       #else
+        // unused
+        (void)totalCycles;
+       #endif
+        std::printf("allocations during processing: %u\n", sAllocationCount);
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        std::printf("dropped MIDI events: %u\n", fPlugin.getDroppedMidiEventCount());
+       #endif
+    }
+
+    static double percentile(const std::vector<uint64_t>& sorted, const double p) noexcept
+    {
+        const double pos = p / 100.0 * static_cast<double>(sorted.size() - 1);
+        const size_t index = static_cast<size_t>(pos);
+
+        if (index + 1 >= sorted.size())
+            return static_cast<double>(sorted.back());
+
+        const double frac = pos - static_cast<double>(index);
+        return static_cast<double>(sorted[index]) * (1.0 - frac) + static_cast<double>(sorted[index + 1]) * frac;
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // DPF callbacks
+
+   #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+    bool writeMidi(const MidiEvent&)
+    {
+        return true;
+    }
+
+    static bool writeMidiCallback(void* const ptr, const MidiEvent& midiEvent)
+    {
+        return ((PluginBench*)ptr)->writeMidi(midiEvent);
+    }
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
+    bool requestParameterValueChange(uint32_t, float)
+    {
+        return true;
+    }
+
+    static bool requestParameterValueChangeCallback(void* const ptr, const uint32_t index, const float value)
+    {
+        return ((PluginBench*)ptr)->requestParameterValueChange(index, value);
+    }
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_STATE
+    bool updateState(const char*, const char*)
+    {
+        return true;
+    }
+
+    static bool updateStateValueCallback(void* const ptr, const char* const key, const char* const value)
+    {
+        return ((PluginBench*)ptr)->updateState(key, value);
+    }
+   #endif
+
+    DISTRHO_DECLARE_NON_COPYABLE(PluginBench)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static void printUsage(const char* const name)
+{
+    std::printf("Usage: %s [options]\n"
+                "Process audio through " DISTRHO_PLUGIN_NAME " as fast as possible and report on its DSP cost.\n"
+                "\n"
+                "  -b, --buffer-size <frames>    audio block size (default 512)\n"
+                "  -r, --sample-rate <hz>        sample rate (default 48000)\n"
+                "  -d, --duration <seconds>      amount of audio to process (default 10)\n"
+                "  -w, --warmup <blocks>         blocks to process before measuring (default 16)\n"
+                "  -s, --signal <type>           synthetic input: silence, noise or sine (default noise)\n"
+                "  -i, --input <file.wav>        use audio from a WAV file as input, looped\n"
+                "  -p, --parameter <p>=<value>   set a parameter, by index or symbol, before processing\n"
+                "  -a, --automate <p>[:<hz>]     sweep a parameter over its range at a rate (default 1 Hz)\n"
+               #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                "  -m, --midi <notes/s>          send MIDI notes at a regular rate (default 0, no notes)\n"
+               #endif
+                "      --fail-on-alloc           exit with an error if memory is allocated during processing\n"
+                "  -h, --help                    show this help and exit\n"
+                "\n"
+                "Parameter and automation options can be repeated.\n"
+               #ifdef __GLIBC__
+                "Allocations are counted through C++ new and the malloc family, including its aligned variants.\n"
+               #else
+                "Allocations are only counted through C++ new, direct calls to malloc and friends are not seen.\n"
+               #endif
+                , name);
+}
+
+static bool parseParameter(const char* const arg, const char separator, const float fallback, BenchParameter& param)
+{
+    const char* const sep = std::strchr(arg, separator);
+
+    if (sep == nullptr)
+    {
+        if (separator == '=')
+            return false;
+
+        param.name = arg;
+        param.value = param.rate = fallback;
+        return true;
+    }
+
+    param.name = String(arg).truncate(static_cast<size_t>(sep - arg));
+    param.value = param.rate = static_cast<float>(std::atof(sep + 1));
+    return param.name.isNotEmpty();
+}
+
+END_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    USE_NAMESPACE_DISTRHO;
+
+    BenchOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* const arg = argv[i];
+        const char* const value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        #define DISTRHO_BENCH_ARG(s, l) (std::strcmp(arg, s) == 0 || std::strcmp(arg, l) == 0)
+
+        if (DISTRHO_BENCH_ARG("-h", "--help"))
+        {
+            printUsage(argv[0]);
+            return 0;
+        }
+
+        if (std::strcmp(arg, "--fail-on-alloc") == 0)
+        {
+            options.failOnAllocations = true;
+            continue;
+        }
+
+        if (value == nullptr)
+        {
+            d_stderr("Missing value for '%s'", arg);
+            return 1;
+        }
+
+        ++i;
+
+        if (DISTRHO_BENCH_ARG("-b", "--buffer-size"))
+        {
+            options.bufferSize = static_cast<uint32_t>(std::atoi(value));
+        }
+        else if (DISTRHO_BENCH_ARG("-r", "--sample-rate"))
+        {
+            options.sampleRate = std::atof(value);
+        }
+        else if (DISTRHO_BENCH_ARG("-d", "--duration"))
+        {
+            options.duration = std::atof(value);
+        }
+        else if (DISTRHO_BENCH_ARG("-w", "--warmup"))
+        {
+            options.warmupBlocks = static_cast<uint32_t>(std::atoi(value));
+        }
+        else if (DISTRHO_BENCH_ARG("-s", "--signal"))
+        {
+            if (std::strcmp(value, "silence") == 0)
+                options.signal = kBenchSignalSilence;
+            else if (std::strcmp(value, "noise") == 0)
+                options.signal = kBenchSignalNoise;
+            else if (std::strcmp(value, "sine") == 0)
+                options.signal = kBenchSignalSine;
+            else
+            {
+                d_stderr("Unknown signal type '%s'", value);
+                return 1;
+            }
+        }
+        else if (DISTRHO_BENCH_ARG("-i", "--input"))
+        {
+            options.inputFile = value;
+        }
+        else if (DISTRHO_BENCH_ARG("-p", "--parameter"))
+        {
+            BenchParameter param;
+            if (! parseParameter(value, '=', 0.f, param))
+            {
+                d_stderr("Invalid parameter '%s', format is <index or symbol>=<value>", value);
+                return 1;
+            }
+            options.parameters.push_back(param);
+        }
+        else if (DISTRHO_BENCH_ARG("-a", "--automate"))
+        {
+            BenchParameter param;
+            if (! parseParameter(value, ':', 1.f, param))
+            {
+                d_stderr("Invalid automation '%s', format is <index or symbol>[:<rate>]", value);
+                return 1;
+            }
+            options.automation.push_back(param);
+        }
+        else if (DISTRHO_BENCH_ARG("-m", "--midi"))
+        {
+            options.midiNoteRate = std::atof(value);
+        }
+        else
+        {
+            d_stderr("Unknown option '%s', see --help", arg);
+            return 1;
+        }
+
+        #undef DISTRHO_BENCH_ARG
+    }
+
+    if (options.bufferSize == 0 || options.sampleRate <= 0.0 || options.duration <= 0.0)
+    {
+        d_stderr("Invalid buffer size, sample rate or duration");
+        return 1;
+    }
+
+    d_nextBufferSize = options.bufferSize;
+    d_nextSampleRate = options.sampleRate;
+
+    PluginBench bench(options);
+
+    d_nextBufferSize = 0;
+    d_nextSampleRate = 0.0;
+
+    if (! bench.init())
+        return 1;
+
+    return bench.run();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
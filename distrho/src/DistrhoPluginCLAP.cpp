@@ -23,6 +23,7 @@
  */
 
 #include "DistrhoPluginInternal.hpp"
+#include "DistrhoPluginState.hpp"
 #include "extra/ScopedPointer.hpp"
 
 #ifndef DISTRHO_PLUGIN_CLAP_ID
@@ -53,8 +54,10 @@
 #include "clap/ext/gui.h"
 #include "clap/ext/note-ports.h"
 #include "clap/ext/params.h"
+#include "clap/ext/render.h"
 #include "clap/ext/state.h"
 #include "clap/ext/thread-check.h"
+#include "clap/ext/thread-pool.h"
 #include "clap/ext/timer-support.h"
 
 #if defined(DISTRHO_OS_MAC) || defined(DISTRHO_OS_WINDOWS)
@@ -141,17 +144,16 @@ struct ClapEventQueue
 
     struct CachedParameters {
         uint numParams;
-        bool* changed;
+        ParameterChangeTracker changed;
         float* values;
 
         CachedParameters()
             : numParams(0),
-              changed(nullptr),
+              changed(),
               values(nullptr) {}
 
         ~CachedParameters()
         {
-            delete[] changed;
             delete[] values;
         }
 
@@ -161,10 +163,9 @@ struct ClapEventQueue
                 return;
 
             numParams = numParameters;
-            changed = new bool[numParameters];
+            changed.init(numParameters);
             values = new float[numParameters];
 
-            std::memset(changed, 0, sizeof(bool)*numParameters);
             std::memset(values, 0, sizeof(float)*numParameters);
         }
     } fCachedParameters;
@@ -495,14 +496,9 @@ public:
             ui->idleFromNativeIdle();
            #endif
 
-            for (uint i=0; i<fCachedParameters.numParams; ++i)
-            {
-                if (fCachedParameters.changed[i])
-                {
-                    fCachedParameters.changed[i] = false;
-                    ui->parameterChanged(i, fCachedParameters.values[i]);
-                }
-            }
+            uint32_t index;
+            while (fCachedParameters.changed.takeNext(index))
+                ui->parameterChanged(index, fCachedParameters.values[index]);
         }
     }
 
@@ -616,7 +612,7 @@ private:
         for (uint32_t i=0; i<fCachedParameters.numParams; ++i)
         {
             const float value = fCachedParameters.values[i] = fPlugin.getParameterValue(i);
-            fCachedParameters.changed[i] = false;
+            fCachedParameters.changed.take(i);
             fUI->parameterChanged(i, value);
         }
 
@@ -741,6 +737,47 @@ static constexpr const updateStateValueFunc updateStateValueCallback = nullptr;
 
 // --------------------------------------------------------------------------------------------------------------------
 
+template<typename T>
+static inline
+T** getChannelBuffers(const clap_audio_buffer_t& buffer) noexcept;
+
+template<>
+inline
+float** getChannelBuffers<float>(const clap_audio_buffer_t& buffer) noexcept
+{
+    return buffer.data32;
+}
+
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+template<>
+inline
+double** getChannelBuffers<double>(const clap_audio_buffer_t& buffer) noexcept
+{
+    return buffer.data64;
+}
+
+// all ports use the same sample size, so checking the first one with channels is enough
+static inline
+bool isDoublePrecisionProcess(const clap_process_t* const process) noexcept
+{
+    for (uint32_t i=0; i<process->audio_outputs_count; ++i)
+    {
+        if (process->audio_outputs[i].channel_count != 0)
+            return process->audio_outputs[i].data32 == nullptr;
+    }
+
+    for (uint32_t i=0; i<process->audio_inputs_count; ++i)
+    {
+        if (process->audio_inputs[i].channel_count != 0)
+            return process->audio_inputs[i].data32 == nullptr;
+    }
+
+    return false;
+}
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+
 /**
  * CLAP plugin class.
  */
@@ -755,6 +792,7 @@ public:
           fHost(host),
           fOutputEvents(nullptr),
           fResetParameterIndex(UINT32_MAX),
+          fOffline(false),
          #if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS != 0
           fUsingCV(false),
          #endif
@@ -763,13 +801,22 @@ public:
           fLastKnownLatency(0),
          #endif
          #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-          fMidiEventCount(0),
+          fMidiEvents(fPlugin.getMidiEventPool()),
          #endif
           fHostExtensions(host)
     {
         if (const uint32_t paramCount = fPlugin.getParameterCount())
         {
             fCachedParameters.setup(paramCount);
+            fParameterChanges.setup(paramCount);
+            fFlushParameterChanges.setup(paramCount);
+            fOutputParameters.setup(paramCount);
+
+            for (uint32_t i=0; i<paramCount; ++i)
+            {
+                if (fPlugin.isParameterOutputOrTrigger(i))
+                    fOutputParameters.add(i);
+            }
 
             for (uint32_t i=0; i<paramCount; ++i)
             {
@@ -818,13 +865,22 @@ public:
         if (!clap_version_is_compatible(fHost->clap_version))
             return false;
 
-        return fHostExtensions.init();
+        if (! fHostExtensions.init())
+            return false;
+
+       #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+        if (fHostExtensions.threadPool != nullptr)
+            fPlugin.setRequestParallelExecutionCallback(requestParallelExecutionCallback);
+       #endif
+
+        return true;
     }
 
     void activate(const double sampleRate, const uint32_t maxFramesCount)
     {
         fPlugin.setSampleRate(sampleRate, true);
         fPlugin.setBufferSize(maxFramesCount, true);
+        fPlugin.setOffline(fOffline, true);
         fPlugin.activate();
     }
 
@@ -842,7 +898,7 @@ public:
         if (fResetParameterIndex != UINT32_MAX)
         {
            #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-            fMidiEventCount = 0;
+            fMidiEvents.clear();
            #endif
             fPlugin.setParameterValue(fResetParameterIndex, 1.f);
             fPlugin.setParameterValue(fResetParameterIndex, 0.f);
@@ -856,7 +912,7 @@ public:
     bool process(const clap_process_t* const process)
     {
        #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        fMidiEventCount = 0;
+        fMidiEvents.clear();
        #endif
 
        #if DISTRHO_PLUGIN_HAS_UI
@@ -1006,6 +1062,11 @@ public:
                     case CLAP_EVENT_PARAM_VALUE:
                         DISTRHO_SAFE_ASSERT_UINT2_BREAK(event->size == sizeof(clap_event_param_value_t),
                                                         event->size, sizeof(clap_event_param_value_t));
+                       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+                        // handled below while splitting the audio block
+                        if (process->frames_count != 0)
+                            break;
+                       #endif
                         if (event->space_id == 0)
                             setParameterValueFromEvent(reinterpret_cast<const clap_event_param_value_t*>(event));
                         break;
@@ -1030,22 +1091,24 @@ public:
         }
 
        #if DISTRHO_PLUGIN_HAS_UI && DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        if (fMidiEventCount != kMaxMidiEvents && fNotesRingBuffer.isDataAvailableForReading())
+        if (! fMidiEvents.isFull() && fNotesRingBuffer.isDataAvailableForReading())
         {
             uint8_t midiData[3];
-            const uint32_t frame = fMidiEventCount != 0 ? fMidiEvents[fMidiEventCount-1].frame : 0;
+            const uint32_t frame = fMidiEvents.getLastFrame();
 
             while (fNotesRingBuffer.isDataAvailableForReading())
             {
                 if (! fNotesRingBuffer.readCustomData(midiData, 3))
                     break;
 
-                MidiEvent& midiEvent(fMidiEvents[fMidiEventCount++]);
-                midiEvent.frame = frame;
-                midiEvent.size  = 3;
-                std::memcpy(midiEvent.data, midiData, 3);
+                MidiEvent* const midiEvent = fMidiEvents.allocate();
+                DISTRHO_SAFE_ASSERT_BREAK(midiEvent != nullptr);
+
+                midiEvent->frame = frame;
+                midiEvent->size  = 3;
+                std::memcpy(midiEvent->data, midiData, 3);
 
-                if (fMidiEventCount == kMaxMidiEvents)
+                if (fMidiEvents.isFull())
                     break;
             }
         }
@@ -1053,77 +1116,131 @@ public:
 
         if (const uint32_t frames = process->frames_count)
         {
-           #if DISTRHO_PLUGIN_NUM_INPUTS != 0
-            const float** const audioInputs = fAudioInputs;
+           #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+            const bool ok = isDoublePrecisionProcess(process) ? processAudio<double>(process, frames)
+                                                             : processAudio<float>(process, frames);
+           #else
+            const bool ok = processAudio<float>(process, frames);
+           #endif
 
-            uint32_t in=0;
-            for (uint32_t i=0; i<process->audio_inputs_count; ++i)
-            {
-                const clap_audio_buffer_t& inputs(process->audio_inputs[i]);
-                DISTRHO_SAFE_ASSERT_CONTINUE(inputs.channel_count != 0);
+            if (! ok)
+                return false;
+        }
 
-                for (uint32_t j=0; j<inputs.channel_count; ++j, ++in)
-                    audioInputs[in] = const_cast<const float*>(inputs.data32[j]);
-            }
+       #if DISTRHO_PLUGIN_WANT_LATENCY
+        checkForLatencyChanges(true, false);
+       #endif
 
-            if (fUsingCV)
-            {
-                for (; in<DISTRHO_PLUGIN_NUM_INPUTS; ++in)
-                    audioInputs[in] = nullptr;
-            }
-            else
-            {
-                DISTRHO_SAFE_ASSERT_UINT2_RETURN(in == DISTRHO_PLUGIN_NUM_INPUTS,
-                                                 in, process->audio_inputs_count, false);
-            }
-           #else
-            constexpr const float** const audioInputs = nullptr;
-           #endif
+        return true;
+    }
 
-           #if DISTRHO_PLUGIN_NUM_OUTPUTS != 0
-            float** const audioOutputs = fAudioOutputs;
+    template<typename T>
+    bool processAudio(const clap_process_t* const process, const uint32_t frames)
+    {
+       #if DISTRHO_PLUGIN_NUM_INPUTS != 0
+        const T* audioInputs[DISTRHO_PLUGIN_NUM_INPUTS];
 
-            uint32_t out=0;
-            for (uint32_t i=0; i<process->audio_outputs_count; ++i)
-            {
-                const clap_audio_buffer_t& outputs(process->audio_outputs[i]);
-                DISTRHO_SAFE_ASSERT_CONTINUE(outputs.channel_count != 0);
+        uint32_t in=0;
+        for (uint32_t i=0; i<process->audio_inputs_count; ++i)
+        {
+            const clap_audio_buffer_t& inputs(process->audio_inputs[i]);
+            DISTRHO_SAFE_ASSERT_CONTINUE(inputs.channel_count != 0);
 
-                for (uint32_t j=0; j<outputs.channel_count; ++j, ++out)
-                    audioOutputs[out] = outputs.data32[j];
-            }
+            for (uint32_t j=0; j<inputs.channel_count; ++j, ++in)
+                audioInputs[in] = const_cast<const T*>(getChannelBuffers<T>(inputs)[j]);
+        }
 
-            if (fUsingCV)
-            {
-                for (; out<DISTRHO_PLUGIN_NUM_OUTPUTS; ++out)
-                    audioOutputs[out] = nullptr;
-            }
-            else
-            {
-                DISTRHO_SAFE_ASSERT_UINT2_RETURN(out == DISTRHO_PLUGIN_NUM_OUTPUTS,
-                                                 out, DISTRHO_PLUGIN_NUM_OUTPUTS, false);
-            }
-           #else
-            constexpr float** const audioOutputs = nullptr;
-           #endif
+        if (fUsingCV)
+        {
+            for (; in<DISTRHO_PLUGIN_NUM_INPUTS; ++in)
+                audioInputs[in] = nullptr;
+        }
+        else
+        {
+            DISTRHO_SAFE_ASSERT_UINT2_RETURN(in == DISTRHO_PLUGIN_NUM_INPUTS,
+                                             in, process->audio_inputs_count, false);
+        }
+       #else
+        constexpr const T** const audioInputs = nullptr;
+       #endif
 
-            fOutputEvents = process->out_events;
+       #if DISTRHO_PLUGIN_NUM_OUTPUTS != 0
+        T* audioOutputs[DISTRHO_PLUGIN_NUM_OUTPUTS];
 
-           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-            fPlugin.run(audioInputs, audioOutputs, frames, fMidiEvents, fMidiEventCount);
-           #else
-            fPlugin.run(audioInputs, audioOutputs, frames);
-           #endif
+        uint32_t out=0;
+        for (uint32_t i=0; i<process->audio_outputs_count; ++i)
+        {
+            const clap_audio_buffer_t& outputs(process->audio_outputs[i]);
+            DISTRHO_SAFE_ASSERT_CONTINUE(outputs.channel_count != 0);
 
-            flushParameters(nullptr, process->out_events, frames - 1);
+            for (uint32_t j=0; j<outputs.channel_count; ++j, ++out)
+                audioOutputs[out] = getChannelBuffers<T>(outputs)[j];
+        }
 
-            fOutputEvents = nullptr;
+        if (fUsingCV)
+        {
+            for (; out<DISTRHO_PLUGIN_NUM_OUTPUTS; ++out)
+                audioOutputs[out] = nullptr;
+        }
+        else
+        {
+            DISTRHO_SAFE_ASSERT_UINT2_RETURN(out == DISTRHO_PLUGIN_NUM_OUTPUTS,
+                                             out, DISTRHO_PLUGIN_NUM_OUTPUTS, false);
         }
+       #else
+        constexpr T** const audioOutputs = nullptr;
+       #endif
 
-       #if DISTRHO_PLUGIN_WANT_LATENCY
-        checkForLatencyChanges(true, false);
+        fOutputEvents = process->out_events;
+
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        uint32_t offset = 0;
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        uint32_t midiEventIndex = 0;
+       #endif
+
+        if (const clap_input_events_t* const inputEvents = process->in_events)
+        {
+            for (uint32_t i=0, len=inputEvents->size(inputEvents); i<len; ++i)
+            {
+                const clap_event_header_t* const event = inputEvents->get(inputEvents, i);
+
+                if (event->type != CLAP_EVENT_PARAM_VALUE || event->space_id != 0)
+                    continue;
+                if (event->size != sizeof(clap_event_param_value_t))
+                    continue;
+
+                // run everything up to this event before changing the parameter
+                if (event->time > offset && event->time < frames)
+                {
+                   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                    fPlugin.runSubBlock(audioInputs, audioOutputs, offset, event->time - offset,
+                                        fMidiEvents.getEvents(), fMidiEvents.getCount(), midiEventIndex, false);
+                   #else
+                    fPlugin.runSubBlock(audioInputs, audioOutputs, offset, event->time - offset);
+                   #endif
+                    offset = event->time;
+                }
+
+                setParameterValueFromEvent(reinterpret_cast<const clap_event_param_value_t*>(event));
+            }
+        }
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fPlugin.runSubBlock(audioInputs, audioOutputs, offset, frames - offset,
+                            fMidiEvents.getEvents(), fMidiEvents.getCount(), midiEventIndex, true);
+       #else
+        fPlugin.runSubBlock(audioInputs, audioOutputs, offset, frames - offset);
        #endif
+       #elif DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fPlugin.run(audioInputs, audioOutputs, frames, fMidiEvents.getEvents(), fMidiEvents.getCount());
+       #else
+        fPlugin.run(audioInputs, audioOutputs, frames);
+       #endif
+
+        flushParameters(nullptr, process->out_events, frames - 1);
 
+        fOutputEvents = nullptr;
         return true;
     }
 
@@ -1266,6 +1383,9 @@ public:
     {
         if (const uint32_t len = in != nullptr ? in->size(in) : 0)
         {
+            // not processing, so all changes can be given to the plugin at once
+            fFlushParameterChanges.clear();
+
             for (uint32_t i=0; i<len; ++i)
             {
                 const clap_event_header_t* const event = in->get(in, i);
@@ -1278,34 +1398,43 @@ public:
                 DISTRHO_SAFE_ASSERT_UINT2_BREAK(event->size == sizeof(clap_event_param_value_t),
                                                 event->size, sizeof(clap_event_param_value_t));
 
-                setParameterValueFromEvent(reinterpret_cast<const clap_event_param_value_t*>(event));
+                const clap_event_param_value_t* const paramEvent
+                    = reinterpret_cast<const clap_event_param_value_t*>(event);
+                DISTRHO_SAFE_ASSERT_UINT2_CONTINUE(paramEvent->param_id < fCachedParameters.numParams,
+                                                   paramEvent->param_id, fCachedParameters.numParams);
+
+                fCachedParameters.values[paramEvent->param_id] = paramEvent->value;
+                fCachedParameters.changed.mark(paramEvent->param_id);
+                // hosts can send several values for the same parameter, only the last one is kept
+                fFlushParameterChanges.set(paramEvent->param_id, paramEvent->value);
             }
+
+            fPlugin.setParameterValues(fFlushParameterChanges);
         }
 
-        if (out != nullptr)
+        if (out != nullptr && fOutputParameters.getCount() != 0)
         {
             clap_event_param_value_t clapEvent = {
                 { sizeof(clap_event_param_value_t), frameOffset, 0, CLAP_EVENT_PARAM_VALUE, CLAP_EVENT_IS_LIVE },
                 0, nullptr, 0, 0, 0, 0, 0.0
             };
 
-            float value;
-            for (uint i=0; i<fCachedParameters.numParams; ++i)
+            fPlugin.getParameterValues(fOutputParameters);
+
+            for (uint32_t i=0, count=fOutputParameters.getCount(); i<count; ++i)
             {
-                if (fPlugin.isParameterOutputOrTrigger(i))
-                {
-                    value = fPlugin.getParameterValue(i);
+                const uint32_t index = fOutputParameters.getIndex(i);
+                const float value = fOutputParameters.getValue(i);
 
-                    if (d_isEqual(fCachedParameters.values[i], value))
-                        continue;
+                if (d_isEqual(fCachedParameters.values[index], value))
+                    continue;
 
-                    fCachedParameters.values[i] = value;
-                    fCachedParameters.changed[i] = true;
+                fCachedParameters.values[index] = value;
+                fCachedParameters.changed.mark(index);
 
-                    clapEvent.param_id = i;
-                    clapEvent.value = value;
-                    out->try_push(out, &clapEvent.header);
-                }
+                clapEvent.param_id = index;
+                clapEvent.value = value;
+                out->try_push(out, &clapEvent.header);
             }
         }
 
@@ -1322,35 +1451,37 @@ public:
     {
         DISTRHO_SAFE_ASSERT_UINT_RETURN(event->port_index == 0, event->port_index,);
 
-        if (fMidiEventCount == kMaxMidiEvents)
+        MidiEvent* const midiEvent = fMidiEvents.allocate();
+
+        if (midiEvent == nullptr)
             return;
 
-        MidiEvent& midiEvent(fMidiEvents[fMidiEventCount++]);
-        midiEvent.frame = event->header.time;
-        midiEvent.size  = 3;
-        midiEvent.data[0] = (isOn ? 0x90 : 0x80) | (event->channel & 0x0F);
-        midiEvent.data[1] = std::max(0, std::min(127, static_cast<int>(event->key)));
-        midiEvent.data[2] = std::max(0, std::min(127, static_cast<int>(event->velocity * 127 + 0.5)));
+        midiEvent->frame = event->header.time;
+        midiEvent->size  = 3;
+        midiEvent->data[0] = (isOn ? 0x90 : 0x80) | (event->channel & 0x0F);
+        midiEvent->data[1] = std::max(0, std::min(127, static_cast<int>(event->key)));
+        midiEvent->data[2] = std::max(0, std::min(127, static_cast<int>(event->velocity * 127 + 0.5)));
     }
 
     void addMidiEvent(const clap_event_midi_t* const event) noexcept
     {
         DISTRHO_SAFE_ASSERT_UINT_RETURN(event->port_index == 0, event->port_index,);
 
-        if (fMidiEventCount == kMaxMidiEvents)
+        MidiEvent* const midiEvent = fMidiEvents.allocate();
+
+        if (midiEvent == nullptr)
             return;
 
-        MidiEvent& midiEvent(fMidiEvents[fMidiEventCount++]);
-        midiEvent.frame = event->header.time;
-        midiEvent.size  = 3;
-        std::memcpy(midiEvent.data, event->data, 3);
+        midiEvent->frame = event->header.time;
+        midiEvent->size  = 3;
+        std::memcpy(midiEvent->data, event->data, 3);
     }
    #endif
 
     void setParameterValueFromEvent(const clap_event_param_value_t* const event)
     {
         fCachedParameters.values[event->param_id] = event->value;
-        fCachedParameters.changed[event->param_id] = true;
+        fCachedParameters.changed.mark(event->param_id);
         fPlugin.setParameterValue(event->param_id, event->value);
     }
 
@@ -1376,6 +1507,10 @@ public:
         d_strncpy(info->name, busInfo.name, CLAP_NAME_SIZE);
 
         info->flags = busInfo.isMain ? CLAP_AUDIO_PORT_IS_MAIN : 0x0;
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        // not preferred, as the default double precision run() converts to single precision and back
+        info->flags |= CLAP_AUDIO_PORT_SUPPORTS_64BITS|CLAP_AUDIO_PORT_REQUIRES_COMMON_SAMPLE_SIZE;
+       #endif
         info->channel_count = busInfo.numChannels;
 
         switch (busInfo.groupId)
@@ -1450,6 +1585,30 @@ public:
     }
    #endif
 
+    // ----------------------------------------------------------------------------------------------------------------
+    // render
+
+    bool setRenderMode(const clap_plugin_render_mode mode)
+    {
+        fOffline = mode == CLAP_RENDER_OFFLINE;
+
+        // the host might be processing while active, so in that case the change waits for the next activation
+        if (! fPlugin.isActive())
+            fPlugin.setOffline(fOffline, true);
+
+        return true;
+    }
+
+   #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    // ----------------------------------------------------------------------------------------------------------------
+    // thread pool
+
+    void threadPoolExec(const uint32_t taskIndex)
+    {
+        fPlugin.executeParallelTask(taskIndex);
+    }
+   #endif
+
     // ----------------------------------------------------------------------------------------------------------------
     // state
 
@@ -1477,6 +1636,35 @@ public:
         }
        #endif
 
+        // get all parameter values in a single call
+        fParameterChanges.clear();
+
+        for (uint32_t i=0; i<paramCount; ++i)
+        {
+            if (! fPlugin.isParameterOutputOrTrigger(i))
+                fParameterChanges.add(i);
+        }
+
+        fPlugin.getParameterValues(fParameterChanges);
+
+       #if DISTRHO_PLUGIN_WANT_BINARY_STATE
+        BinaryStateWriter writer;
+
+       #if DISTRHO_PLUGIN_WANT_PROGRAMS
+        writer.writeProgram(fCurrentProgram);
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_STATE
+        for (StringMap::const_iterator cit=fStateMap.begin(), cite=fStateMap.end(); cit != cite; ++cit)
+            writer.writeState(cit->first, cit->second);
+       #endif
+
+        for (uint32_t i=0, count=fParameterChanges.getCount(); i<count; ++i)
+            writer.addParameter(fPlugin.getParameterSymbol(fParameterChanges.getIndex(i)), fParameterChanges.getValue(i));
+
+        const std::vector<uint8_t>& data(writer.finish());
+        return writeStateData(stream, data.data(), static_cast<int64_t>(data.size()));
+       #else
         String state;
 
        #if DISTRHO_PLUGIN_WANT_PROGRAMS
@@ -1517,19 +1705,18 @@ public:
         {
             state += "__dpf_parameters_begin__\xff";
 
-            for (uint32_t i=0; i<paramCount; ++i)
+            for (uint32_t i=0, count=fParameterChanges.getCount(); i<count; ++i)
             {
-                if (fPlugin.isParameterOutputOrTrigger(i))
-                    continue;
+                const uint32_t index = fParameterChanges.getIndex(i);
 
                 // join key and value
                 String tmpStr;
-                tmpStr  = fPlugin.getParameterSymbol(i);
+                tmpStr  = fPlugin.getParameterSymbol(index);
                 tmpStr += "\xff";
-                if (fPlugin.getParameterHints(i) & kParameterIsInteger)
-                    tmpStr += String(static_cast<int>(std::round(fPlugin.getParameterValue(i))));
+                if (fPlugin.getParameterHints(index) & kParameterIsInteger)
+                    tmpStr += String(static_cast<int>(std::round(fParameterChanges.getValue(i))));
                 else
-                    tmpStr += String(fPlugin.getParameterValue(i));
+                    tmpStr += String(fParameterChanges.getValue(i));
                 tmpStr += "\xff";
 
                 state += tmpStr;
@@ -1543,17 +1730,8 @@ public:
 
         state.replace('\xff', '\0');
 
-        // now saving state, carefully until host written bytes matches full state size
-        const char* buffer = state.buffer();
-        const int32_t size = static_cast<int32_t>(state.length())+1;
-
-        for (int32_t wrtntotal = 0, wrtn; wrtntotal < size; wrtntotal += wrtn)
-        {
-            wrtn = stream->write(stream, buffer + wrtntotal, size - wrtntotal);
-            DISTRHO_SAFE_ASSERT_INT_RETURN(wrtn > 0, wrtn, false);
-        }
-
-        return true;
+        return writeStateData(stream, state.buffer(), static_cast<int64_t>(state.length())+1);
+       #endif
     }
 
     bool stateLoad(const clap_istream_t* const stream)
@@ -1570,6 +1748,9 @@ public:
         char buffer[512], orig;
         buffer[sizeof(buffer)-1] = '\xff';
 
+        // parameter values are collected and given to the plugin all at once at the end
+        fParameterChanges.clear();
+
         for (int32_t terminated = 0; terminated == 0;)
         {
             const int32_t read = stream->read(stream, buffer, sizeof(buffer)-1);
@@ -1578,6 +1759,16 @@ public:
             if (read == 0)
                 return !empty;
 
+            if (empty)
+            {
+                if (const uint32_t binaryStateSize = BinaryStateReader::getTotalSize(buffer, static_cast<uint32_t>(read)))
+                {
+                    DISTRHO_SAFE_ASSERT_RETURN(stateLoadBinary(stream, buffer, static_cast<uint32_t>(read),
+                                                               binaryStateSize), false);
+                    break;
+                }
+            }
+
             empty = false;
             for (int32_t i = 0; i < read; ++i)
             {
@@ -1726,10 +1917,10 @@ public:
                             if (ui != nullptr)
                             {
                                 // UI parameter updates are handled outside the read loop (after host param restart)
-                                fCachedParameters.changed[j] = true;
+                                fCachedParameters.changed.mark(j);
                             }
                            #endif
-                            fPlugin.setParameterValue(j, fvalue);
+                            fParameterChanges.add(j, fvalue);
                             break;
                         }
                     }
@@ -1741,6 +1932,8 @@ public:
             }
         }
 
+        fPlugin.setParameterValues(fParameterChanges);
+
         if (fHostExtensions.params != nullptr)
             fHostExtensions.params->rescan(fHost, CLAP_PARAM_RESCAN_VALUES|CLAP_PARAM_RESCAN_TEXT);
 
@@ -1756,7 +1949,7 @@ public:
             {
                 if (fPlugin.isParameterOutputOrTrigger(i))
                     continue;
-                fCachedParameters.changed[i] = false;
+                fCachedParameters.changed.take(i);
                 ui->setParameterValueFromPlugin(i, fCachedParameters.values[i]);
             }
         }
@@ -1803,11 +1996,9 @@ public:
     {
         fPlugin.setState(key, value);
 
-        if (fPlugin.wantStateKey(key))
-        {
-            const String dkey(key);
-            fStateMap[dkey] = value;
-        }
+        uint32_t index;
+        if (fPlugin.getStateIndex(key, index))
+            fStateMap[fPlugin.getStateKey(index)] = value;
     }
    #endif
 
@@ -1825,12 +2016,10 @@ private:
     const clap_output_events_t* fOutputEvents;
 
     uint32_t fResetParameterIndex;
-   #if DISTRHO_PLUGIN_NUM_INPUTS != 0
-    const float* fAudioInputs[DISTRHO_PLUGIN_NUM_INPUTS];
-   #endif
-   #if DISTRHO_PLUGIN_NUM_OUTPUTS != 0
-    float* fAudioOutputs[DISTRHO_PLUGIN_NUM_OUTPUTS];
-   #endif
+    ParameterValueList fParameterChanges; // main thread, for state save and restore
+    ParameterValueList fFlushParameterChanges;
+    ParameterValueList fOutputParameters; // fixed list of output and trigger parameters
+    bool fOffline;
    #if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS != 0
     bool fUsingCV;
    #endif
@@ -1839,8 +2028,7 @@ private:
     uint32_t fLastKnownLatency;
    #endif
   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-    uint32_t fMidiEventCount;
-    MidiEvent fMidiEvents[kMaxMidiEvents];
+    MidiEventPool& fMidiEvents;
    #if DISTRHO_PLUGIN_HAS_UI
     RingBufferControl<SmallStackBuffer> fNotesRingBuffer;
    #endif
@@ -1856,6 +2044,9 @@ private:
         const clap_host_latency_t* latency;
         const clap_host_thread_check_t* threadCheck;
        #endif
+       #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+        const clap_host_thread_pool_t* threadPool;
+       #endif
 
         HostExtensions(const clap_host_t* const host)
             : host(host),
@@ -1864,6 +2055,9 @@ private:
             , latency(nullptr)
             , threadCheck(nullptr)
            #endif
+           #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+            , threadPool(nullptr)
+           #endif
         {}
 
         bool init()
@@ -1874,6 +2068,11 @@ private:
             DISTRHO_SAFE_ASSERT_RETURN(host->request_callback != nullptr, false);
             latency = static_cast<const clap_host_latency_t*>(host->get_extension(host, CLAP_EXT_LATENCY));
             threadCheck = static_cast<const clap_host_thread_check_t*>(host->get_extension(host, CLAP_EXT_THREAD_CHECK));
+           #endif
+           #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+            threadPool = static_cast<const clap_host_thread_pool_t*>(host->get_extension(host, CLAP_EXT_THREAD_POOL));
+            if (threadPool != nullptr && threadPool->request_exec == nullptr)
+                threadPool = nullptr;
            #endif
             return true;
         }
@@ -2041,6 +2240,137 @@ private:
     }
    #endif
 
+    // ----------------------------------------------------------------------------------------------------------------
+    // helper functions for dealing with state
+
+    static bool writeStateData(const clap_ostream_t* const stream, const void* const data, const int64_t size)
+    {
+        // saving state, carefully until host written bytes matches full state size
+        const uint8_t* const buffer = static_cast<const uint8_t*>(data);
+
+        for (int64_t wrtntotal = 0, wrtn; wrtntotal < size; wrtntotal += wrtn)
+        {
+            wrtn = stream->write(stream, buffer + wrtntotal, static_cast<uint64_t>(size - wrtntotal));
+            DISTRHO_SAFE_ASSERT_INT_RETURN(wrtn > 0, static_cast<int>(wrtn), false);
+        }
+
+        return true;
+    }
+
+    bool stateLoadBinary(const clap_istream_t* const stream,
+                         const char* const initialData, const uint32_t initialSize, const uint32_t totalSize)
+    {
+       #if DISTRHO_PLUGIN_HAS_UI
+        ClapUI* const ui = fUI.get();
+       #endif
+
+        // get the full state in a single block, so chunks can be read in place
+        std::vector<uint8_t> data(totalSize);
+        uint32_t filled = std::min(initialSize, totalSize);
+        std::memcpy(data.data(), initialData, filled);
+
+        while (filled < totalSize)
+        {
+            const int64_t read = stream->read(stream, data.data() + filled, totalSize - filled);
+            DISTRHO_SAFE_ASSERT_INT_RETURN(read > 0, static_cast<int>(read), false);
+            filled += static_cast<uint32_t>(read);
+        }
+
+        BinaryStateReader reader(data.data(), totalSize);
+        const uint8_t* chunkData;
+        uint32_t chunkType, chunkSize;
+
+        while (reader.readChunk(chunkType, chunkData, chunkSize))
+        {
+            switch (chunkType)
+            {
+            case kBinaryStateChunkProgram:
+            {
+               #if DISTRHO_PLUGIN_WANT_PROGRAMS
+                uint32_t program;
+                DISTRHO_SAFE_ASSERT_BREAK(BinaryStateReader::parseProgram(chunkData, chunkSize, program));
+                DISTRHO_SAFE_ASSERT_UINT2_BREAK(program < fPlugin.getProgramCount(),
+                                                program, fPlugin.getProgramCount());
+
+                fCurrentProgram = program;
+                fPlugin.loadProgram(fCurrentProgram);
+
+               #if DISTRHO_PLUGIN_HAS_UI
+                if (ui != nullptr)
+                    ui->setProgramFromPlugin(fCurrentProgram);
+               #endif
+               #endif
+                break;
+            }
+
+            case kBinaryStateChunkState:
+            {
+               #if DISTRHO_PLUGIN_WANT_STATE
+                const char* key;
+                const char* value;
+                DISTRHO_SAFE_ASSERT_BREAK(BinaryStateReader::parseState(chunkData, chunkSize, key, value));
+
+                uint32_t stateIndex;
+                if (fPlugin.getStateIndex(key, stateIndex))
+                {
+                    fStateMap[fPlugin.getStateKey(stateIndex)] = value;
+                    fPlugin.setState(key, value);
+
+                   #if DISTRHO_PLUGIN_HAS_UI
+                    if (ui != nullptr)
+                        ui->setStateFromPlugin(key, value);
+                   #endif
+                }
+               #endif
+                break;
+            }
+
+            case kBinaryStateChunkParameters:
+            {
+                BinaryStateReader::Parameters params;
+                DISTRHO_SAFE_ASSERT_BREAK(BinaryStateReader::parseParameters(chunkData, chunkSize, params));
+
+                const uint32_t numParams = fCachedParameters.numParams;
+                const char* symbol;
+                float value;
+
+                // parameters are saved in order, so the next index is usually the right one
+                for (uint32_t hint = 0; params.next(symbol, value);)
+                {
+                    for (uint32_t n=0; n < numParams; ++n)
+                    {
+                        const uint32_t j = (hint + n) % numParams;
+
+                        if (fPlugin.isParameterOutputOrTrigger(j))
+                            continue;
+                        if (fPlugin.getParameterSymbol(j) != symbol)
+                            continue;
+
+                        fCachedParameters.values[j] = value;
+                       #if DISTRHO_PLUGIN_HAS_UI
+                        if (ui != nullptr)
+                        {
+                            // UI parameter updates are handled after all chunks are read
+                            fCachedParameters.changed.mark(j);
+                        }
+                       #endif
+                        fParameterChanges.add(j, value);
+                        hint = j + 1;
+                        break;
+                    }
+                }
+                break;
+            }
+
+            default:
+                d_debug("ignoring unknown binary state chunk type %u", chunkType);
+                break;
+            }
+        }
+
+        return true;
+    }
+
     // ----------------------------------------------------------------------------------------------------------------
     // DPF callbacks
 
@@ -2090,6 +2420,18 @@ private:
         return static_cast<PluginCLAP*>(ptr)->updateState(key, value);
     }
    #endif
+
+   #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    bool requestParallelExecution(const uint32_t numTasks)
+    {
+        return fHostExtensions.threadPool->request_exec(fHost, numTasks);
+    }
+
+    static bool requestParallelExecutionCallback(void* const ptr, const uint32_t numTasks)
+    {
+        return static_cast<PluginCLAP*>(ptr)->requestParallelExecution(numTasks);
+    }
+   #endif
 };
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -2424,6 +2766,40 @@ static const clap_plugin_latency_t clap_plugin_latency = {
 };
 #endif
 
+// --------------------------------------------------------------------------------------------------------------------
+// plugin render
+
+static bool CLAP_ABI clap_plugin_render_has_hard_realtime_requirement(const clap_plugin_t*)
+{
+    return false;
+}
+
+static bool CLAP_ABI clap_plugin_render_set(const clap_plugin_t* const plugin, const clap_plugin_render_mode mode)
+{
+    PluginCLAP* const instance = static_cast<PluginCLAP*>(plugin->plugin_data);
+    return instance->setRenderMode(mode);
+}
+
+static const clap_plugin_render_t clap_plugin_render = {
+    clap_plugin_render_has_hard_realtime_requirement,
+    clap_plugin_render_set
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// plugin thread pool
+
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+static void CLAP_ABI clap_plugin_thread_pool_exec(const clap_plugin_t* const plugin, const uint32_t taskIndex)
+{
+    PluginCLAP* const instance = static_cast<PluginCLAP*>(plugin->plugin_data);
+    instance->threadPoolExec(taskIndex);
+}
+
+static const clap_plugin_thread_pool_t clap_plugin_thread_pool = {
+    clap_plugin_thread_pool_exec
+};
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // plugin state
 
@@ -2507,6 +2883,12 @@ static const void* CLAP_ABI clap_plugin_get_extension(const clap_plugin_t*, cons
         return &clap_plugin_params;
     if (std::strcmp(id, CLAP_EXT_STATE) == 0)
         return &clap_plugin_state;
+    if (std::strcmp(id, CLAP_EXT_RENDER) == 0)
+        return &clap_plugin_render;
+   #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    if (std::strcmp(id, CLAP_EXT_THREAD_POOL) == 0)
+        return &clap_plugin_thread_pool;
+   #endif
    #if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS != 0
     if (std::strcmp(id, CLAP_EXT_AUDIO_PORTS) == 0)
         return &clap_plugin_audio_ports;
@@ -2639,6 +3021,7 @@ static bool CLAP_ABI clap_plugin_entry_init(const char* const plugin_path)
         d_nextBufferSize = 512;
         d_nextSampleRate = 44100.0;
         d_nextPluginIsDummy = true;
+        d_nextPluginIsMetadataOnly = true;
         d_nextCanRequestParameterValueChanges = true;
 
         // Create dummy plugin to get data from
@@ -2648,6 +3031,7 @@ static bool CLAP_ABI clap_plugin_entry_init(const char* const plugin_path)
         d_nextBufferSize = 0;
         d_nextSampleRate = 0.0;
         d_nextPluginIsDummy = false;
+        d_nextPluginIsMetadataOnly = false;
         d_nextCanRequestParameterValueChanges = false;
     }
 
@@ -49,6 +49,10 @@
 # define DISTRHO_PLUGIN_HAS_UI 0
 #endif
 
+#ifndef DISTRHO_PLUGIN_HAS_METADATA
+# define DISTRHO_PLUGIN_HAS_METADATA 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_IS_RT_SAFE
 # define DISTRHO_PLUGIN_IS_RT_SAFE 0
 #endif
@@ -61,6 +65,14 @@
 # define DISTRHO_PLUGIN_WANT_DIRECT_ACCESS 0
 #endif
 
+#ifndef DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+# define DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION 0
+#endif
+
+#ifndef DISTRHO_PLUGIN_WANT_FREEWHEELING
+# define DISTRHO_PLUGIN_WANT_FREEWHEELING 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_WANT_LATENCY
 # define DISTRHO_PLUGIN_WANT_LATENCY 0
 #endif
@@ -73,6 +85,10 @@
 # define DISTRHO_PLUGIN_WANT_MIDI_OUTPUT 0
 #endif
 
+#ifndef DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+# define DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
 # define DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST 0
 #endif
@@ -81,10 +97,18 @@
 # define DISTRHO_PLUGIN_WANT_PROGRAMS 0
 #endif
 
+#ifndef DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+# define DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_WANT_STATE
 # define DISTRHO_PLUGIN_WANT_STATE 0
 #endif
 
+#ifndef DISTRHO_PLUGIN_WANT_BINARY_STATE
+# define DISTRHO_PLUGIN_WANT_BINARY_STATE 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_WANT_FULL_STATE
 # define DISTRHO_PLUGIN_WANT_FULL_STATE 0
 # define DISTRHO_PLUGIN_WANT_FULL_STATE_WAS_NOT_SET
@@ -102,6 +126,10 @@
 # define DISTRHO_UI_WEB_VIEW 0
 #endif
 
+#ifndef DISTRHO_UI_WEB_VIEW_PARAMETER_RATE
+# define DISTRHO_UI_WEB_VIEW_PARAMETER_RATE 60
+#endif
+
 #ifndef DISTRHO_UI_USER_RESIZABLE
 # define DISTRHO_UI_USER_RESIZABLE 0
 #endif
@@ -198,6 +226,15 @@
 # error Synths need MIDI input to work!
 #endif
 
+// --------------------------------------------------------------------------------------------------------------------
+// Set default MIDI input event capacity
+
+#ifndef DISTRHO_PLUGIN_MAX_MIDI_EVENTS
+# define DISTRHO_PLUGIN_MAX_MIDI_EVENTS 512
+#elif DISTRHO_PLUGIN_MAX_MIDI_EVENTS <= 0
+# error DISTRHO_PLUGIN_MAX_MIDI_EVENTS must be a positive number
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // Enable state if plugin wants state files (deprecated)
 
@@ -23,14 +23,23 @@
 # include "DistrhoPluginVST.hpp"
 #endif
 
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION && !defined(DISTRHO_OS_WASM)
+# include "../extra/ThreadPool.hpp"
+# define DPF_PLUGIN_USES_THREAD_POOL
+#endif
+
 #include <set>
 
+#ifdef _MSC_VER
+# include <intrin.h>
+#endif
+
 START_NAMESPACE_DISTRHO
 
 // -----------------------------------------------------------------------
 // Maxmimum values
 
-static const uint32_t kMaxMidiEvents = 512;
+static const uint32_t kMaxMidiEvents = DISTRHO_PLUGIN_MAX_MIDI_EVENTS;
 
 // -----------------------------------------------------------------------
 // Static data, see DistrhoPlugin.cpp
@@ -40,6 +49,7 @@ extern double      d_nextSampleRate;
 extern const char* d_nextBundlePath;
 extern bool        d_nextPluginIsDummy;
 extern bool        d_nextPluginIsSelfTest;
+extern bool        d_nextPluginIsMetadataOnly;
 extern bool        d_nextCanRequestParameterValueChanges;
 
 // -----------------------------------------------------------------------
@@ -48,10 +58,21 @@ extern bool        d_nextCanRequestParameterValueChanges;
 typedef bool (*writeMidiFunc) (void* ptr, const MidiEvent& midiEvent);
 typedef bool (*requestParameterValueChangeFunc) (void* ptr, uint32_t index, float value);
 typedef bool (*updateStateValueFunc) (void* ptr, const char* key, const char* value);
+typedef bool (*requestParallelExecutionFunc) (void* ptr, uint32_t numTasks);
 
 // -----------------------------------------------------------------------
 // Helpers
 
+static inline
+Plugin* createPluginOrMetadata()
+{
+   #if DISTRHO_PLUGIN_HAS_METADATA
+    if (d_nextPluginIsMetadataOnly)
+        return createPluginMetadata();
+   #endif
+    return createPlugin();
+}
+
 struct AudioPortWithBusId : AudioPort {
     uint32_t busId;
 
@@ -137,6 +158,580 @@ void snprintf_u32(char* const dst, const uint32_t value, const size_t size)
     return snprintf_t<uint32_t>(dst, value, "%u", size);
 }
 
+// -----------------------------------------------------------------------
+// Parameter change tracking, used for passing changes from DSP to UI side
+
+/**
+   Lock-free set of changed parameter indexes.
+
+   Changes are stored as bits, so marking the same index many times before the changes are taken
+   results in a single notification (the receiving side is expected to read the latest value from a cache).@n
+   An extra summary level keeps track of which groups of 32 indexes have changes,
+   so taking changes only visits the indexes that actually changed.
+
+   Marking changes is wait-free and can be done from any thread, including realtime.@n
+   Taking changes must only be done from a single thread at a time.
+ */
+class ParameterChangeTracker
+{
+public:
+    ParameterChangeTracker() noexcept
+        : fCount(0),
+          fFlags(nullptr),
+          fSummary(nullptr),
+          fPendingSummary(0),
+          fPendingSummaryBits(0),
+          fPendingFlag(0),
+          fPendingFlagBits(0) {}
+
+    ~ParameterChangeTracker() noexcept
+    {
+        delete[] fFlags;
+        delete[] fSummary;
+    }
+
+    /**
+       Allocate space for @a count indexes, clearing all changes.
+       Must be called before any other function, and not during processing.
+     */
+    void init(const uint32_t count)
+    {
+        delete[] fFlags;
+        delete[] fSummary;
+
+        fCount = count;
+        fPendingSummary = fPendingSummaryBits = fPendingFlag = fPendingFlagBits = 0;
+
+        if (count == 0)
+        {
+            fFlags = fSummary = nullptr;
+            return;
+        }
+
+        const uint32_t numFlags = (count + 31) / 32;
+        const uint32_t numSummary = (numFlags + 31) / 32;
+
+        fFlags = new uint32_t[numFlags];
+        fSummary = new uint32_t[numSummary];
+        std::memset(fFlags, 0, sizeof(uint32_t)*numFlags);
+        std::memset(fSummary, 0, sizeof(uint32_t)*numSummary);
+    }
+
+    uint32_t getCount() const noexcept
+    {
+        return fCount;
+    }
+
+    /**
+       Mark parameter @a index as changed.
+     */
+    void mark(const uint32_t index) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < fCount, index, fCount,);
+
+        const uint32_t flag = index / 32;
+        atomicOr(&fFlags[flag], 1u << (index % 32));
+        atomicOr(&fSummary[flag / 32], 1u << (flag % 32));
+    }
+
+    /**
+       Mark all parameters as changed.
+     */
+    void markAll() noexcept
+    {
+        for (uint32_t i=0; i < fCount; ++i)
+            mark(i);
+    }
+
+    /**
+       Take the change of parameter @a index, returning true if it was marked as changed.
+     */
+    bool take(const uint32_t index) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < fCount, index, fCount, false);
+
+        const uint32_t bit = 1u << (index % 32);
+        return (atomicAnd(&fFlags[index / 32], ~bit) & bit) != 0;
+    }
+
+    /**
+       Take the next changed parameter, storing its index in @a index.
+       Returns false once all changes have been taken, the next call after that starts over.
+
+       Typical usage:
+       @code
+       uint32_t index;
+       while (tracker.takeNext(index))
+           ui->parameterChanged(index, values[index]);
+       @endcode
+     */
+    bool takeNext(uint32_t& index) noexcept
+    {
+        for (;;)
+        {
+            if (fPendingFlagBits != 0)
+            {
+                index = fPendingFlag * 32 + countTrailingZeros(fPendingFlagBits);
+                fPendingFlagBits &= fPendingFlagBits - 1;
+
+                if (index < fCount)
+                    return true;
+
+                continue;
+            }
+
+            if (fPendingSummaryBits != 0)
+            {
+                fPendingFlag = (fPendingSummary - 1) * 32 + countTrailingZeros(fPendingSummaryBits);
+                fPendingSummaryBits &= fPendingSummaryBits - 1;
+                fPendingFlagBits = atomicExchange(&fFlags[fPendingFlag], 0);
+                continue;
+            }
+
+            if (fPendingSummary == (fCount + 1023) / 1024)
+            {
+                fPendingSummary = 0;
+                return false;
+            }
+
+            fPendingSummaryBits = atomicExchange(&fSummary[fPendingSummary++], 0);
+        }
+    }
+
+private:
+    uint32_t  fCount;
+    uint32_t* fFlags;
+    uint32_t* fSummary;
+
+    // state for takeNext()
+    uint32_t fPendingSummary;
+    uint32_t fPendingSummaryBits;
+    uint32_t fPendingFlag;
+    uint32_t fPendingFlagBits;
+
+    static inline void atomicOr(uint32_t* const ptr, const uint32_t bits) noexcept
+    {
+       #ifdef _MSC_VER
+        _InterlockedOr(reinterpret_cast<volatile long*>(ptr), static_cast<long>(bits));
+       #else
+        __atomic_fetch_or(ptr, bits, __ATOMIC_RELEASE);
+       #endif
+    }
+
+    static inline uint32_t atomicAnd(uint32_t* const ptr, const uint32_t bits) noexcept
+    {
+       #ifdef _MSC_VER
+        return static_cast<uint32_t>(_InterlockedAnd(reinterpret_cast<volatile long*>(ptr), static_cast<long>(bits)));
+       #else
+        return __atomic_fetch_and(ptr, bits, __ATOMIC_ACQ_REL);
+       #endif
+    }
+
+    static inline uint32_t atomicExchange(uint32_t* const ptr, const uint32_t value) noexcept
+    {
+       #ifdef _MSC_VER
+        return static_cast<uint32_t>(_InterlockedExchange(reinterpret_cast<volatile long*>(ptr), static_cast<long>(value)));
+       #else
+        return __atomic_exchange_n(ptr, value, __ATOMIC_ACQUIRE);
+       #endif
+    }
+
+    static inline uint32_t countTrailingZeros(const uint32_t value) noexcept
+    {
+       #ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, value);
+        return index;
+       #else
+        return static_cast<uint32_t>(__builtin_ctz(value));
+       #endif
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(ParameterChangeTracker)
+};
+
+#if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+// -----------------------------------------------------------------------
+// MIDI input event storage, shared by all plugin formats
+
+/**
+   Preallocated storage for the MIDI events passed into Plugin::run().
+
+   The capacity is never lower than kMaxMidiEvents, and grows with the buffer size so that hosts can
+   send at least one event per frame. Allocation only happens when the buffer size changes,
+   adding events during processing is realtime safe.@n
+   Events that do not fit are dropped and counted.
+   The count can be queried from any thread, PluginExporter also reports new drops when the plugin is deactivated.
+ */
+class MidiEventPool
+{
+public:
+    MidiEventPool() noexcept
+        : fEvents(nullptr),
+          fCapacity(0),
+          fCount(0),
+          fOverflowCount(0),
+          fReportedOverflowCount(0) {}
+
+    ~MidiEventPool() noexcept
+    {
+        delete[] fEvents;
+    }
+
+    /**
+       Make sure there is space for at least as many events as frames in @a bufferSize.
+       Must not be called during processing.
+     */
+    void resize(const uint32_t bufferSize)
+    {
+        const uint32_t capacity = std::max(kMaxMidiEvents, bufferSize);
+
+        if (fCapacity >= capacity)
+            return;
+
+        delete[] fEvents;
+        fEvents = new MidiEvent[capacity];
+        fCapacity = capacity;
+        fCount = 0;
+    }
+
+    void clear() noexcept
+    {
+        fCount = 0;
+    }
+
+    /**
+       Get a new event to write into, or null if the pool is full.
+       A null return increases the overflow count.
+     */
+    MidiEvent* allocate() noexcept
+    {
+        if (fCount == fCapacity)
+        {
+            addOverflowCount(1);
+            return nullptr;
+        }
+
+        return &fEvents[fCount++];
+    }
+
+    bool isFull() const noexcept
+    {
+        return fCount == fCapacity;
+    }
+
+    uint32_t getCapacity() const noexcept
+    {
+        return fCapacity;
+    }
+
+    /**
+       Count events dropped before reaching the pool, for formats that collect events in their own storage first.
+     */
+    void addOverflowCount(const uint32_t count) noexcept
+    {
+        if (count == 0)
+            return;
+
+       #ifdef _MSC_VER
+        _InterlockedExchangeAdd(reinterpret_cast<volatile long*>(&fOverflowCount), static_cast<long>(count));
+       #else
+        __atomic_add_fetch(&fOverflowCount, count, __ATOMIC_RELAXED);
+       #endif
+    }
+
+    MidiEvent* getEvents() const noexcept
+    {
+        return fEvents;
+    }
+
+    uint32_t getCount() const noexcept
+    {
+        return fCount;
+    }
+
+    /**
+       Get the frame of the last added event, or 0 if there are none.
+     */
+    uint32_t getLastFrame() const noexcept
+    {
+        return fCount != 0 ? fEvents[fCount - 1].frame : 0;
+    }
+
+    /**
+       Get the total number of events dropped because the pool was full.
+       Can be called from any thread.
+     */
+    uint32_t getOverflowCount() const noexcept
+    {
+       #ifdef _MSC_VER
+        return *static_cast<const volatile uint32_t*>(&fOverflowCount);
+       #else
+        return __atomic_load_n(&fOverflowCount, __ATOMIC_RELAXED);
+       #endif
+    }
+
+    /**
+       Get the number of events dropped since the last call.
+       Must not be called during processing.
+     */
+    uint32_t takeUnreportedOverflowCount() noexcept
+    {
+        const uint32_t count = getOverflowCount();
+        const uint32_t unreported = count - fReportedOverflowCount;
+        fReportedOverflowCount = count;
+        return unreported;
+    }
+
+private:
+    MidiEvent* fEvents;
+    uint32_t fCapacity;
+    uint32_t fCount;
+    uint32_t fOverflowCount;
+    uint32_t fReportedOverflowCount;
+
+    DISTRHO_DECLARE_NON_COPYABLE(MidiEventPool)
+};
+#endif
+
+// -----------------------------------------------------------------------
+// Parameter value batches, shared by all plugin formats
+
+/**
+   Preallocated list of parameter indexes and values, for use with the batched parameter calls.
+
+   Wrappers collect changes into this list (for example while restoring a state) and then pass them
+   to the plugin in a single call. Allocation only happens in setup(), adding values is realtime safe.
+ */
+class ParameterValueList
+{
+public:
+    ParameterValueList() noexcept
+        : fIndexes(nullptr),
+          fValues(nullptr),
+          fPositions(nullptr),
+          fCapacity(0),
+          fCount(0) {}
+
+    ~ParameterValueList() noexcept
+    {
+        delete[] fIndexes;
+        delete[] fValues;
+        delete[] fPositions;
+    }
+
+    /**
+       Make sure there is space for at least @a capacity values.
+       Must not be called during processing.
+     */
+    void setup(const uint32_t capacity)
+    {
+        fCount = 0;
+
+        if (fCapacity >= capacity)
+            return;
+
+        delete[] fIndexes;
+        delete[] fValues;
+        delete[] fPositions;
+        fIndexes = new uint32_t[capacity];
+        fValues = new float[capacity];
+        fPositions = new uint32_t[capacity]();
+        fCapacity = capacity;
+    }
+
+    void clear() noexcept
+    {
+        fCount = 0;
+    }
+
+    void add(const uint32_t index, const float value = 0.0f) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(fCount < fCapacity, fCount, fCapacity,);
+
+        fIndexes[fCount] = index;
+        fValues[fCount] = value;
+        ++fCount;
+    }
+
+    /**
+       Add a value, or replace the one previously added for the same index, so each index is only listed once.
+       @a index must be lower than the capacity, which is the case when the list is setup with the parameter count.
+     */
+    void set(const uint32_t index, const float value) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < fCapacity, index, fCapacity,);
+
+        // position of a previous value, only valid if that entry still refers to this index
+        const uint32_t pos = fPositions[index];
+
+        if (pos < fCount && fIndexes[pos] == index)
+        {
+            fValues[pos] = value;
+            return;
+        }
+
+        fPositions[index] = fCount;
+        add(index, value);
+    }
+
+    uint32_t getCount() const noexcept
+    {
+        return fCount;
+    }
+
+    uint32_t getIndex(const uint32_t i) const noexcept
+    {
+        return fIndexes[i];
+    }
+
+    float getValue(const uint32_t i) const noexcept
+    {
+        return fValues[i];
+    }
+
+    const uint32_t* getIndexes() const noexcept
+    {
+        return fIndexes;
+    }
+
+    float* getValues() const noexcept
+    {
+        return fValues;
+    }
+
+private:
+    uint32_t* fIndexes;
+    float* fValues;
+    uint32_t* fPositions;
+    uint32_t fCapacity;
+    uint32_t fCount;
+
+    DISTRHO_DECLARE_NON_COPYABLE(ParameterValueList)
+};
+
+#if DISTRHO_PLUGIN_WANT_STATE
+// -----------------------------------------------------------------------
+// State key lookup, shared by all plugin formats
+
+/**
+   Hash table mapping state keys to their index, built once after all states are initialized.
+
+   Keys are hashed on setup, so finding a state by key does not need to compare it against every
+   declared state. Lookups do not allocate and are realtime safe.
+ */
+class StateKeyIndex
+{
+public:
+    StateKeyIndex() noexcept
+        : fStates(nullptr),
+          fHashes(nullptr),
+          fSlots(nullptr),
+          fMask(0) {}
+
+    ~StateKeyIndex() noexcept
+    {
+        delete[] fHashes;
+        delete[] fSlots;
+    }
+
+    /**
+       Build the table for @a count states.
+       The states array must stay valid and its keys unchanged for as long as this index is used.
+     */
+    void setup(const State* const states, const uint32_t count)
+    {
+        delete[] fHashes;
+        delete[] fSlots;
+        fStates = states;
+        fHashes = nullptr;
+        fSlots = nullptr;
+        fMask = 0;
+
+        if (count == 0)
+            return;
+
+        // keep the table at most half full, so probe sequences stay short
+        uint32_t size = 4;
+        while (size < count * 2)
+            size *= 2;
+
+        fHashes = new uint32_t[count];
+        fSlots = new uint32_t[size];
+        fMask = size - 1;
+        std::memset(fSlots, 0, sizeof(uint32_t) * size);
+
+        for (uint32_t i=0; i < count; ++i)
+        {
+            const String& key(states[i].key);
+            const uint32_t hash = fHashes[i] = getHash(key.buffer(), key.length());
+
+            // slots store index + 1, 0 means empty
+            for (uint32_t slot = hash & fMask;; slot = (slot + 1) & fMask)
+            {
+                if (fSlots[slot] == 0)
+                {
+                    fSlots[slot] = i + 1;
+                    break;
+                }
+
+                // duplicate keys resolve to the first declared state, like the previous linear search
+                if (fHashes[fSlots[slot] - 1] == hash && states[fSlots[slot] - 1].key == key)
+                    break;
+            }
+        }
+    }
+
+    /**
+       Find the index of the state with key @a key.
+       Returns false if there is no such state.
+     */
+    bool find(const StringView& key, uint32_t& index) const noexcept
+    {
+        if (fSlots == nullptr)
+            return false;
+
+        const uint32_t hash = getHash(key.data(), key.length());
+
+        for (uint32_t slot = hash & fMask;; slot = (slot + 1) & fMask)
+        {
+            const uint32_t stateIndex = fSlots[slot];
+
+            if (stateIndex == 0)
+                return false;
+
+            if (fHashes[stateIndex - 1] == hash && StringView(fStates[stateIndex - 1].key) == key)
+            {
+                index = stateIndex - 1;
+                return true;
+            }
+        }
+    }
+
+private:
+    const State* fStates;
+    uint32_t* fHashes;
+    uint32_t* fSlots;
+    uint32_t fMask;
+
+    // FNV-1a
+    static uint32_t getHash(const char* const data, const size_t length) noexcept
+    {
+        uint32_t hash = 2166136261U;
+
+        for (size_t i=0; i < length; ++i)
+        {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 16777619U;
+        }
+
+        return hash;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(StateKeyIndex)
+};
+#endif
+
 // -----------------------------------------------------------------------
 // Plugin private data
 
@@ -165,6 +760,7 @@ struct Plugin::PrivateData {
 #if DISTRHO_PLUGIN_WANT_STATE
     uint32_t stateCount;
     State*   states;
+    StateKeyIndex stateKeyIndex;
 #endif
 
 #if DISTRHO_PLUGIN_WANT_LATENCY
@@ -175,6 +771,25 @@ struct Plugin::PrivateData {
     TimePosition timePosition;
 #endif
 
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION && DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+    // used for converting audio when the plugin does not implement double precision processing
+    float* singlePrecisionBuffers;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    MidiEventPool midiEvents;
+#endif
+
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    ParallelTaskFunc parallelTaskFunc;
+    void* parallelTaskUserData;
+    requestParallelExecutionFunc requestParallelExecutionCallbackFunc;
+# ifdef DPF_PLUGIN_USES_THREAD_POOL
+    // used when the host does not provide its own thread pool
+    ThreadPool threadPool;
+# endif
+#endif
+
     // Callbacks
     void*         callbacksPtr;
     writeMidiFunc writeMidiCallbackFunc;
@@ -183,6 +798,7 @@ struct Plugin::PrivateData {
 
     uint32_t bufferSize;
     double   sampleRate;
+    bool     isOffline;
     char*    bundlePath;
 
     PrivateData() noexcept
@@ -208,6 +824,14 @@ struct Plugin::PrivateData {
 #endif
 #if DISTRHO_PLUGIN_WANT_LATENCY
           latency(0),
+#endif
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION && DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+          singlePrecisionBuffers(nullptr),
+#endif
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+          parallelTaskFunc(nullptr),
+          parallelTaskUserData(nullptr),
+          requestParallelExecutionCallbackFunc(nullptr),
 #endif
           callbacksPtr(nullptr),
           writeMidiCallbackFunc(nullptr),
@@ -215,6 +839,7 @@ struct Plugin::PrivateData {
           updateStateValueCallbackFunc(nullptr),
           bufferSize(d_nextBufferSize),
           sampleRate(d_nextSampleRate),
+          isOffline(false),
           bundlePath(d_nextBundlePath != nullptr ? strdup(d_nextBundlePath) : nullptr)
     {
         DISTRHO_SAFE_ASSERT(bufferSize != 0);
@@ -239,6 +864,14 @@ struct Plugin::PrivateData {
 #ifdef DISTRHO_PLUGIN_TARGET_VST3
         parameterOffset += kVst3InternalParameterCount;
 #endif
+
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION && DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        reallocSinglePrecisionBuffers();
+#endif
+
+#if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        midiEvents.resize(bufferSize);
+#endif
     }
 
     ~PrivateData() noexcept
@@ -279,6 +912,14 @@ struct Plugin::PrivateData {
         }
 #endif
 
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION && DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        if (singlePrecisionBuffers != nullptr)
+        {
+            delete[] singlePrecisionBuffers;
+            singlePrecisionBuffers = nullptr;
+        }
+#endif
+
         if (bundlePath != nullptr)
         {
             std::free(bundlePath);
@@ -286,6 +927,14 @@ struct Plugin::PrivateData {
         }
     }
 
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION && DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+    void reallocSinglePrecisionBuffers()
+    {
+        delete[] singlePrecisionBuffers;
+        singlePrecisionBuffers = new float[(DISTRHO_PLUGIN_NUM_INPUTS + DISTRHO_PLUGIN_NUM_OUTPUTS) * bufferSize];
+    }
+#endif
+
 #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
     bool writeMidiCallback(const MidiEvent& midiEvent)
     {
@@ -296,6 +945,30 @@ struct Plugin::PrivateData {
     }
 #endif
 
+#if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    void requestParallelExecution(const uint32_t numTasks, const ParallelTaskFunc func, void* const userData)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(func != nullptr,);
+
+        if (numTasks == 0)
+            return;
+
+        parallelTaskFunc = func;
+        parallelTaskUserData = userData;
+
+        if (requestParallelExecutionCallbackFunc != nullptr &&
+            requestParallelExecutionCallbackFunc(callbacksPtr, numTasks))
+            return;
+
+       #ifdef DPF_PLUGIN_USES_THREAD_POOL
+        threadPool.parallelFor(numTasks, func, userData);
+       #else
+        for (uint32_t i = 0; i < numTasks; ++i)
+            func(userData, i);
+       #endif
+    }
+#endif
+
 #if DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
     bool requestParameterValueChangeCallback(const uint32_t index, const float value)
     {
@@ -331,7 +1004,7 @@ public:
                    const writeMidiFunc writeMidiCall,
                    const requestParameterValueChangeFunc requestParameterValueChangeCall,
                    const updateStateValueFunc updateStateValueCall)
-        : fPlugin(createPlugin()),
+        : fPlugin(createPluginOrMetadata()),
           fData((fPlugin != nullptr) ? fPlugin->pData : nullptr),
           fIsActive(false)
     {
@@ -394,12 +1067,15 @@ public:
 #if DISTRHO_PLUGIN_WANT_STATE
         for (uint32_t i=0; i < fData->stateCount; ++i)
             fPlugin->initState(i, fData->states[i]);
+
+        fData->stateKeyIndex.setup(fData->states, fData->stateCount);
 #endif
 
 #if defined(DPF_RUNTIME_TESTING) && defined(__GNUC__) && !defined(__clang__)
         /* Run-time testing build.
          * Verify that virtual functions are overriden if parameters, programs or states are in use.
-         * This does not work on all compilers, but we use it purely as informational check anyway. */
+         * This does not work on all compilers, but we use it purely as informational check anyway.
+         * Metadata-only instances are never run, so they only need to implement the `init*` functions. */
         if (fData->parameterCount != 0)
         {
             if ((void*)(fPlugin->*(&Plugin::initParameter)) == (void*)&Plugin::initParameter)
@@ -407,12 +1083,12 @@ public:
                 d_stderr2("DPF warning: Plugins with parameters must implement `initParameter`");
                 abort();
             }
-            if ((void*)(fPlugin->*(&Plugin::getParameterValue)) == (void*)&Plugin::getParameterValue)
+            if ((void*)(fPlugin->*(&Plugin::getParameterValue)) == (void*)&Plugin::getParameterValue && ! d_nextPluginIsMetadataOnly)
             {
                 d_stderr2("DPF warning: Plugins with parameters must implement `getParameterValue`");
                 abort();
             }
-            if ((void*)(fPlugin->*(&Plugin::setParameterValue)) == (void*)&Plugin::setParameterValue)
+            if ((void*)(fPlugin->*(&Plugin::setParameterValue)) == (void*)&Plugin::setParameterValue && ! d_nextPluginIsMetadataOnly)
             {
                 d_stderr2("DPF warning: Plugins with parameters must implement `setParameterValue`");
                 abort();
@@ -427,7 +1103,7 @@ public:
                 d_stderr2("DPF warning: Plugins with programs must implement `initProgramName`");
                 abort();
             }
-            if ((void*)(fPlugin->*(&Plugin::loadProgram)) == (void*)&Plugin::loadProgram)
+            if ((void*)(fPlugin->*(&Plugin::loadProgram)) == (void*)&Plugin::loadProgram && ! d_nextPluginIsMetadataOnly)
             {
                 d_stderr2("DPF warning: Plugins with programs must implement `loadProgram`");
                 abort();
@@ -457,7 +1133,7 @@ public:
                     abort();
                 }
 
-                if ((void*)(fPlugin->*(&Plugin::setState)) == (void*)&Plugin::setState)
+                if ((void*)(fPlugin->*(&Plugin::setState)) == (void*)&Plugin::setState && ! d_nextPluginIsMetadataOnly)
                 {
                     d_stderr2("DPF warning: Plugins with state must implement `setState`");
                     abort();
@@ -469,7 +1145,7 @@ public:
 # if DISTRHO_PLUGIN_WANT_FULL_STATE
         if (fData->stateCount != 0)
         {
-            if ((void*)(fPlugin->*(&Plugin::getState)) == (void*)&Plugin::getState)
+            if ((void*)(fPlugin->*(&Plugin::getState)) == (void*)&Plugin::getState && ! d_nextPluginIsMetadataOnly)
             {
                 d_stderr2("DPF warning: Plugins with full state must implement `getState`");
                 abort();
@@ -772,6 +1448,49 @@ public:
         fPlugin->setParameterValue(index, value);
     }
 
+    void getParameterValues(const uint32_t* const indexes, float* const values, const uint32_t count) const
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+
+        if (count == 0)
+            return;
+
+        for (uint32_t i=0; i < count; ++i)
+        {
+            DISTRHO_SAFE_ASSERT_UINT2_RETURN(indexes[i] < fData->parameterCount, indexes[i], fData->parameterCount,);
+        }
+
+        fPlugin->getParameterValues(indexes, values, count);
+    }
+
+    void setParameterValues(const uint32_t* const indexes, const float* const values, const uint32_t count)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+
+        if (count == 0)
+            return;
+
+        for (uint32_t i=0; i < count; ++i)
+        {
+            DISTRHO_SAFE_ASSERT_UINT2_RETURN(indexes[i] < fData->parameterCount, indexes[i], fData->parameterCount,);
+        }
+
+        fPlugin->setParameterValues(indexes, values, count);
+    }
+
+    // fills in the values of all parameters in the list
+    void getParameterValues(ParameterValueList& list) const
+    {
+        getParameterValues(list.getIndexes(), list.getValues(), list.getCount());
+    }
+
+    void setParameterValues(const ParameterValueList& list)
+    {
+        setParameterValues(list.getIndexes(), list.getValues(), list.getCount());
+    }
+
     /*
     bool getParameterIndexForSymbol(const char* const symbol, uint32_t& index)
     {
@@ -921,18 +1640,18 @@ public:
         fPlugin->setState(key, value);
     }
 
-    bool wantStateKey(const char* const key) const noexcept
+    bool getStateIndex(const StringView& key, uint32_t& index) const noexcept
     {
         DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, false);
-        DISTRHO_SAFE_ASSERT_RETURN(key != nullptr && key[0] != '\0', false);
+        DISTRHO_SAFE_ASSERT_RETURN(key.isNotEmpty(), false);
 
-        for (uint32_t i=0; i < fData->stateCount; ++i)
-        {
-            if (fData->states[i].key == key)
-                return true;
-        }
+        return fData->stateKeyIndex.find(key, index);
+    }
 
-        return false;
+    bool wantStateKey(const StringView& key) const noexcept
+    {
+        uint32_t index;
+        return getStateIndex(key, index);
     }
 #endif
 
@@ -945,6 +1664,20 @@ public:
     }
 #endif
 
+#if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    MidiEventPool& getMidiEventPool() const noexcept
+    {
+        return fData->midiEvents;
+    }
+
+    uint32_t getDroppedMidiEventCount() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
+
+        return fData->midiEvents.getOverflowCount();
+    }
+#endif
+
     // -------------------------------------------------------------------
 
     bool isActive() const noexcept
@@ -952,11 +1685,40 @@ public:
         return fIsActive;
     }
 
+   #if DISTRHO_PLUGIN_WANT_PARALLEL_EXECUTION
+    // -------------------------------------------------------------------
+
+    void setRequestParallelExecutionCallback(const requestParallelExecutionFunc func) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(! fIsActive,);
+
+        fData->requestParallelExecutionCallbackFunc = func;
+    }
+
+    // called from host threads for each task of a parallel execution request
+    void executeParallelTask(const uint32_t taskIndex)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fData->parallelTaskFunc != nullptr,);
+
+        fData->parallelTaskFunc(fData->parallelTaskUserData, taskIndex);
+    }
+   #endif
+
+    // -------------------------------------------------------------------
+
     void activate()
     {
         DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
         DISTRHO_SAFE_ASSERT_RETURN(! fIsActive,);
 
+       #ifdef DPF_PLUGIN_USES_THREAD_POOL
+        // not needed if the host has its own thread pool
+        if (fData->requestParallelExecutionCallbackFunc == nullptr)
+            fData->threadPool.start();
+       #endif
+
         fIsActive = true;
         fPlugin->activate();
     }
@@ -968,6 +1730,14 @@ public:
 
         fIsActive = false;
         fPlugin->deactivate();
+
+       #ifdef DPF_PLUGIN_USES_THREAD_POOL
+        fData->threadPool.stop();
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        reportDroppedMidiEvents();
+       #endif
     }
 
     void deactivateIfNeeded()
@@ -978,6 +1748,14 @@ public:
         {
             fIsActive = false;
             fPlugin->deactivate();
+
+           #ifdef DPF_PLUGIN_USES_THREAD_POOL
+            fData->threadPool.stop();
+           #endif
+
+           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+            reportDroppedMidiEvents();
+           #endif
         }
     }
 
@@ -1016,6 +1794,110 @@ public:
     }
    #endif
 
+   #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    void run(const double** const inputs, double** const outputs, const uint32_t frames,
+             const MidiEvent* const midiEvents, const uint32_t midiEventCount)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+
+        if (! fIsActive)
+        {
+            fIsActive = true;
+            fPlugin->activate();
+        }
+
+        fData->isProcessing = true;
+        fPlugin->run(inputs, outputs, frames, midiEvents, midiEventCount);
+        fData->isProcessing = false;
+    }
+   #else
+    void run(const double** const inputs, double** const outputs, const uint32_t frames)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+
+        if (! fIsActive)
+        {
+            fIsActive = true;
+            fPlugin->activate();
+        }
+
+        fData->isProcessing = true;
+        fPlugin->run(inputs, outputs, frames);
+        fData->isProcessing = false;
+    }
+   #endif
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+    // Run a section of the current audio block, starting at frame @a offset.
+    // Used for splitting host blocks at the position of parameter changes.
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    // MIDI events are consumed from @a midiEventIndex onwards, with their frame made relative to @a offset.
+    // The last sub-block of a cycle takes all remaining MIDI events, so none are lost.
+    template<typename T>
+    void runSubBlock(const T** const inputs, T** const outputs, const uint32_t offset, const uint32_t frames,
+                     MidiEvent* const midiEvents, const uint32_t midiEventCount, uint32_t& midiEventIndex,
+                     const bool lastSubBlock)
+   #else
+    template<typename T>
+    void runSubBlock(const T** const inputs, T** const outputs, const uint32_t offset, const uint32_t frames)
+   #endif
+    {
+        if (frames == 0)
+            return;
+
+       #if DISTRHO_PLUGIN_NUM_INPUTS > 0
+        const T* subInputs[DISTRHO_PLUGIN_NUM_INPUTS];
+
+        for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i)
+            subInputs[i] = inputs[i] != nullptr ? inputs[i] + offset : nullptr;
+       #else
+        const T** const subInputs = inputs;
+       #endif
+
+       #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        T* subOutputs[DISTRHO_PLUGIN_NUM_OUTPUTS];
+
+        for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+            subOutputs[i] = outputs[i] != nullptr ? outputs[i] + offset : nullptr;
+       #else
+        T** const subOutputs = outputs;
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        const uint32_t firstMidiEvent = midiEventIndex;
+        const uint32_t endFrame = offset + frames;
+
+        for (; midiEventIndex < midiEventCount; ++midiEventIndex)
+        {
+            MidiEvent& midiEvent(midiEvents[midiEventIndex]);
+
+            if (midiEvent.frame >= endFrame)
+            {
+                if (! lastSubBlock)
+                    break;
+                midiEvent.frame = frames - 1;
+            }
+            else if (midiEvent.frame > offset)
+            {
+                midiEvent.frame -= offset;
+            }
+            else
+            {
+                midiEvent.frame = 0;
+            }
+        }
+
+        run(subInputs, subOutputs, frames, midiEvents + firstMidiEvent, midiEventIndex - firstMidiEvent);
+       #else
+        run(subInputs, subOutputs, frames);
+       #endif
+    }
+   #endif
+
     // -------------------------------------------------------------------
 
    #ifdef DISTRHO_PLUGIN_TARGET_AU
@@ -1055,6 +1937,13 @@ public:
 
         fData->bufferSize = bufferSize;
 
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION && DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        fData->reallocSinglePrecisionBuffers();
+       #endif
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fData->midiEvents.resize(bufferSize);
+       #endif
+
         if (doCallback)
         {
             if (fIsActive) fPlugin->deactivate();
@@ -1084,6 +1973,40 @@ public:
         }
     }
 
+    bool isOffline() const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, false);
+        return fData->isOffline;
+    }
+
+    void setOffline(const bool offline, const bool doCallback = false)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+
+        if (fData->isOffline == offline)
+            return;
+
+        fData->isOffline = offline;
+
+        if (doCallback)
+        {
+            if (fIsActive) fPlugin->deactivate();
+            fPlugin->processModeChanged(offline);
+            if (fIsActive) fPlugin->activate();
+        }
+    }
+
+    // for a mode previously set without callback, must be called while deactivated
+    void notifyProcessModeChanged()
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(! fIsActive,);
+
+        fPlugin->processModeChanged(fData->isOffline);
+    }
+
 private:
     // -------------------------------------------------------------------
     // Plugin and DistrhoPlugin data
@@ -1092,6 +2015,15 @@ private:
     Plugin::PrivateData* const fData;
     bool fIsActive;
 
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    // report MIDI events dropped during the last activation, once and outside of the audio thread
+    void reportDroppedMidiEvents()
+    {
+        if (const uint32_t count = fData->midiEvents.takeUnreportedOverflowCount())
+            d_stderr2("DPF warning: %u MIDI events were dropped while processing, too many events per audio block", count);
+    }
+   #endif
+
     // -------------------------------------------------------------------
     // Static fallback data, see DistrhoPlugin.cpp
 
@@ -204,24 +204,21 @@ public:
             std::memset(fLastOutputValues, 0, sizeof(float)*count);
 
 #if DISTRHO_PLUGIN_HAS_UI
-            fParametersChanged = new bool[count];
-            std::memset(fParametersChanged, 0, sizeof(bool)*count);
-#endif
+            fParametersChanged.init(count);
+            fOutputParameters.setup(count);
 
             for (uint32_t i=0; i < count; ++i)
             {
-#if DISTRHO_PLUGIN_HAS_UI
-                if (! fPlugin.isParameterOutput(i))
+                if (fPlugin.isParameterOutput(i))
+                    fOutputParameters.add(i);
+                else
                     fUI.parameterChanged(i, fPlugin.getParameterValue(i));
-#endif
             }
+#endif
         }
         else
         {
             fLastOutputValues = nullptr;
-#if DISTRHO_PLUGIN_HAS_UI
-            fParametersChanged = nullptr;
-#endif
         }
 
         jackbridge_set_thread_init_callback(fClient, jackThreadInitCallback, this);
@@ -269,14 +266,6 @@ public:
             fLastOutputValues = nullptr;
         }
 
-#if DISTRHO_PLUGIN_HAS_UI
-        if (fParametersChanged != nullptr)
-        {
-            delete[] fParametersChanged;
-            fParametersChanged = nullptr;
-        }
-#endif
-
         fPlugin.deactivate();
 
         if (fClient == nullptr)
@@ -326,23 +315,22 @@ protected:
         }
 # endif
 
-        for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
+        uint32_t index;
+        while (fParametersChanged.takeNext(index))
+            fUI.parameterChanged(index, fPlugin.getParameterValue(index));
+
+        fPlugin.getParameterValues(fOutputParameters);
+
+        for (uint32_t i=0, count=fOutputParameters.getCount(); i < count; ++i)
         {
-            if (fPlugin.isParameterOutput(i))
-            {
-                const float value = fPlugin.getParameterValue(i);
+            const uint32_t index = fOutputParameters.getIndex(i);
+            const float value = fOutputParameters.getValue(i);
 
-                if (d_isEqual(fLastOutputValues[i], value))
-                    continue;
+            if (d_isEqual(fLastOutputValues[index], value))
+                continue;
 
-                fLastOutputValues[i] = value;
-                fUI.parameterChanged(i, value);
-            }
-            else if (fParametersChanged[i])
-            {
-                fParametersChanged[i] = false;
-                fUI.parameterChanged(i, fPlugin.getParameterValue(i));
-            }
+            fLastOutputValues[index] = value;
+            fUI.parameterChanged(index, value);
         }
 
         fUI.exec_idle();
@@ -428,32 +416,37 @@ protected:
 #endif
 
 #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        uint32_t  midiEventCount = 0;
-        MidiEvent midiEvents[512];
+        MidiEventPool& midiEvents(fPlugin.getMidiEventPool());
+        midiEvents.clear();
 
 # if DISTRHO_PLUGIN_HAS_UI
-        while (fNotesRingBuffer.isDataAvailableForReading())
+        // read notes directly from the ring buffer memory, each note is 3 bytes
+        RingBufferSpan notes;
+        if (const uint32_t notesSize = fNotesRingBuffer.peekRead(notes))
         {
-            uint8_t midiData[3];
-            if (! fNotesRingBuffer.readCustomData(midiData, 3))
-                break;
+            uint32_t offset = 0;
 
-            MidiEvent& midiEvent(midiEvents[midiEventCount++]);
-            midiEvent.frame = 0;
-            midiEvent.size  = 3;
-            std::memcpy(midiEvent.data, midiData, 3);
+            for (; offset + 3 <= notesSize && ! midiEvents.isFull(); offset += 3)
+            {
+                MidiEvent* const midiEvent = midiEvents.allocate();
+                DISTRHO_SAFE_ASSERT_BREAK(midiEvent != nullptr);
+
+                midiEvent->frame = 0;
+                midiEvent->size  = 3;
+
+                for (uint32_t i = 0, pos = offset; i < 3; ++i, ++pos)
+                    midiEvent->data[i] = pos < notes.size1 ? notes.data1[pos] : notes.data2[pos - notes.size1];
+            }
 
-            if (midiEventCount == 512)
-                break;
+            if (offset != 0)
+                fNotesRingBuffer.consumeRead(offset);
         }
 # endif
-#else
-        static const uint32_t midiEventCount = 0;
 #endif
 
         void* const midiInBuf = jackbridge_port_get_buffer(fPortEventsIn, nframes);
 
-        if (const uint32_t eventCount = std::min(512u - midiEventCount, jackbridge_midi_get_event_count(midiInBuf)))
+        if (const uint32_t eventCount = jackbridge_midi_get_event_count(midiInBuf))
         {
             jack_midi_event_t jevent;
 
@@ -481,7 +474,7 @@ protected:
                         const float fvalue = fPlugin.getParameterRanges(j).getUnnormalizedValue(scaled);
                         fPlugin.setParameterValue(j, fvalue);
 #if DISTRHO_PLUGIN_HAS_UI
-                        fParametersChanged[j] = true;
+                        fParametersChanged.mark(j);
 #endif
                         break;
                     }
@@ -503,21 +496,24 @@ protected:
 #endif
 
 #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-                MidiEvent& midiEvent(midiEvents[midiEventCount++]);
+                MidiEvent* const midiEvent = midiEvents.allocate();
+
+                if (midiEvent == nullptr)
+                    continue;
 
-                midiEvent.frame = jevent.time;
-                midiEvent.size  = static_cast<uint32_t>(jevent.size);
+                midiEvent->frame = jevent.time;
+                midiEvent->size  = static_cast<uint32_t>(jevent.size);
 
-                if (midiEvent.size > MidiEvent::kDataSize)
-                    midiEvent.dataExt = jevent.buffer;
+                if (midiEvent->size > MidiEvent::kDataSize)
+                    midiEvent->dataExt = jevent.buffer;
                 else
-                    std::memcpy(midiEvent.data, jevent.buffer, midiEvent.size);
+                    std::memcpy(midiEvent->data, jevent.buffer, midiEvent->size);
 #endif
             }
         }
 
 #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        fPlugin.run(audioIns, audioOuts, nframes, midiEvents, midiEventCount);
+        fPlugin.run(audioIns, audioOuts, nframes, midiEvents.getEvents(), midiEvents.getCount());
 #else
         fPlugin.run(audioIns, audioOuts, nframes);
 #endif
@@ -611,7 +607,8 @@ private:
 
 #if DISTRHO_PLUGIN_HAS_UI
     // Store DSP changes to send to UI
-    bool* fParametersChanged;
+    ParameterChangeTracker fParametersChanged;
+    ParameterValueList fOutputParameters;
 # if DISTRHO_PLUGIN_WANT_PROGRAMS
     int fProgramChanged;
 # endif
@@ -774,7 +771,7 @@ private:
 
         fPlugin.setParameterValue(index, value);
 # if DISTRHO_PLUGIN_HAS_UI
-        fParametersChanged[index] = true;
+        fParametersChanged.mark(index);
 # endif
         return true;
     }
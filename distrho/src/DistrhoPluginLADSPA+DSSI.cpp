@@ -73,10 +73,16 @@ public:
             fPortControls      = new LADSPA_Data*[count];
             fLastControlValues = new LADSPA_Data[count];
 
+            fControlChanges.setup(count);
+            fOutputControls.setup(count);
+
             for (uint32_t i=0; i < count; ++i)
             {
                 fPortControls[i] = nullptr;
                 fLastControlValues[i] = fPlugin.getParameterValue(i);
+
+                if (fPlugin.isParameterOutput(i))
+                    fOutputControls.add(i);
             }
         }
         else
@@ -183,6 +189,8 @@ public:
         // Check for updated parameters
         float curValue;
 
+        fControlChanges.clear();
+
         for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
         {
             if (fPortControls[i] == nullptr)
@@ -193,16 +201,20 @@ public:
             if (fPlugin.isParameterInput(i) && d_isNotEqual(fLastControlValues[i], curValue))
             {
                 fLastControlValues[i] = curValue;
-                fPlugin.setParameterValue(i, curValue);
+                fControlChanges.add(i, curValue);
             }
         }
 
+        fPlugin.setParameterValues(fControlChanges);
+
 #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
         // Get MIDI Events
-        uint32_t  midiEventCount = 0;
-        MidiEvent midiEvents[eventCount];
+        MidiEventPool& midiEvents(fPlugin.getMidiEventPool());
+        midiEvents.clear();
+
+        MidiEvent* midiEvent;
 
-        for (uint32_t i=0, j; i < eventCount; ++i)
+        for (uint32_t i=0; i < eventCount; ++i)
         {
             const snd_seq_event_t& seqEvent(events[i]);
 
@@ -213,64 +225,70 @@ public:
             switch (seqEvent.type)
             {
             case SND_SEQ_EVENT_NOTEOFF:
-                j = midiEventCount++;
-                midiEvents[j].frame   = seqEvent.time.tick;
-                midiEvents[j].size    = 3;
-                midiEvents[j].data[0] = 0x80 + seqEvent.data.note.channel;
-                midiEvents[j].data[1] = seqEvent.data.note.note;
-                midiEvents[j].data[2] = 0;
-                midiEvents[j].data[3] = 0;
+                if ((midiEvent = midiEvents.allocate()) == nullptr)
+                    break;
+                midiEvent->frame   = seqEvent.time.tick;
+                midiEvent->size    = 3;
+                midiEvent->data[0] = 0x80 + seqEvent.data.note.channel;
+                midiEvent->data[1] = seqEvent.data.note.note;
+                midiEvent->data[2] = 0;
+                midiEvent->data[3] = 0;
                 break;
             case SND_SEQ_EVENT_NOTEON:
-                j = midiEventCount++;
-                midiEvents[j].frame   = seqEvent.time.tick;
-                midiEvents[j].size    = 3;
-                midiEvents[j].data[0] = 0x90 + seqEvent.data.note.channel;
-                midiEvents[j].data[1] = seqEvent.data.note.note;
-                midiEvents[j].data[2] = seqEvent.data.note.velocity;
-                midiEvents[j].data[3] = 0;
+                if ((midiEvent = midiEvents.allocate()) == nullptr)
+                    break;
+                midiEvent->frame   = seqEvent.time.tick;
+                midiEvent->size    = 3;
+                midiEvent->data[0] = 0x90 + seqEvent.data.note.channel;
+                midiEvent->data[1] = seqEvent.data.note.note;
+                midiEvent->data[2] = seqEvent.data.note.velocity;
+                midiEvent->data[3] = 0;
                 break;
             case SND_SEQ_EVENT_KEYPRESS:
-                j = midiEventCount++;
-                midiEvents[j].frame   = seqEvent.time.tick;
-                midiEvents[j].size    = 3;
-                midiEvents[j].data[0] = 0xA0 + seqEvent.data.note.channel;
-                midiEvents[j].data[1] = seqEvent.data.note.note;
-                midiEvents[j].data[2] = seqEvent.data.note.velocity;
-                midiEvents[j].data[3] = 0;
+                if ((midiEvent = midiEvents.allocate()) == nullptr)
+                    break;
+                midiEvent->frame   = seqEvent.time.tick;
+                midiEvent->size    = 3;
+                midiEvent->data[0] = 0xA0 + seqEvent.data.note.channel;
+                midiEvent->data[1] = seqEvent.data.note.note;
+                midiEvent->data[2] = seqEvent.data.note.velocity;
+                midiEvent->data[3] = 0;
                 break;
             case SND_SEQ_EVENT_CONTROLLER:
-                j = midiEventCount++;
-                midiEvents[j].frame   = seqEvent.time.tick;
-                midiEvents[j].size    = 3;
-                midiEvents[j].data[0] = 0xB0 + seqEvent.data.control.channel;
-                midiEvents[j].data[1] = seqEvent.data.control.param;
-                midiEvents[j].data[2] = seqEvent.data.control.value;
-                midiEvents[j].data[3] = 0;
+                if ((midiEvent = midiEvents.allocate()) == nullptr)
+                    break;
+                midiEvent->frame   = seqEvent.time.tick;
+                midiEvent->size    = 3;
+                midiEvent->data[0] = 0xB0 + seqEvent.data.control.channel;
+                midiEvent->data[1] = seqEvent.data.control.param;
+                midiEvent->data[2] = seqEvent.data.control.value;
+                midiEvent->data[3] = 0;
                 break;
             case SND_SEQ_EVENT_CHANPRESS:
-                j = midiEventCount++;
-                midiEvents[j].frame   = seqEvent.time.tick;
-                midiEvents[j].size    = 2;
-                midiEvents[j].data[0] = 0xD0 + seqEvent.data.control.channel;
-                midiEvents[j].data[1] = seqEvent.data.control.value;
-                midiEvents[j].data[2] = 0;
-                midiEvents[j].data[3] = 0;
+                if ((midiEvent = midiEvents.allocate()) == nullptr)
+                    break;
+                midiEvent->frame   = seqEvent.time.tick;
+                midiEvent->size    = 2;
+                midiEvent->data[0] = 0xD0 + seqEvent.data.control.channel;
+                midiEvent->data[1] = seqEvent.data.control.value;
+                midiEvent->data[2] = 0;
+                midiEvent->data[3] = 0;
                 break;
             case SND_SEQ_EVENT_PITCHBEND:
-                j = midiEventCount++;
-                midiEvents[j].frame   = seqEvent.time.tick;
-                midiEvents[j].size    = 3;
-                midiEvents[j].data[0] = 0xE0 + seqEvent.data.control.channel;
+                if ((midiEvent = midiEvents.allocate()) == nullptr)
+                    break;
+                midiEvent->frame   = seqEvent.time.tick;
+                midiEvent->size    = 3;
+                midiEvent->data[0] = 0xE0 + seqEvent.data.control.channel;
                 uint16_t tempvalue = seqEvent.data.control.value + 8192;
-                midiEvents[j].data[1] = tempvalue & 0x7F;
-                midiEvents[j].data[2] = tempvalue >> 7;
-                midiEvents[j].data[3] = 0;
+                midiEvent->data[1] = tempvalue & 0x7F;
+                midiEvent->data[2] = tempvalue >> 7;
+                midiEvent->data[3] = 0;
                 break;
             }
         }
 
-        fPlugin.run(fPortAudioIns, fPortAudioOuts, sampleCount, midiEvents, midiEventCount);
+        fPlugin.run(fPortAudioIns, fPortAudioOuts, sampleCount, midiEvents.getEvents(), midiEvents.getCount());
 #else
         fPlugin.run(fPortAudioIns, fPortAudioOuts, sampleCount);
 #endif
@@ -323,15 +341,23 @@ public:
         fPlugin.loadProgram(realProgram);
 
         // Update control inputs
+        fControlChanges.clear();
+
         for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
         {
-            if (fPlugin.isParameterOutput(i))
-                continue;
+            if (fPlugin.isParameterInput(i))
+                fControlChanges.add(i);
+        }
 
-            fLastControlValues[i] = fPlugin.getParameterValue(i);
+        fPlugin.getParameterValues(fControlChanges);
+
+        for (uint32_t i=0, count=fControlChanges.getCount(); i < count; ++i)
+        {
+            const uint32_t index = fControlChanges.getIndex(i);
+            fLastControlValues[index] = fControlChanges.getValue(i);
 
-            if (fPortControls[i] != nullptr)
-                *fPortControls[i] = fLastControlValues[i];
+            if (fPortControls[index] != nullptr)
+                *fPortControls[index] = fLastControlValues[index];
         }
     }
 # endif
@@ -375,6 +401,8 @@ private:
 
     // Temporary data
     LADSPA_Data* fLastControlValues;
+    ParameterValueList fControlChanges;
+    ParameterValueList fOutputControls;
 
     // -------------------------------------------------------------------
 
@@ -382,16 +410,20 @@ private:
     {
         float value;
 
-        for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
+        fPlugin.getParameterValues(fOutputControls);
+
+        for (uint32_t i=0, count=fOutputControls.getCount(); i < count; ++i)
         {
-            if (fPlugin.isParameterOutput(i))
-            {
-                value = fLastControlValues[i] = fPlugin.getParameterValue(i);
+            const uint32_t index = fOutputControls.getIndex(i);
+            value = fLastControlValues[index] = fOutputControls.getValue(i);
 
-                if (fPortControls[i] != nullptr)
-                    *fPortControls[i] = value;
-            }
-            else if ((fPlugin.getParameterHints(i) & kParameterIsTrigger) == kParameterIsTrigger)
+            if (fPortControls[index] != nullptr)
+                *fPortControls[index] = value;
+        }
+
+        for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
+        {
+            if (fPlugin.isParameterInput(i) && (fPlugin.getParameterHints(i) & kParameterIsTrigger) == kParameterIsTrigger)
             {
                 // NOTE: no trigger support in LADSPA control ports, simulate it here
                 value = fPlugin.getParameterRanges(i).def;
@@ -554,10 +586,12 @@ static const struct DescriptorInitializer
         d_nextBufferSize = 512;
         d_nextSampleRate = 44100.0;
         d_nextPluginIsDummy = true;
+        d_nextPluginIsMetadataOnly = true;
         const PluginExporter plugin(nullptr, nullptr, nullptr, nullptr);
         d_nextBufferSize = 0;
         d_nextSampleRate = 0.0;
         d_nextPluginIsDummy = false;
+        d_nextPluginIsMetadataOnly = false;
 
         // Get port count, init
         ulong port = 0;
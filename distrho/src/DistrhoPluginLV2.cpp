@@ -38,6 +38,12 @@
 # include "libmodla.h"
 #endif
 
+#if defined(__SSE2_MATH__)
+# include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+# include <arm_neon.h>
+#endif
+
 #include <map>
 
 #ifndef DISTRHO_PLUGIN_URI
@@ -66,6 +72,56 @@ static const requestParameterValueChangeFunc requestParameterValueChangeCallback
 static const updateStateValueFunc updateStateValueCallback = nullptr;
 #endif
 
+// -----------------------------------------------------------------------
+// Control port change detection, done in blocks so unchanged ports cost very little
+
+static const uint32_t kControlBlockSize = 16;
+
+static inline
+uint32_t getControlBufferSize(const uint32_t count) noexcept
+{
+    return (count + kControlBlockSize - 1) & ~(kControlBlockSize - 1);
+}
+
+// same as d_isNotEqual() on each value, but only tells if any of the block values changed
+static inline
+bool hasChangedControlBlock(const float* const lastValues, const float* const curValues) noexcept
+{
+#if defined(__SSE2_MATH__)
+    const __m128 signMask = _mm_set1_ps(-0.f);
+    const __m128 epsilon = _mm_set1_ps(std::numeric_limits<float>::epsilon());
+    __m128 changed = _mm_setzero_ps();
+
+    for (uint32_t i=0; i < kControlBlockSize; i += 4)
+    {
+        const __m128 diff = _mm_sub_ps(_mm_loadu_ps(curValues + i), _mm_loadu_ps(lastValues + i));
+        changed = _mm_or_ps(changed, _mm_cmpge_ps(_mm_andnot_ps(signMask, diff), epsilon));
+    }
+
+    return _mm_movemask_ps(changed) != 0;
+#elif defined(__ARM_NEON)
+    const float32x4_t epsilon = vdupq_n_f32(std::numeric_limits<float>::epsilon());
+    uint32x4_t changed = vdupq_n_u32(0);
+
+    for (uint32_t i=0; i < kControlBlockSize; i += 4)
+    {
+        const float32x4_t diff = vabdq_f32(vld1q_f32(curValues + i), vld1q_f32(lastValues + i));
+        changed = vorrq_u32(changed, vcgeq_f32(diff, epsilon));
+    }
+
+    const uint32x2_t changed2 = vorr_u32(vget_low_u32(changed), vget_high_u32(changed));
+    return (vget_lane_u32(changed2, 0) | vget_lane_u32(changed2, 1)) != 0;
+#else
+    for (uint32_t i=0; i < kControlBlockSize; ++i)
+    {
+        if (d_isNotEqual(lastValues[i], curValues[i]))
+            return true;
+    }
+
+    return false;
+#endif
+}
+
 // -----------------------------------------------------------------------
 
 class PluginLv2
@@ -82,7 +138,13 @@ public:
           fRunCount(0),
 #endif
           fPortControls(nullptr),
+         #if DISTRHO_PLUGIN_WANT_FREEWHEELING
+          fPortFreeWheeling(nullptr),
+          fNotifiedOffline(false),
+         #endif
           fLastControlValues(nullptr),
+          fCurControlValues(nullptr),
+          fOutputControlsConnected(false),
           fSampleRate(sampleRate),
           fURIDs(uridMap),
 #if DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
@@ -107,19 +169,32 @@ public:
 
         if (const uint32_t count = fPlugin.getParameterCount())
         {
+            // value buffers are padded to a multiple of the block size, extra values are never changed
+            const uint32_t bufferSize = getControlBufferSize(count);
+
             fPortControls      = new float*[count];
-            fLastControlValues = new float[count];
+            fLastControlValues = new float[bufferSize];
+            fCurControlValues  = new float[bufferSize];
+
+            fControlChanges.setup(count);
+            fOutputControls.setup(count);
 
             for (uint32_t i=0; i < count; ++i)
             {
                 fPortControls[i] = nullptr;
-                fLastControlValues[i] = fPlugin.getParameterValue(i);
+                fControlChanges.add(i);
+
+                if (fPlugin.isParameterOutput(i))
+                    fOutputControls.add(i);
             }
-        }
-        else
-        {
-            fPortControls      = nullptr;
-            fLastControlValues = nullptr;
+
+            fPlugin.getParameterValues(fControlChanges);
+
+            for (uint32_t i=0; i < count; ++i)
+                fLastControlValues[i] = fControlChanges.getValue(i);
+
+            for (uint32_t i=count; i < bufferSize; ++i)
+                fLastControlValues[i] = fCurControlValues[i] = 0.0f;
         }
 
 #if DISTRHO_LV2_USE_EVENTS_IN
@@ -174,12 +249,18 @@ public:
             fPortControls = nullptr;
         }
 
-        if (fLastControlValues)
+        if (fLastControlValues != nullptr)
         {
             delete[] fLastControlValues;
             fLastControlValues = nullptr;
         }
 
+        if (fCurControlValues != nullptr)
+        {
+            delete[] fCurControlValues;
+            fCurControlValues = nullptr;
+        }
+
 #if DISTRHO_PLUGIN_WANT_STATE
         if (fNeededUiSends != nullptr)
         {
@@ -251,6 +332,14 @@ public:
         fTimePosition.bbt.beatType     = 4;
         fTimePosition.bbt.ticksPerBeat = 1920.0;
         fTimePosition.bbt.beatsPerMinute = 120.0;
+#endif
+#if DISTRHO_PLUGIN_WANT_FREEWHEELING
+        // freewheeling changes while active are only notified now
+        if (fNotifiedOffline != fPlugin.isOffline())
+        {
+            fNotifiedOffline = fPlugin.isOffline();
+            fPlugin.notifyProcessModeChanged();
+        }
 #endif
         fPlugin.activate();
     }
@@ -317,9 +406,21 @@ public:
             if (port == index++)
             {
                 fPortControls[i] = (float*)dataLocation;
+
+                // new buffer, output values must be written again
+                if (fPlugin.isParameterOutput(i))
+                    fOutputControlsConnected = true;
                 return;
             }
         }
+
+#if DISTRHO_PLUGIN_WANT_FREEWHEELING
+        if (port == index++)
+        {
+            fPortFreeWheeling = (const float*)dataLocation;
+            return;
+        }
+#endif
     }
 
     // -------------------------------------------------------------------
@@ -328,7 +429,8 @@ public:
     {
         // cache midi input and time position first
 #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        uint32_t midiEventCount = 0;
+        MidiEventPool& midiEvents(fPlugin.getMidiEventPool());
+        midiEvents.clear();
 #endif
 
 #if DISTRHO_PLUGIN_WANT_MIDI_INPUT || DISTRHO_PLUGIN_WANT_TIMEPOS
@@ -340,25 +442,25 @@ public:
 # if DISTRHO_PLUGIN_WANT_MIDI_INPUT
             if (event->body.type == fURIDs.midiEvent)
             {
-                if (midiEventCount >= kMaxMidiEvents)
+                MidiEvent* const midiEvent = midiEvents.allocate();
+
+                if (midiEvent == nullptr)
                     continue;
 
                 const uint8_t* const data((const uint8_t*)(event + 1));
 
-                MidiEvent& midiEvent(fMidiEvents[midiEventCount++]);
+                midiEvent->frame = event->time.frames;
+                midiEvent->size  = event->body.size;
 
-                midiEvent.frame = event->time.frames;
-                midiEvent.size  = event->body.size;
-
-                if (midiEvent.size > MidiEvent::kDataSize)
+                if (midiEvent->size > MidiEvent::kDataSize)
                 {
-                    midiEvent.dataExt = data;
-                    std::memset(midiEvent.data, 0, MidiEvent::kDataSize);
+                    midiEvent->dataExt = data;
+                    std::memset(midiEvent->data, 0, MidiEvent::kDataSize);
                 }
                 else
                 {
-                    midiEvent.dataExt = nullptr;
-                    std::memcpy(midiEvent.data, data, midiEvent.size);
+                    midiEvent->dataExt = nullptr;
+                    std::memcpy(midiEvent->data, data, midiEvent->size);
                 }
 
                 continue;
@@ -601,20 +703,42 @@ public:
         }
 #endif
 
-        // Check for updated parameters
-        float curValue;
+#if DISTRHO_PLUGIN_WANT_FREEWHEELING
+        // Check for host freewheeling, which means offline processing.
+        // Only the flag is updated here, processModeChanged() must not be called in the audio thread
+        if (fPortFreeWheeling != nullptr)
+            fPlugin.setOffline(*fPortFreeWheeling > 0.5f);
+#endif
 
-        for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
+        // Check for updated parameters
+        if (const uint32_t count = fPlugin.getParameterCount())
         {
-            if (!getPortControlValue(i, curValue))
-                continue;
+            // gather current values first, outputs and unconnected ports keep their last value
+            for (uint32_t i=0; i < count; ++i)
+            {
+                if (fPlugin.isParameterOutput(i) || ! getPortControlValue(i, fCurControlValues[i]))
+                    fCurControlValues[i] = fLastControlValues[i];
+            }
 
-            if (fPlugin.isParameterInput(i) && d_isNotEqual(fLastControlValues[i], curValue))
+            // then only look closer into blocks that have changes
+            fControlChanges.clear();
+
+            for (uint32_t i=0; i < count; i += kControlBlockSize)
             {
-                fLastControlValues[i] = curValue;
+                if (! hasChangedControlBlock(fLastControlValues + i, fCurControlValues + i))
+                    continue;
 
-                fPlugin.setParameterValue(i, curValue);
+                for (uint32_t j=i, end=std::min(i + kControlBlockSize, count); j < end; ++j)
+                {
+                    if (d_isNotEqual(fLastControlValues[j], fCurControlValues[j]))
+                    {
+                        fLastControlValues[j] = fCurControlValues[j];
+                        fControlChanges.add(j, fCurControlValues[j]);
+                    }
+                }
             }
+
+            fPlugin.setParameterValues(fControlChanges);
         }
 
         // Run plugin
@@ -625,7 +749,7 @@ public:
            #endif
 
            #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-            fPlugin.run(fPortAudioIns, fPortAudioOuts, sampleCount, fMidiEvents, midiEventCount);
+            fPlugin.run(fPortAudioIns, fPortAudioOuts, sampleCount, midiEvents.getEvents(), midiEvents.getCount());
            #else
             fPlugin.run(fPortAudioIns, fPortAudioOuts, sampleCount);
            #endif
@@ -717,85 +841,80 @@ public:
             }
            #endif
 
-            const String& curKey(fPlugin.getStateKey(i));
-
-            for (StringToStringMap::const_iterator cit=fStateMap.begin(), cite=fStateMap.end(); cit != cite; ++cit)
-            {
-                const String& key(cit->first);
-
-                if (curKey != key)
-                    continue;
+            const StringToStringMap::const_iterator cit = fStateMap.find(fPlugin.getStateKey(i));
 
-                const String& value(cit->second);
-
-                // set msg size
-                uint32_t msgSize;
+            if (cit == fStateMap.end())
+                continue;
 
-                if (hints & kStateIsHostReadable)
-                {
-                    // object, prop key, prop urid, value key, value
-                    msgSize = sizeof(LV2_Atom_Object)
-                            + sizeof(LV2_Atom_Property_Body) * 4
-                            + sizeof(LV2_Atom_URID) * 3
-                            + sizeof(LV2_Atom_String)
-                            + value.length() + 1;
-                }
-                else
-                {
-                    // key + value + 2x null terminator + separator
-                    msgSize = static_cast<uint32_t>(key.length()+value.length())+3U;
-                }
+            const String& key(cit->first);
+            const String& value(cit->second);
 
-                if (sizeof(LV2_Atom_Event) + msgSize > capacity - fEventsOutData.offset)
-                {
-                    d_stdout("Sending key '%s' to UI failed, out of space (needs %u bytes)",
-                             key.buffer(), msgSize);
-                    break;
-                }
+            // set msg size
+            uint32_t msgSize;
 
-                // put data
-                aev = (LV2_Atom_Event*)(LV2_ATOM_CONTENTS(LV2_Atom_Sequence, fEventsOutData.port) + fEventsOutData.offset);
-                aev->time.frames = 0;
+            if (hints & kStateIsHostReadable)
+            {
+                // object, prop key, prop urid, value key, value
+                msgSize = sizeof(LV2_Atom_Object)
+                        + sizeof(LV2_Atom_Property_Body) * 4
+                        + sizeof(LV2_Atom_URID) * 3
+                        + sizeof(LV2_Atom_String)
+                        + value.length() + 1;
+            }
+            else
+            {
+                // key + value + 2x null terminator + separator
+                msgSize = static_cast<uint32_t>(key.length()+value.length())+3U;
+            }
 
-                if (hints & kStateIsHostReadable)
-                {
-                    uint8_t* const msgBuf = (uint8_t*)&aev->body;
-                    LV2_Atom_Forge atomForge = fAtomForge;
-                    lv2_atom_forge_set_buffer(&atomForge, msgBuf, msgSize);
+            if (sizeof(LV2_Atom_Event) + msgSize > capacity - fEventsOutData.offset)
+            {
+                d_stdout("Sending key '%s' to UI failed, out of space (needs %u bytes)",
+                         key.buffer(), msgSize);
+                continue;
+            }
 
-                    LV2_Atom_Forge_Frame forgeFrame;
-                    lv2_atom_forge_object(&atomForge, &forgeFrame, 0, fURIDs.patchSet);
+            // put data
+            aev = (LV2_Atom_Event*)(LV2_ATOM_CONTENTS(LV2_Atom_Sequence, fEventsOutData.port) + fEventsOutData.offset);
+            aev->time.frames = 0;
 
-                    lv2_atom_forge_key(&atomForge, fURIDs.patchProperty);
-                    lv2_atom_forge_urid(&atomForge, fUrids[i]);
+            if (hints & kStateIsHostReadable)
+            {
+                uint8_t* const msgBuf = (uint8_t*)&aev->body;
+                LV2_Atom_Forge atomForge = fAtomForge;
+                lv2_atom_forge_set_buffer(&atomForge, msgBuf, msgSize);
 
-                    lv2_atom_forge_key(&atomForge, fURIDs.patchValue);
-                    if ((hints & kStateIsFilenamePath) == kStateIsFilenamePath)
-                        lv2_atom_forge_path(&atomForge, value.buffer(), static_cast<uint32_t>(value.length()+1));
-                    else
-                        lv2_atom_forge_string(&atomForge, value.buffer(), static_cast<uint32_t>(value.length()+1));
+                LV2_Atom_Forge_Frame forgeFrame;
+                lv2_atom_forge_object(&atomForge, &forgeFrame, 0, fURIDs.patchSet);
 
-                    lv2_atom_forge_pop(&atomForge, &forgeFrame);
+                lv2_atom_forge_key(&atomForge, fURIDs.patchProperty);
+                lv2_atom_forge_urid(&atomForge, fUrids[i]);
 
-                    msgSize = ((LV2_Atom*)msgBuf)->size;
-                }
+                lv2_atom_forge_key(&atomForge, fURIDs.patchValue);
+                if ((hints & kStateIsFilenamePath) == kStateIsFilenamePath)
+                    lv2_atom_forge_path(&atomForge, value.buffer(), static_cast<uint32_t>(value.length()+1));
                 else
-                {
-                    aev->body.type = fURIDs.dpfKeyValue;
-                    aev->body.size = msgSize;
+                    lv2_atom_forge_string(&atomForge, value.buffer(), static_cast<uint32_t>(value.length()+1));
 
-                    uint8_t* const msgBuf = LV2_ATOM_BODY(&aev->body);
-                    std::memset(msgBuf, 0, msgSize);
+                lv2_atom_forge_pop(&atomForge, &forgeFrame);
 
-                    // write key and value in atom buffer
-                    std::memcpy(msgBuf, key.buffer(), key.length()+1);
-                    std::memcpy(msgBuf+(key.length()+1), value.buffer(), value.length()+1);
-                }
+                msgSize = ((LV2_Atom*)msgBuf)->size;
+            }
+            else
+            {
+                aev->body.type = fURIDs.dpfKeyValue;
+                aev->body.size = msgSize;
 
-                fEventsOutData.growBy(lv2_atom_pad_size(sizeof(LV2_Atom_Event) + msgSize));
-                fNeededUiSends[i] = false;
-                break;
+                uint8_t* const msgBuf = LV2_ATOM_BODY(&aev->body);
+                std::memset(msgBuf, 0, msgSize);
+
+                // write key and value in atom buffer
+                std::memcpy(msgBuf, key.buffer(), key.length()+1);
+                std::memcpy(msgBuf+(key.length()+1), value.buffer(), value.length()+1);
             }
+
+            fEventsOutData.growBy(lv2_atom_pad_size(sizeof(LV2_Atom_Event) + msgSize));
+            fNeededUiSends[i] = false;
         }
        #endif
 
@@ -885,14 +1004,22 @@ public:
         fPlugin.loadProgram(realProgram);
 
         // Update control inputs
+        fControlChanges.clear();
+
         for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
         {
-            if (fPlugin.isParameterOutput(i))
-                continue;
+            if (fPlugin.isParameterInput(i))
+                fControlChanges.add(i);
+        }
 
-            fLastControlValues[i] = fPlugin.getParameterValue(i);
+        fPlugin.getParameterValues(fControlChanges);
+
+        for (uint32_t i=0, count=fControlChanges.getCount(); i < count; ++i)
+        {
+            const uint32_t index = fControlChanges.getIndex(i);
+            fLastControlValues[index] = fControlChanges.getValue(i);
 
-            setPortControlValue(i, fLastControlValues[i]);
+            setPortControlValue(index, fLastControlValues[index]);
         }
 
        #if DISTRHO_PLUGIN_WANT_FULL_STATE
@@ -927,85 +1054,80 @@ public:
 
         for (uint32_t i=0, count=fPlugin.getStateCount(); i < count; ++i)
         {
-            const String& curKey(fPlugin.getStateKey(i));
+            const StringToStringMap::const_iterator cit = fStateMap.find(fPlugin.getStateKey(i));
 
-            for (StringToStringMap::const_iterator cit=fStateMap.begin(), cite=fStateMap.end(); cit != cite; ++cit)
-            {
-                const String& key(cit->first);
+            if (cit == fStateMap.end())
+                continue;
 
-                if (curKey != key)
-                    continue;
+            const String& key(cit->first);
 
-                const uint32_t hints = fPlugin.getStateHints(i);
+            const uint32_t hints = fPlugin.getStateHints(i);
 
-               #if ! DISTRHO_PLUGIN_HAS_UI && ! DISTRHO_PLUGIN_WANT_DIRECT_ACCESS
-                // do not save UI-only messages if there is no UI available
-                if (hints & kStateIsOnlyForUI)
-                    break;
-               #endif
+           #if ! DISTRHO_PLUGIN_HAS_UI && ! DISTRHO_PLUGIN_WANT_DIRECT_ACCESS
+            // do not save UI-only messages if there is no UI available
+            if (hints & kStateIsOnlyForUI)
+                continue;
+           #endif
 
-                if (hints & kStateIsHostReadable)
-                {
-                    lv2key = DISTRHO_PLUGIN_URI "#";
-                    urid = (hints & kStateIsFilenamePath) == kStateIsFilenamePath
-                         ? fURIDs.atomPath
-                         : fURIDs.atomString;
-                }
-                else
-                {
-                    lv2key = DISTRHO_PLUGIN_LV2_STATE_PREFIX;
-                    urid = fURIDs.atomString;
-                }
+            if (hints & kStateIsHostReadable)
+            {
+                lv2key = DISTRHO_PLUGIN_URI "#";
+                urid = (hints & kStateIsFilenamePath) == kStateIsFilenamePath
+                     ? fURIDs.atomPath
+                     : fURIDs.atomString;
+            }
+            else
+            {
+                lv2key = DISTRHO_PLUGIN_LV2_STATE_PREFIX;
+                urid = fURIDs.atomString;
+            }
 
-                lv2key += key;
+            lv2key += key;
 
-                const String& value(cit->second);
+            const String& value(cit->second);
 
-                if (urid == fURIDs.atomPath)
+            if (urid == fURIDs.atomPath)
+            {
+                const LV2_State_Map_Path* mapPath = nullptr;
+                const LV2_State_Free_Path* freePath = nullptr;
+                for (int i=0; features[i] != nullptr; ++i)
                 {
-                    const LV2_State_Map_Path* mapPath = nullptr;
-                    const LV2_State_Free_Path* freePath = nullptr;
-                    for (int i=0; features[i] != nullptr; ++i)
-                    {
-                        if (std::strcmp(features[i]->URI, LV2_STATE__mapPath) == 0)
-                            mapPath = (const LV2_State_Map_Path*)features[i]->data;
-                        else if (std::strcmp(features[i]->URI, LV2_STATE__freePath) == 0)
-                            freePath = (const LV2_State_Free_Path*)features[i]->data;
-                    }
-
-                    if (char* const abstractPath = mapPath != nullptr
-                                                 ? mapPath->abstract_path(mapPath->handle, value.buffer())
-                                                 : nullptr)
-                    {
-                        // some hosts need +1 for the null terminator, even though the type is string/path
-                        store(handle,
-                              fUridMap->map(fUridMap->handle, lv2key.buffer()),
-                              abstractPath,
-                              std::strlen(abstractPath)+1,
-                              urid,
-                              LV2_STATE_IS_POD|LV2_STATE_IS_PORTABLE);
-
-                        if (freePath != nullptr)
-                            freePath->free_path(freePath->handle, abstractPath);
-                       #ifndef DISTRHO_OS_WINDOWS
-                        else
-                            std::free(abstractPath);
-                       #endif
-
-                        break;
-                    }
+                    if (std::strcmp(features[i]->URI, LV2_STATE__mapPath) == 0)
+                        mapPath = (const LV2_State_Map_Path*)features[i]->data;
+                    else if (std::strcmp(features[i]->URI, LV2_STATE__freePath) == 0)
+                        freePath = (const LV2_State_Free_Path*)features[i]->data;
                 }
 
-                // some hosts need +1 for the null terminator, even though the type is string
-                store(handle,
-                      fUridMap->map(fUridMap->handle, lv2key.buffer()),
-                      value.buffer(),
-                      value.length()+1,
-                      urid,
-                      LV2_STATE_IS_POD|LV2_STATE_IS_PORTABLE);
+                if (char* const abstractPath = mapPath != nullptr
+                                             ? mapPath->abstract_path(mapPath->handle, value.buffer())
+                                             : nullptr)
+                {
+                    // some hosts need +1 for the null terminator, even though the type is string/path
+                    store(handle,
+                          fUridMap->map(fUridMap->handle, lv2key.buffer()),
+                          abstractPath,
+                          std::strlen(abstractPath)+1,
+                          urid,
+                          LV2_STATE_IS_POD|LV2_STATE_IS_PORTABLE);
 
-                break;
+                    if (freePath != nullptr)
+                        freePath->free_path(freePath->handle, abstractPath);
+                   #ifndef DISTRHO_OS_WINDOWS
+                    else
+                        std::free(abstractPath);
+                   #endif
+
+                    continue;
+                }
             }
+
+            // some hosts need +1 for the null terminator, even though the type is string
+            store(handle,
+                  fUridMap->map(fUridMap->handle, lv2key.buffer()),
+                  value.buffer(),
+                  value.length()+1,
+                  urid,
+                  LV2_STATE_IS_POD|LV2_STATE_IS_PORTABLE);
         }
 
         return LV2_STATE_SUCCESS;
@@ -1195,6 +1317,10 @@ private:
     float** fPortAudioOuts;
    #endif
     float** fPortControls;
+   #if DISTRHO_PLUGIN_WANT_FREEWHEELING
+    const float* fPortFreeWheeling;
+    bool fNotifiedOffline;
+   #endif
    #if DISTRHO_LV2_USE_EVENTS_IN
     LV2_Atom_Sequence* fPortEventsIn;
    #endif
@@ -1204,10 +1330,11 @@ private:
 
     // Temporary data
     float* fLastControlValues;
+    float* fCurControlValues;
+    ParameterValueList fControlChanges;
+    ParameterValueList fOutputControls;
+    bool fOutputControlsConnected;
     double fSampleRate;
-   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-    MidiEvent fMidiEvents[kMaxMidiEvents];
-   #endif
    #if DISTRHO_PLUGIN_WANT_TIMEPOS
     TimePosition fTimePosition;
 
@@ -1352,11 +1479,9 @@ private:
         fPlugin.setState(key, newValue);
 
         // save this key if necessary
-        if (fPlugin.wantStateKey(key))
-        {
-            const String dkey(key);
-            fStateMap[dkey] = newValue;
-        }
+        uint32_t index;
+        if (fPlugin.getStateIndex(key, index))
+            fStateMap[fPlugin.getStateKey(index)] = newValue;
     }
 
     bool updateState(const char* const key, const char* const newValue)
@@ -1364,18 +1489,15 @@ private:
         fPlugin.setState(key, newValue);
 
         // key must already exist
-        for (uint32_t i=0, count=fPlugin.getStateCount(); i < count; ++i)
+        uint32_t index;
+        if (fPlugin.getStateIndex(key, index))
         {
-            if (fPlugin.getStateKey(i) == key)
-            {
-                const String dkey(key);
-                fStateMap[dkey] = newValue;
+            fStateMap[fPlugin.getStateKey(index)] = newValue;
 
-                if ((fPlugin.getStateHints(i) & kStateIsOnlyForDSP) == 0x0)
-                    fNeededUiSends[i] = true;
+            if ((fPlugin.getStateHints(index) & kStateIsOnlyForDSP) == 0x0)
+                fNeededUiSends[index] = true;
 
-                return true;
-            }
+            return true;
         }
 
         d_stderr("Failed to find plugin state with key \"%s\"", key);
@@ -1387,20 +1509,25 @@ private:
     {
         float curValue;
 
-        for (uint32_t i=0, count=fPlugin.getParameterCount(); i < count; ++i)
+        fPlugin.getParameterValues(fOutputControls);
+
+        // NOTE: host is responsible for auto-updating trigger control port buffers
+        for (uint32_t i=0, count=fOutputControls.getCount(); i < count; ++i)
         {
-            if (fPlugin.isParameterOutput(i))
-            {
-                curValue = fLastControlValues[i] = fPlugin.getParameterValue(i);
+            const uint32_t index = fOutputControls.getIndex(i);
+            curValue = fOutputControls.getValue(i);
 
-                setPortControlValue(i, curValue);
-            }
-            else if ((fPlugin.getParameterHints(i) & kParameterIsTrigger) == kParameterIsTrigger)
+            // port buffers keep their value between runs, so only write on changes
+            if (fOutputControlsConnected || d_isNotEqual(fLastControlValues[index], curValue))
             {
-                // NOTE: host is responsible for auto-updating control port buffers
+                fLastControlValues[index] = curValue;
+
+                setPortControlValue(index, curValue);
             }
         }
 
+        fOutputControlsConnected = false;
+
        #if DISTRHO_PLUGIN_WANT_LATENCY
         if (fPortLatency != nullptr)
             *fPortLatency = fPlugin.getLatency();
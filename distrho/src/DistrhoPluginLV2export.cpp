@@ -983,6 +983,22 @@ void lv2_generate_ttl(const char* const basename)
                 else
                     pluginString += "    ] ,\n";
             }
+
+           #if DISTRHO_PLUGIN_WANT_FREEWHEELING
+            // placed after parameters so it does not change the index of previously existing ports
+            pluginString += "    lv2:port [\n";
+            pluginString += "        a lv2:InputPort, lv2:ControlPort ;\n";
+            pluginString += "        lv2:index " + String(portIndex) + " ;\n";
+            pluginString += "        lv2:name \"Freewheel\" ;\n";
+            pluginString += "        lv2:symbol \"lv2_freewheel\" ;\n";
+            pluginString += "        lv2:designation lv2:freeWheeling ;\n";
+            pluginString += "        lv2:default 0 ;\n";
+            pluginString += "        lv2:minimum 0 ;\n";
+            pluginString += "        lv2:maximum 1 ;\n";
+            pluginString += "        lv2:portProperty lv2:toggled, <" LV2_PORT_PROPS__notOnGUI "> ;\n";
+            pluginString += "    ] ;\n\n";
+            ++portIndex;
+           #endif
         }
 
         // comment
@@ -1371,6 +1387,9 @@ void lv2_generate_ttl(const char* const basename)
             if (plugin.getParameterDesignation(i) == kParameterDesignationBypass)
                 enabledIndex = i;
         }
+       #if DISTRHO_PLUGIN_WANT_FREEWHEELING
+        jsString += "'lv2_freewheel',";
+       #endif
         jsString += "];\n";
         jsString += "var ei=" + String(enabledIndex != INT32_MAX ? enabledIndex : -1) + ";\n\n";
         jsString += "if(e.type==='start'){\n";
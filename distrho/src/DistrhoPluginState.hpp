@@ -0,0 +1,339 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_PLUGIN_STATE_HPP_INCLUDED
+#define DISTRHO_PLUGIN_STATE_HPP_INCLUDED
+
+#include "../DistrhoUtils.hpp"
+
+#include <vector>
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+// Binary plugin state format, used by VST3 and CLAP when DISTRHO_PLUGIN_WANT_BINARY_STATE is enabled
+
+/* The state starts with a 16 byte header, followed by a list of chunks.
+ * All numbers are 32-bit little-endian values, floats use IEEE 754 single precision.
+ *
+ * header:
+ *   magic   "DPFB"
+ *   version kBinaryStateVersion, readers reject newer versions
+ *   flags   reserved, must be 0
+ *   size    size of all chunks that follow the header
+ *
+ * chunk:
+ *   type    one of BinaryStateChunkType, unknown types must be skipped
+ *   size    size of the chunk data, which is then padded to a multiple of 4 bytes
+ *   data    depends on type:
+ *     program:    program index
+ *     state:      key size (including null terminator), key + '\0', value + '\0'
+ *     parameters: parameter count, raw float values, then each symbol + '\0' in the same order
+ *
+ * The text format previously used always starts with '\0' or '_', so both can be told apart by the first bytes.
+ */
+
+static const char     kBinaryStateMagic[4]  = { 'D', 'P', 'F', 'B' };
+static const uint32_t kBinaryStateVersion   = 1;
+static const uint32_t kBinaryStateHeaderSize = 16;
+
+enum BinaryStateChunkType {
+    kBinaryStateChunkProgram = 1,
+    kBinaryStateChunkState = 2,
+    kBinaryStateChunkParameters = 3
+};
+
+// numbers are always stored as little-endian, regardless of the host byte order
+
+static inline
+void writeBinaryStateUInt(uint8_t* const data, const uint32_t value) noexcept
+{
+    data[0] = static_cast<uint8_t>(value);
+    data[1] = static_cast<uint8_t>(value >> 8);
+    data[2] = static_cast<uint8_t>(value >> 16);
+    data[3] = static_cast<uint8_t>(value >> 24);
+}
+
+static inline
+uint32_t readBinaryStateUInt(const uint8_t* const data) noexcept
+{
+    return static_cast<uint32_t>(data[0])
+         | static_cast<uint32_t>(data[1]) << 8
+         | static_cast<uint32_t>(data[2]) << 16
+         | static_cast<uint32_t>(data[3]) << 24;
+}
+
+static inline
+float readBinaryStateFloat(const uint8_t* const data) noexcept
+{
+    const uint32_t bits = readBinaryStateUInt(data);
+    float value;
+    std::memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Helper class for creating a binary state.
+   Add data in any order and then call finish() to get the final state contents.
+ */
+class BinaryStateWriter
+{
+public:
+    BinaryStateWriter()
+        : fData(kBinaryStateHeaderSize, 0),
+          fParameterCount(0) {}
+
+    void writeProgram(const uint32_t program)
+    {
+        beginChunk(kBinaryStateChunkProgram, sizeof(uint32_t));
+        appendUInt(program);
+    }
+
+    void writeState(const char* const key, const char* const value)
+    {
+        const uint32_t keySize = static_cast<uint32_t>(std::strlen(key)) + 1;
+        const uint32_t valueSize = static_cast<uint32_t>(std::strlen(value)) + 1;
+
+        beginChunk(kBinaryStateChunkState, sizeof(uint32_t) + keySize + valueSize);
+        appendUInt(keySize);
+        appendData(key, keySize);
+        appendData(value, valueSize);
+        pad();
+    }
+
+    void addParameter(const char* const symbol, const float value)
+    {
+        fParameterSymbols.insert(fParameterSymbols.end(), symbol, symbol + std::strlen(symbol) + 1);
+        fParameterValues.push_back(value);
+        ++fParameterCount;
+    }
+
+    /**
+       Write the pending parameters and the header, then return the complete state.
+     */
+    const std::vector<uint8_t>& finish()
+    {
+        if (fParameterCount != 0)
+        {
+            const uint32_t valuesSize = fParameterCount * sizeof(float);
+            const uint32_t symbolsSize = static_cast<uint32_t>(fParameterSymbols.size());
+
+            beginChunk(kBinaryStateChunkParameters, sizeof(uint32_t) + valuesSize + symbolsSize);
+            appendUInt(fParameterCount);
+            for (uint32_t i = 0; i < fParameterCount; ++i)
+                appendFloat(fParameterValues[i]);
+            appendData(fParameterSymbols.data(), symbolsSize);
+            pad();
+
+            fParameterCount = 0;
+        }
+
+        std::memcpy(fData.data(), kBinaryStateMagic, sizeof(kBinaryStateMagic));
+        writeBinaryStateUInt(fData.data() + 4, kBinaryStateVersion);
+        writeBinaryStateUInt(fData.data() + 8, 0);
+        writeBinaryStateUInt(fData.data() + 12, static_cast<uint32_t>(fData.size()) - kBinaryStateHeaderSize);
+
+        return fData;
+    }
+
+private:
+    std::vector<uint8_t> fData;
+    std::vector<char> fParameterSymbols;
+    std::vector<float> fParameterValues;
+    uint32_t fParameterCount;
+
+    void beginChunk(const uint32_t type, const uint32_t size)
+    {
+        fData.reserve(fData.size() + sizeof(uint32_t) * 2 + size + 3);
+        appendUInt(type);
+        appendUInt(size);
+    }
+
+    void appendUInt(const uint32_t value)
+    {
+        uint8_t bytes[sizeof(uint32_t)];
+        writeBinaryStateUInt(bytes, value);
+        appendData(bytes, sizeof(uint32_t));
+    }
+
+    void appendFloat(const float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(float));
+        appendUInt(bits);
+    }
+
+    void appendData(const void* const data, const uint32_t size)
+    {
+        const uint8_t* const bytes = static_cast<const uint8_t*>(data);
+        fData.insert(fData.end(), bytes, bytes + size);
+    }
+
+    void pad()
+    {
+        while (fData.size() % 4 != 0)
+            fData.push_back(0);
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(BinaryStateWriter)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Helper class for reading a binary state, in place.
+   Strings returned by this class point directly into the state data.
+ */
+class BinaryStateReader
+{
+public:
+    /**
+       Check if @a data starts with a valid binary state header.
+       Returns the full state size (including the header), or 0 if this is not a binary state.
+       Only the first kBinaryStateHeaderSize bytes are needed.
+     */
+    static uint32_t getTotalSize(const void* const data, const uint32_t size) noexcept
+    {
+        if (size < kBinaryStateHeaderSize)
+            return 0;
+        if (std::memcmp(data, kBinaryStateMagic, sizeof(kBinaryStateMagic)) != 0)
+            return 0;
+
+        const uint8_t* const header = static_cast<const uint8_t*>(data);
+        const uint32_t version = readBinaryStateUInt(header + 4);
+        const uint32_t chunksSize = readBinaryStateUInt(header + 12);
+
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(version <= kBinaryStateVersion, version, kBinaryStateVersion, 0);
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(chunksSize <= UINT32_MAX - kBinaryStateHeaderSize, chunksSize, 0);
+
+        return kBinaryStateHeaderSize + chunksSize;
+    }
+
+    /**
+       Constructor, @a data must contain the full state as indicated by getTotalSize().
+     */
+    BinaryStateReader(const uint8_t* const data, const uint32_t size) noexcept
+        : fData(data),
+          fSize(size),
+          fOffset(kBinaryStateHeaderSize) {}
+
+    /**
+       Get the next chunk, returning false once there are no more chunks or the data is malformed.
+     */
+    bool readChunk(uint32_t& type, const uint8_t*& data, uint32_t& size) noexcept
+    {
+        if (fOffset + sizeof(uint32_t) * 2 > fSize)
+            return false;
+
+        type = readBinaryStateUInt(fData + fOffset);
+        size = readBinaryStateUInt(fData + fOffset + sizeof(uint32_t));
+        fOffset += sizeof(uint32_t) * 2;
+
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(size <= fSize - fOffset, size, fSize - fOffset, false);
+
+        data = fData + fOffset;
+        fOffset += (size + 3) & ~3u;
+        return true;
+    }
+
+    static bool parseProgram(const uint8_t* const data, const uint32_t size, uint32_t& program) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(size == sizeof(uint32_t), size, false);
+
+        program = readBinaryStateUInt(data);
+        return true;
+    }
+
+    static bool parseState(const uint8_t* const data, const uint32_t size,
+                           const char*& key, const char*& value) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(size >= sizeof(uint32_t) + 2, size, false);
+
+        const uint32_t keySize = readBinaryStateUInt(data);
+
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(keySize != 0 && keySize < size - sizeof(uint32_t), keySize, size, false);
+
+        key = reinterpret_cast<const char*>(data + sizeof(uint32_t));
+        value = key + keySize;
+
+        // both strings must be null terminated within the chunk
+        DISTRHO_SAFE_ASSERT_RETURN(key[keySize - 1] == '\0', false);
+        DISTRHO_SAFE_ASSERT_RETURN(data[size - 1] == '\0', false);
+
+        return true;
+    }
+
+    /**
+       Parameter list contained in a parameters chunk.
+     */
+    struct Parameters {
+        uint32_t count;
+        const uint8_t* values;
+        const char* symbols;
+        const char* symbolsEnd;
+
+        /**
+           Get the next parameter symbol and value, returning false once all have been read.
+         */
+        bool next(const char*& symbol, float& value) noexcept
+        {
+            if (count == 0 || symbols >= symbolsEnd)
+                return false;
+
+            const char* const end = static_cast<const char*>(std::memchr(symbols, '\0',
+                                                                         static_cast<size_t>(symbolsEnd - symbols)));
+            DISTRHO_SAFE_ASSERT_RETURN(end != nullptr, false);
+
+            symbol = symbols;
+            value = readBinaryStateFloat(values);
+
+            symbols = end + 1;
+            values += sizeof(float);
+            --count;
+            return true;
+        }
+    };
+
+    static bool parseParameters(const uint8_t* const data, const uint32_t size, Parameters& params) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(size >= sizeof(uint32_t), size, false);
+
+        params.count = readBinaryStateUInt(data);
+
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(params.count <= (size - sizeof(uint32_t)) / sizeof(float),
+                                         params.count, size, false);
+
+        params.values = data + sizeof(uint32_t);
+        params.symbols = reinterpret_cast<const char*>(params.values + params.count * sizeof(float));
+        params.symbolsEnd = reinterpret_cast<const char*>(data + size);
+        return true;
+    }
+
+private:
+    const uint8_t* const fData;
+    const uint32_t fSize;
+    uint32_t fOffset;
+
+    DISTRHO_DECLARE_NON_COPYABLE(BinaryStateReader)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DISTRHO_PLUGIN_STATE_HPP_INCLUDED
@@ -106,7 +106,7 @@ struct ParameterAndNotesHelper
 {
     float* parameterValues;
   #if DISTRHO_PLUGIN_HAS_UI
-    bool* parameterChecks;
+    ParameterChangeTracker parameterChecks;
    #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
     SmallStackBuffer notesRingBuffer;
    #endif
@@ -115,7 +115,7 @@ struct ParameterAndNotesHelper
     ParameterAndNotesHelper()
         : parameterValues(nullptr)
       #if DISTRHO_PLUGIN_HAS_UI
-        , parameterChecks(nullptr)
+        , parameterChecks()
        #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
         , notesRingBuffer(CPP_AGGREGATE_INIT(SmallStackBuffer){0, 0, 0, false, {0}})
        #endif
@@ -130,13 +130,6 @@ struct ParameterAndNotesHelper
             delete[] parameterValues;
             parameterValues = nullptr;
         }
-       #if DISTRHO_PLUGIN_HAS_UI
-        if (parameterChecks != nullptr)
-        {
-            delete[] parameterChecks;
-            parameterChecks = nullptr;
-        }
-       #endif
     }
 
    #if DISTRHO_PLUGIN_WANT_STATE
@@ -191,14 +184,9 @@ public:
 
     void idle()
     {
-        for (uint32_t i=0, count = fPlugin->getParameterCount(); i < count; ++i)
-        {
-            if (fUiHelper->parameterChecks[i])
-            {
-                fUiHelper->parameterChecks[i] = false;
-                fUI.parameterChanged(i, fUiHelper->parameterValues[i]);
-            }
-        }
+        uint32_t index;
+        while (fUiHelper->parameterChecks.takeNext(index))
+            fUI.parameterChanged(index, fUiHelper->parameterValues[index]);
 
         fUI.plugin_idle();
     }
@@ -389,6 +377,9 @@ public:
         : fPlugin(this, writeMidiCallback, requestParameterValueChangeCallback, nullptr),
           fAudioMaster(audioMaster),
           fEffect(effect)
+         #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        , fMidiEvents(fPlugin.getMidiEventPool())
+         #endif
     {
         std::memset(fProgramName, 0, sizeof(fProgramName));
         std::strcpy(fProgramName, "Default");
@@ -401,11 +392,11 @@ public:
 
             for (uint32_t i = 0; i < parameterCount; ++i)
                 parameterValues[i] = fPlugin.getParameterDefault(i);
-        }
 
-       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        fMidiEventCount = 0;
-       #endif
+           #if DISTRHO_PLUGIN_WANT_STATE
+            fParameterChanges.setup(parameterCount);
+           #endif
+        }
 
       #if DISTRHO_PLUGIN_HAS_UI
         fVstUI           = nullptr;
@@ -416,10 +407,7 @@ public:
         fLastScaleFactor = 0.0f;
 
         if (parameterCount != 0)
-        {
-            parameterChecks = new bool[parameterCount];
-            memset(parameterChecks, 0, sizeof(bool)*parameterCount);
-        }
+            parameterChecks.init(parameterCount);
 
       #ifdef DISTRHO_OS_MAC
        #ifdef __LP64__
@@ -551,7 +539,7 @@ public:
             if (value != 0)
             {
                #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-                fMidiEventCount = 0;
+                fMidiEvents.clear();
 
                 // tell host we want MIDI events
                 hostCallback(VST_HOST_OPCODE_06);
@@ -734,16 +722,24 @@ public:
                     // add another separator
                     chunkStr += "\xff";
 
+                    // get all parameter values in a single call
+                    fParameterChanges.clear();
+
                     for (uint32_t i=0; i<paramCount; ++i)
                     {
-                        if (fPlugin.isParameterOutputOrTrigger(i))
-                            continue;
+                        if (! fPlugin.isParameterOutputOrTrigger(i))
+                            fParameterChanges.add(i);
+                    }
+
+                    fPlugin.getParameterValues(fParameterChanges);
 
+                    for (uint32_t i=0, count=fParameterChanges.getCount(); i<count; ++i)
+                    {
                         // join key and value
                         String tmpStr;
-                        tmpStr  = fPlugin.getParameterSymbol(i);
+                        tmpStr  = fPlugin.getParameterSymbol(fParameterChanges.getIndex(i));
                         tmpStr += "\xff";
-                        tmpStr += String(fPlugin.getParameterValue(i));
+                        tmpStr += String(fParameterChanges.getValue(i));
                         tmpStr += "\xff";
 
                         chunkStr += tmpStr;
@@ -812,6 +808,9 @@ public:
                 ++key;
                 float fvalue;
 
+                // parameter values are collected and given to the plugin all at once at the end
+                fParameterChanges.clear();
+
                 while (bytesRead < chunkSize)
                 {
                     if (key[0] == '\0')
@@ -839,11 +838,7 @@ public:
                             fvalue = std::atof(value);
                         }
 
-                        fPlugin.setParameterValue(i, fvalue);
-                       #if DISTRHO_PLUGIN_HAS_UI
-                        if (fVstUI != nullptr)
-                            setParameterValueFromPlugin(i, fvalue);
-                       #endif
+                        fParameterChanges.add(i, fvalue);
                         break;
                     }
 
@@ -852,6 +847,16 @@ public:
                     key  = value + size;
                     bytesRead += size;
                 }
+
+                fPlugin.setParameterValues(fParameterChanges);
+
+               #if DISTRHO_PLUGIN_HAS_UI
+                if (fVstUI != nullptr)
+                {
+                    for (uint32_t i=0, count=fParameterChanges.getCount(); i<count; ++i)
+                        setParameterValueFromPlugin(fParameterChanges.getIndex(i), fParameterChanges.getValue(i));
+                }
+               #endif
             }
 
             return 1;
@@ -879,15 +884,17 @@ public:
                         break;
                     if (vstEvent->type != 1)
                         continue;
-                    if (fMidiEventCount >= kMaxMidiEvents)
-                        break;
+
+                    MidiEvent* const midiEvent = fMidiEvents.allocate();
+
+                    if (midiEvent == nullptr)
+                        continue;
 
                     const VstMidiEvent& vstMidiEvent(events->events[i]->midi);
 
-                    MidiEvent& midiEvent(fMidiEvents[fMidiEventCount++]);
-                    midiEvent.frame  = vstMidiEvent.deltaFrames;
-                    midiEvent.size   = 3;
-                    std::memcpy(midiEvent.data, vstMidiEvent.midiData, sizeof(uint8_t)*3);
+                    midiEvent->frame  = vstMidiEvent.deltaFrames;
+                    midiEvent->size   = 3;
+                    std::memcpy(midiEvent->data, vstMidiEvent.midiData, sizeof(uint8_t)*3);
                 }
             }
             break;
@@ -1071,29 +1078,31 @@ public:
 
       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
        #if DISTRHO_PLUGIN_HAS_UI
-        if (fMidiEventCount != kMaxMidiEvents && fNotesRingBuffer.isDataAvailableForReading())
+        if (! fMidiEvents.isFull() && fNotesRingBuffer.isDataAvailableForReading())
         {
             uint8_t midiData[3];
-            const uint32_t frame = fMidiEventCount != 0 ? fMidiEvents[fMidiEventCount - 1].frame : 0;
+            const uint32_t frame = fMidiEvents.getLastFrame();
 
             while (fNotesRingBuffer.isDataAvailableForReading())
             {
                 if (! fNotesRingBuffer.readCustomData(midiData, 3))
                     break;
 
-                MidiEvent& midiEvent(fMidiEvents[fMidiEventCount++]);
-                midiEvent.frame = frame;
-                midiEvent.size  = 3;
-                std::memcpy(midiEvent.data, midiData, 3);
+                MidiEvent* const midiEvent = fMidiEvents.allocate();
+                DISTRHO_SAFE_ASSERT_BREAK(midiEvent != nullptr);
+
+                midiEvent->frame = frame;
+                midiEvent->size  = 3;
+                std::memcpy(midiEvent->data, midiData, 3);
 
-                if (fMidiEventCount == kMaxMidiEvents)
+                if (fMidiEvents.isFull())
                     break;
             }
         }
        #endif
 
-        fPlugin.run(inputs, outputs, sampleFrames, fMidiEvents, fMidiEventCount);
-        fMidiEventCount = 0;
+        fPlugin.run(inputs, outputs, sampleFrames, fMidiEvents.getEvents(), fMidiEvents.getCount());
+        fMidiEvents.clear();
       #else
         fPlugin.run(inputs, outputs, sampleFrames);
       #endif
@@ -1117,8 +1126,7 @@ private:
     char fProgramName[32];
 
    #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-    uint32_t  fMidiEventCount;
-    MidiEvent fMidiEvents[kMaxMidiEvents];
+    MidiEventPool& fMidiEvents;
    #endif
 
    #if DISTRHO_PLUGIN_WANT_TIMEPOS
@@ -1141,6 +1149,7 @@ private:
    #if DISTRHO_PLUGIN_WANT_STATE
     char*     fStateChunk;
     StringMap fStateMap;
+    ParameterValueList fParameterChanges; // for batched state save and restore
    #endif
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -1217,7 +1226,7 @@ private:
     void setParameterValueFromPlugin(const uint32_t index, const float realValue)
     {
         parameterValues[index] = realValue;
-        parameterChecks[index] = true;
+        parameterChecks.mark(index);
     }
    #endif
 
@@ -1276,11 +1285,9 @@ private:
         fPlugin.setState(key, value);
 
         // check if we want to save this key
-        if (fPlugin.wantStateKey(key))
-        {
-            const String dkey(key);
-            fStateMap[dkey] = value;
-        }
+        uint32_t index;
+        if (fPlugin.getStateIndex(key, index))
+            fStateMap[fPlugin.getStateKey(index)] = value;
     }
   #endif
 };
@@ -1630,6 +1637,7 @@ const vst_effect* VSTPluginMain(const vst_host_callback audioMaster)
         d_nextBufferSize = 512;
         d_nextSampleRate = 44100.0;
         d_nextPluginIsDummy = true;
+        d_nextPluginIsMetadataOnly = true;
         d_nextCanRequestParameterValueChanges = true;
 
         // Create dummy plugin to get data from
@@ -1639,6 +1647,7 @@ const vst_effect* VSTPluginMain(const vst_host_callback audioMaster)
         d_nextBufferSize = 0;
         d_nextSampleRate = 0.0;
         d_nextPluginIsDummy = false;
+        d_nextPluginIsMetadataOnly = false;
         d_nextCanRequestParameterValueChanges = false;
     }
 
@@ -37,6 +37,7 @@
  */
 
 #include "DistrhoPluginInternal.hpp"
+#include "DistrhoPluginState.hpp"
 #include "../DistrhoPluginUtils.hpp"
 #include "../extra/ScopedPointer.hpp"
 
@@ -247,6 +248,26 @@ const char* tuid2str(const v3_tuid iid)
     return buf;
 }
 
+template<typename T>
+static inline
+T** getChannelBuffers(const v3_audio_bus_buffers& buffers) noexcept;
+
+template<>
+inline
+float** getChannelBuffers<float>(const v3_audio_bus_buffers& buffers) noexcept
+{
+    return buffers.channel_buffers_32;
+}
+
+#if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+template<>
+inline
+double** getChannelBuffers<double>(const v3_audio_bus_buffers& buffers) noexcept
+{
+    return buffers.channel_buffers_64;
+}
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // dpf_plugin_view_create (implemented on UI side)
 
@@ -300,6 +321,7 @@ class PluginVst3
    #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
     /* Handy class for storing and sorting VST3 events and MIDI CC parameters.
      * It will only store events for which a MIDI conversion is possible.
+     * Its capacity follows the plugin MIDI event pool, events that do not fit are counted as dropped there.
      */
     struct InputEventList {
         enum Type {
@@ -321,99 +343,137 @@ class PluginVst3
                 v3_event_poly_pressure polyPressure;
                 uint8_t midi[3];
             };
-        } eventListStorage[kMaxMidiEvents];
+        }* eventListStorage;
 
         struct InputEvent {
             int32_t sampleOffset;
             const InputEventStorage* storage;
             InputEvent* next;
-        } eventList[kMaxMidiEvents];
+        }* eventList;
 
-        uint16_t numUsed;
+        uint32_t capacity;
+        uint32_t numUsed;
+        uint32_t numDropped;
         int32_t firstSampleOffset;
         int32_t lastSampleOffset;
         InputEvent* firstEvent;
         InputEvent* lastEvent;
 
+        InputEventList()
+            : eventListStorage(nullptr),
+              eventList(nullptr),
+              capacity(0),
+              numUsed(0),
+              numDropped(0),
+              firstSampleOffset(0),
+              lastSampleOffset(0),
+              firstEvent(nullptr),
+              lastEvent(nullptr) {}
+
+        ~InputEventList()
+        {
+            delete[] eventListStorage;
+            delete[] eventList;
+        }
+
+        // must not be called during processing
+        void resize(const uint32_t newCapacity)
+        {
+            if (capacity >= newCapacity)
+                return;
+
+            delete[] eventListStorage;
+            delete[] eventList;
+            eventListStorage = new InputEventStorage[newCapacity];
+            eventList = new InputEvent[newCapacity];
+            capacity = newCapacity;
+            init();
+        }
+
         void init()
         {
-            numUsed = 0;
+            numUsed = numDropped = 0;
             firstSampleOffset = lastSampleOffset = 0;
             firstEvent = nullptr;
         }
 
-        uint32_t convert(MidiEvent midiEvents[kMaxMidiEvents]) const noexcept
+        bool isFull() const noexcept
         {
-            uint32_t count = 0;
+            return numUsed == capacity;
+        }
+
+        void convert(MidiEventPool& midiEvents) const noexcept
+        {
+            midiEvents.addOverflowCount(numDropped);
 
             for (const InputEvent* event = firstEvent; event != nullptr; event = event->next)
             {
-                MidiEvent& midiEvent(midiEvents[count++]);
-                midiEvent.frame = event->sampleOffset;
+                MidiEvent* const midiEvent = midiEvents.allocate();
+                DISTRHO_SAFE_ASSERT_BREAK(midiEvent != nullptr);
+
+                midiEvent->frame = event->sampleOffset;
 
                 const InputEventStorage& eventStorage(*event->storage);
 
                 switch (eventStorage.type)
                 {
                 case NoteOn:
-                    midiEvent.size = 3;
-                    midiEvent.data[0] = 0x90 | (eventStorage.noteOn.channel & 0xf);
-                    midiEvent.data[1] = eventStorage.noteOn.pitch;
-                    midiEvent.data[2] = std::max(0, std::min(127, d_roundToIntPositive(eventStorage.noteOn.velocity * 127)));
-                    midiEvent.data[3] = 0;
+                    midiEvent->size = 3;
+                    midiEvent->data[0] = 0x90 | (eventStorage.noteOn.channel & 0xf);
+                    midiEvent->data[1] = eventStorage.noteOn.pitch;
+                    midiEvent->data[2] = std::max(0, std::min(127, d_roundToIntPositive(eventStorage.noteOn.velocity * 127)));
+                    midiEvent->data[3] = 0;
                     break;
                 case NoteOff:
-                    midiEvent.size = 3;
-                    midiEvent.data[0] = 0x80 | (eventStorage.noteOff.channel & 0xf);
-                    midiEvent.data[1] = eventStorage.noteOff.pitch;
-                    midiEvent.data[2] = std::max(0, std::min(127, d_roundToIntPositive(eventStorage.noteOff.velocity * 127)));
-                    midiEvent.data[3] = 0;
+                    midiEvent->size = 3;
+                    midiEvent->data[0] = 0x80 | (eventStorage.noteOff.channel & 0xf);
+                    midiEvent->data[1] = eventStorage.noteOff.pitch;
+                    midiEvent->data[2] = std::max(0, std::min(127, d_roundToIntPositive(eventStorage.noteOff.velocity * 127)));
+                    midiEvent->data[3] = 0;
                     break;
                 /* TODO
                 case SysexData:
                     break;
                 */
                 case PolyPressure:
-                    midiEvent.size = 3;
-                    midiEvent.data[0] = 0xA0 | (eventStorage.polyPressure.channel & 0xf);
-                    midiEvent.data[1] = eventStorage.polyPressure.pitch;
-                    midiEvent.data[2] = std::max(0, std::min(127, d_roundToIntPositive(eventStorage.polyPressure.pressure * 127)));
-                    midiEvent.data[3] = 0;
+                    midiEvent->size = 3;
+                    midiEvent->data[0] = 0xA0 | (eventStorage.polyPressure.channel & 0xf);
+                    midiEvent->data[1] = eventStorage.polyPressure.pitch;
+                    midiEvent->data[2] = std::max(0, std::min(127, d_roundToIntPositive(eventStorage.polyPressure.pressure * 127)));
+                    midiEvent->data[3] = 0;
                     break;
                 case CC_Normal:
-                    midiEvent.size = 3;
-                    midiEvent.data[0] = 0xB0 | (eventStorage.midi[0] & 0xf);
-                    midiEvent.data[1] = eventStorage.midi[1];
-                    midiEvent.data[2] = eventStorage.midi[2];
+                    midiEvent->size = 3;
+                    midiEvent->data[0] = 0xB0 | (eventStorage.midi[0] & 0xf);
+                    midiEvent->data[1] = eventStorage.midi[1];
+                    midiEvent->data[2] = eventStorage.midi[2];
                     break;
                 case CC_ChannelPressure:
-                    midiEvent.size = 2;
-                    midiEvent.data[0] = 0xD0 | (eventStorage.midi[0] & 0xf);
-                    midiEvent.data[1] = eventStorage.midi[1];
-                    midiEvent.data[2] = 0;
+                    midiEvent->size = 2;
+                    midiEvent->data[0] = 0xD0 | (eventStorage.midi[0] & 0xf);
+                    midiEvent->data[1] = eventStorage.midi[1];
+                    midiEvent->data[2] = 0;
                     break;
                 case CC_Pitchbend:
-                    midiEvent.size = 3;
-                    midiEvent.data[0] = 0xE0 | (eventStorage.midi[0] & 0xf);
-                    midiEvent.data[1] = eventStorage.midi[1];
-                    midiEvent.data[2] = eventStorage.midi[2];
+                    midiEvent->size = 3;
+                    midiEvent->data[0] = 0xE0 | (eventStorage.midi[0] & 0xf);
+                    midiEvent->data[1] = eventStorage.midi[1];
+                    midiEvent->data[2] = eventStorage.midi[2];
                     break;
                 case UI_MIDI:
-                    midiEvent.size = 3;
-                    midiEvent.data[0] = eventStorage.midi[0];
-                    midiEvent.data[1] = eventStorage.midi[1];
-                    midiEvent.data[2] = eventStorage.midi[2];
+                    midiEvent->size = 3;
+                    midiEvent->data[0] = eventStorage.midi[0];
+                    midiEvent->data[1] = eventStorage.midi[1];
+                    midiEvent->data[2] = eventStorage.midi[2];
                     break;
                 default:
-                    midiEvent.size = 0;
+                    midiEvent->size = 0;
                     break;
                 }
             }
-
-            return count;
         }
 
-        bool appendEvent(const v3_event& event) noexcept
+        void appendEvent(const v3_event& event) noexcept
         {
             // only save events that can be converted directly into MIDI
             switch (event.type)
@@ -424,7 +484,13 @@ class PluginVst3
             case V3_EVENT_POLY_PRESSURE:
                 break;
             default:
-                return false;
+                return;
+            }
+
+            if (isFull())
+            {
+                ++numDropped;
+                return;
             }
 
             InputEventStorage& eventStorage(eventListStorage[numUsed]);
@@ -448,17 +514,23 @@ class PluginVst3
                 eventStorage.polyPressure = event.poly_pressure;
                 break;
             default:
-                return false;
+                return;
             }
 
             eventList[numUsed].sampleOffset = event.sample_offset;
             eventList[numUsed].storage = &eventStorage;
 
-            return placeSorted(event.sample_offset);
+            placeSorted(event.sample_offset);
         }
 
-        bool appendCC(const int32_t sampleOffset, v3_param_id paramId, const double normalized) noexcept
+        void appendCC(const int32_t sampleOffset, v3_param_id paramId, const double normalized) noexcept
         {
+            if (isFull())
+            {
+                ++numDropped;
+                return;
+            }
+
             InputEventStorage& eventStorage(eventListStorage[numUsed]);
 
             paramId -= kVst3InternalParameterMidiCC_start;
@@ -489,12 +561,12 @@ class PluginVst3
             eventList[numUsed].sampleOffset = sampleOffset;
             eventList[numUsed].storage = &eventStorage;
 
-            return placeSorted(sampleOffset);
+            placeSorted(sampleOffset);
         }
 
        #if DISTRHO_PLUGIN_HAS_UI
-        // NOTE always runs first
-        bool appendFromUI(const uint8_t midiData[3])
+        // NOTE always runs first, and only while not full
+        void appendFromUI(const uint8_t midiData[3])
         {
             InputEventStorage& eventStorage(eventListStorage[numUsed]);
 
@@ -517,12 +589,12 @@ class PluginVst3
                 lastEvent = event;
             }
 
-            return ++numUsed == kMaxMidiEvents;
+            ++numUsed;
         }
        #endif
 
     private:
-        bool placeSorted(const int32_t sampleOffset) noexcept
+        void placeSorted(const int32_t sampleOffset) noexcept
         {
             InputEvent* const event = &eventList[numUsed];
 
@@ -570,14 +642,16 @@ class PluginVst3
                     }
                 }
 
-                DISTRHO_SAFE_ASSERT_RETURN(event2 != nullptr, true);
+                DISTRHO_SAFE_ASSERT_RETURN(event2 != nullptr,);
 
                 event->next = event2->next;
                 event2->next = event;
             }
 
-            return ++numUsed == kMaxMidiEvents;
+            ++numUsed;
         }
+
+        DISTRHO_DECLARE_NON_COPYABLE(InputEventList)
     } inputEventList;
    #endif // DISTRHO_PLUGIN_WANT_MIDI_INPUT
 
@@ -596,12 +670,15 @@ public:
           fVst3ParameterCount(fParameterCount + kVst3InternalParameterCount),
           fCachedParameterValues(nullptr),
           fDummyAudioBuffer(nullptr),
-          fParameterValuesChangedDuringProcessing(nullptr)
+          fParameterValuesChangedDuringProcessing()
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        , fParameterQueues(nullptr)
+       #endif
        #if DPF_VST3_USES_SEPARATE_CONTROLLER
         , fIsComponent(isComponent)
        #endif
        #if DISTRHO_PLUGIN_HAS_UI
-        , fParameterValueChangesForUI(nullptr)
+        , fParameterValueChangesForUI()
         , fConnectedToUI(false)
        #endif
        #if DISTRHO_PLUGIN_WANT_LATENCY
@@ -646,15 +723,31 @@ public:
             for (uint32_t i=0; i < fParameterCount; ++i)
                 fCachedParameterValues[kVst3InternalParameterBaseCount + i] = fPlugin.getParameterDefault(i);
 
-            fParameterValuesChangedDuringProcessing = new bool[extraParameterCount];
-            std::memset(fParameterValuesChangedDuringProcessing, 0, sizeof(bool)*extraParameterCount);
+            fParameterValuesChangedDuringProcessing.init(extraParameterCount);
+
+            fParameterChanges.setup(fParameterCount);
+            fOutputParameters.setup(fParameterCount);
+
+            for (uint32_t i=0; i < fParameterCount; ++i)
+            {
+                if (fPlugin.isParameterOutputOrTrigger(i))
+                    fOutputParameters.add(i);
+            }
 
            #if DISTRHO_PLUGIN_HAS_UI
-            fParameterValueChangesForUI = new bool[extraParameterCount];
-            std::memset(fParameterValueChangesForUI, 0, sizeof(bool)*extraParameterCount);
+            fParameterValueChangesForUI.init(extraParameterCount);
            #endif
         }
 
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        if (fParameterCount != 0)
+            fParameterQueues = new ParameterQueue[fParameterCount];
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        inputEventList.resize(fPlugin.getMidiEventPool().getCapacity());
+       #endif
+
        #if DISTRHO_PLUGIN_WANT_STATE
         for (uint32_t i=0, count=fPlugin.getStateCount(); i<count; ++i)
         {
@@ -683,17 +776,11 @@ public:
             fDummyAudioBuffer = nullptr;
         }
 
-        if (fParameterValuesChangedDuringProcessing != nullptr)
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        if (fParameterQueues != nullptr)
         {
-            delete[] fParameterValuesChangedDuringProcessing;
-            fParameterValuesChangedDuringProcessing = nullptr;
-        }
-
-       #if DISTRHO_PLUGIN_HAS_UI
-        if (fParameterValueChangesForUI != nullptr)
-        {
-            delete[] fParameterValueChangesForUI;
-            fParameterValueChangesForUI = nullptr;
+            delete[] fParameterQueues;
+            fParameterQueues = nullptr;
         }
        #endif
     }
@@ -747,7 +834,7 @@ public:
         if (!fIsComponent)
        #endif
         {
-            fParameterValueChangesForUI[kVst3InternalParameterBaseCount + index] = true;
+            fParameterValueChangesForUI.mark(kVst3InternalParameterBaseCount + index);
         }
       #endif
 
@@ -941,6 +1028,8 @@ public:
      * parameters are simply converted to/from strings and floats.
      * the parameter symbol is used as the "key", so it is possible to reorder them or even remove and add safely.
      * there are markers for begin and end of state and parameters, so they never conflict.
+     * if DISTRHO_PLUGIN_WANT_BINARY_STATE is enabled the state is saved in binary format instead,
+     * see DistrhoPluginState.hpp for details. both formats can always be loaded.
      */
     v3_result setState(v3_bstream** const stream)
     {
@@ -958,6 +1047,9 @@ public:
         buffer[sizeof(buffer)-1] = '\xff';
         v3_result res;
 
+        // parameter values are collected and given to the plugin all at once at the end
+        fParameterChanges.clear();
+
         for (int32_t terminated = 0, read; terminated == 0;)
         {
             read = -1;
@@ -968,6 +1060,17 @@ public:
             if (read == 0)
                 return empty ? V3_INVALID_ARG : V3_OK;
 
+            if (empty)
+            {
+                if (const uint32_t binaryStateSize = BinaryStateReader::getTotalSize(buffer, static_cast<uint32_t>(read)))
+                {
+                    res = setBinaryState(stream, buffer, static_cast<uint32_t>(read), binaryStateSize,
+                                         componentValuesChanged);
+                    DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
+                    break;
+                }
+            }
+
             empty = false;
             for (int32_t i = 0; i < read; ++i)
             {
@@ -1068,7 +1171,7 @@ public:
                        #if DISTRHO_PLUGIN_HAS_UI
                         if (connectedToUI)
                         {
-                            fParameterValueChangesForUI[kVst3InternalParameterProgram] = false;
+                            fParameterValueChangesForUI.take(kVst3InternalParameterProgram);
                             sendParameterSetToUI(kVst3InternalParameterProgram, program);
                         }
                        #endif
@@ -1121,7 +1224,7 @@ public:
                             if (fIsComponent)
                             {
                                 componentValuesChanged = true;
-                                fParameterValuesChangedDuringProcessing[kVst3InternalParameterBaseCount + j] = true;
+                                fParameterValuesChangedDuringProcessing.mark(kVst3InternalParameterBaseCount + j);
                             }
                            #else
                             componentValuesChanged = true;
@@ -1131,10 +1234,10 @@ public:
                             if (connectedToUI)
                             {
                                 // UI parameter updates are handled outside the read loop (after host param restart)
-                                fParameterValueChangesForUI[kVst3InternalParameterBaseCount + j] = true;
+                                fParameterValueChangesForUI.mark(kVst3InternalParameterBaseCount + j);
                             }
                            #endif
-                            fPlugin.setParameterValue(j, fvalue);
+                            fParameterChanges.add(j, fvalue);
                             break;
                         }
                     }
@@ -1146,6 +1249,8 @@ public:
             }
         }
 
+        fPlugin.setParameterValues(fParameterChanges);
+
         if (fComponentHandler != nullptr && componentValuesChanged)
             v3_cpp_obj(fComponentHandler)->restart_component(fComponentHandler, V3_RESTART_PARAM_VALUES_CHANGED);
 
@@ -1156,7 +1261,7 @@ public:
             {
                 if (fPlugin.isParameterOutputOrTrigger(i))
                     continue;
-                fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i] = false;
+                fParameterValueChangesForUI.take(kVst3InternalParameterBaseCount + i);
                 sendParameterSetToUI(kVst3InternalParameterCount + i,
                                      fCachedParameterValues[kVst3InternalParameterBaseCount + i]);
             }
@@ -1191,6 +1296,35 @@ public:
         }
        #endif
 
+        // get all parameter values in a single call
+        fParameterChanges.clear();
+
+        for (uint32_t i=0; i<paramCount; ++i)
+        {
+            if (! fPlugin.isParameterOutputOrTrigger(i))
+                fParameterChanges.add(i);
+        }
+
+        fPlugin.getParameterValues(fParameterChanges);
+
+       #if DISTRHO_PLUGIN_WANT_BINARY_STATE
+        BinaryStateWriter writer;
+
+       #if DISTRHO_PLUGIN_WANT_PROGRAMS
+        writer.writeProgram(fCurrentProgram);
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_STATE
+        for (StringMap::const_iterator cit=fStateMap.begin(), cite=fStateMap.end(); cit != cite; ++cit)
+            writer.writeState(cit->first, cit->second);
+       #endif
+
+        for (uint32_t i=0, count=fParameterChanges.getCount(); i<count; ++i)
+            writer.addParameter(fPlugin.getParameterSymbol(fParameterChanges.getIndex(i)), fParameterChanges.getValue(i));
+
+        const std::vector<uint8_t>& data(writer.finish());
+        return writeStateData(stream, data.data(), static_cast<int32_t>(data.size()));
+       #else
         String state;
 
        #if DISTRHO_PLUGIN_WANT_PROGRAMS
@@ -1231,19 +1365,18 @@ public:
         {
             state += "__dpf_parameters_begin__\xff";
 
-            for (uint32_t i=0; i<paramCount; ++i)
+            for (uint32_t i=0, count=fParameterChanges.getCount(); i<count; ++i)
             {
-                if (fPlugin.isParameterOutputOrTrigger(i))
-                    continue;
+                const uint32_t index = fParameterChanges.getIndex(i);
 
                 // join key and value
                 String tmpStr;
-                tmpStr  = fPlugin.getParameterSymbol(i);
+                tmpStr  = fPlugin.getParameterSymbol(index);
                 tmpStr += "\xff";
-                if (fPlugin.getParameterHints(i) & kParameterIsInteger)
-                    tmpStr += String(d_roundToInt(fPlugin.getParameterValue(i)));
+                if (fPlugin.getParameterHints(index) & kParameterIsInteger)
+                    tmpStr += String(d_roundToInt(fParameterChanges.getValue(i)));
                 else
-                    tmpStr += String(fPlugin.getParameterValue(i));
+                    tmpStr += String(fParameterChanges.getValue(i));
                 tmpStr += "\xff";
 
                 state += tmpStr;
@@ -1257,21 +1390,8 @@ public:
 
         state.replace('\xff', '\0');
 
-        // now saving state, carefully until host written bytes matches full state size
-        const char* buffer = state.buffer();
-        const int32_t size = static_cast<int32_t>(state.length())+1;
-        v3_result res;
-
-        for (int32_t wrtntotal = 0, wrtn; wrtntotal < size; wrtntotal += wrtn)
-        {
-            wrtn = 0;
-            res = v3_cpp_obj(stream)->write(stream, const_cast<char*>(buffer) + wrtntotal, size - wrtntotal, &wrtn);
-
-            DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
-            DISTRHO_SAFE_ASSERT_INT_RETURN(wrtn > 0, wrtn, V3_INTERNAL_ERR);
-        }
-
-        return V3_OK;
+        return writeStateData(stream, state.buffer(), static_cast<int32_t>(state.length())+1);
+       #endif
     }
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -1344,24 +1464,32 @@ public:
 
     v3_result setupProcessing(v3_process_setup* const setup)
     {
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        DISTRHO_SAFE_ASSERT_RETURN(setup->symbolic_sample_size == V3_SAMPLE_32 ||
+                                   setup->symbolic_sample_size == V3_SAMPLE_64, V3_INVALID_ARG);
+       #else
         DISTRHO_SAFE_ASSERT_RETURN(setup->symbolic_sample_size == V3_SAMPLE_32, V3_INVALID_ARG);
+       #endif
 
         const bool active = fPlugin.isActive();
         fPlugin.deactivateIfNeeded();
 
-        // TODO process_mode can be V3_REALTIME, V3_PREFETCH, V3_OFFLINE
-
+        // V3_PREFETCH still needs processing to keep up with playback, so only V3_OFFLINE counts as offline
+        fPlugin.setOffline(setup->process_mode == V3_OFFLINE, true);
         fPlugin.setSampleRate(setup->sample_rate, true);
         fPlugin.setBufferSize(setup->max_block_size, true);
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        inputEventList.resize(fPlugin.getMidiEventPool().getCapacity());
+       #endif
 
       #if DPF_VST3_USES_SEPARATE_CONTROLLER
         fCachedParameterValues[kVst3InternalParameterBufferSize] = setup->max_block_size;
-        fParameterValuesChangedDuringProcessing[kVst3InternalParameterBufferSize] = true;
+        fParameterValuesChangedDuringProcessing.mark(kVst3InternalParameterBufferSize);
 
         fCachedParameterValues[kVst3InternalParameterSampleRate] = setup->sample_rate;
-        fParameterValuesChangedDuringProcessing[kVst3InternalParameterSampleRate] = true;
+        fParameterValuesChangedDuringProcessing.mark(kVst3InternalParameterSampleRate);
        #if DISTRHO_PLUGIN_HAS_UI
-        fParameterValueChangesForUI[kVst3InternalParameterSampleRate] = true;
+        fParameterValueChangesForUI.mark(kVst3InternalParameterSampleRate);
        #endif
       #endif
 
@@ -1369,7 +1497,12 @@ public:
             fPlugin.activate();
 
         delete[] fDummyAudioBuffer;
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        // big enough to be used as double buffer too
+        fDummyAudioBuffer = new float[setup->max_block_size * 2];
+       #else
         fDummyAudioBuffer = new float[setup->max_block_size];
+       #endif
 
         return V3_OK;
     }
@@ -1391,9 +1524,19 @@ public:
 
     v3_result process(v3_process_data* const data)
     {
-        DISTRHO_SAFE_ASSERT_RETURN(data->symbolic_sample_size == V3_SAMPLE_32, V3_INVALID_ARG);
         // d_debug("process %i", data->symbolic_sample_size);
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        if (data->symbolic_sample_size == V3_SAMPLE_64)
+            return _process<double>(data);
+       #endif
 
+        DISTRHO_SAFE_ASSERT_RETURN(data->symbolic_sample_size == V3_SAMPLE_32, V3_INVALID_ARG);
+        return _process<float>(data);
+    }
+
+    template<typename T>
+    v3_result _process(v3_process_data* const data)
+    {
         // activate plugin if not done yet
         if (! fPlugin.isActive())
             fPlugin.activate();
@@ -1461,10 +1604,11 @@ public:
             return V3_OK;
         }
 
-        const float* inputs[DISTRHO_PLUGIN_NUM_INPUTS != 0 ? DISTRHO_PLUGIN_NUM_INPUTS : 1];
-        /* */ float* outputs[DISTRHO_PLUGIN_NUM_OUTPUTS != 0 ? DISTRHO_PLUGIN_NUM_OUTPUTS : 1];
+        const T* inputs[DISTRHO_PLUGIN_NUM_INPUTS != 0 ? DISTRHO_PLUGIN_NUM_INPUTS : 1];
+        /* */ T* outputs[DISTRHO_PLUGIN_NUM_OUTPUTS != 0 ? DISTRHO_PLUGIN_NUM_OUTPUTS : 1];
 
-        std::memset(fDummyAudioBuffer, 0, sizeof(float)*data->nframes);
+        T* const dummyAudioBuffer = reinterpret_cast<T*>(fDummyAudioBuffer);
+        std::memset(dummyAudioBuffer, 0, sizeof(T)*data->nframes);
 
         {
             int32_t i = 0;
@@ -1476,17 +1620,17 @@ public:
                     {
                         DISTRHO_SAFE_ASSERT_INT_BREAK(i < DISTRHO_PLUGIN_NUM_INPUTS, i);
                         if (!fEnabledInputs[i] && i < DISTRHO_PLUGIN_NUM_INPUTS) {
-                            inputs[i++] = fDummyAudioBuffer;
+                            inputs[i++] = dummyAudioBuffer;
                             continue;
                         }
 
-                        inputs[i++] = data->inputs[b].channel_buffers_32[j];
+                        inputs[i++] = getChannelBuffers<T>(data->inputs[b])[j];
                     }
                 }
             }
            #endif
             for (; i < std::max(1, DISTRHO_PLUGIN_NUM_INPUTS); ++i)
-                inputs[i] = fDummyAudioBuffer;
+                inputs[i] = dummyAudioBuffer;
         }
 
         {
@@ -1499,17 +1643,17 @@ public:
                     {
                         DISTRHO_SAFE_ASSERT_INT_BREAK(i < DISTRHO_PLUGIN_NUM_OUTPUTS, i);
                         if (!fEnabledOutputs[i] && i < DISTRHO_PLUGIN_NUM_OUTPUTS) {
-                            outputs[i++] = fDummyAudioBuffer;
+                            outputs[i++] = dummyAudioBuffer;
                             continue;
                         }
 
-                        outputs[i++] = data->outputs[b].channel_buffers_32[j];
+                        outputs[i++] = getChannelBuffers<T>(data->outputs[b])[j];
                     }
                 }
             }
            #endif
             for (; i < std::max(1, DISTRHO_PLUGIN_NUM_OUTPUTS); ++i)
-                outputs[i] = fDummyAudioBuffer;
+                outputs[i] = dummyAudioBuffer;
         }
 
        #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
@@ -1517,44 +1661,37 @@ public:
        #endif
 
       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        bool canAppendMoreEvents = true;
         inputEventList.init();
 
        #if DISTRHO_PLUGIN_HAS_UI
-        while (fNotesRingBuffer.isDataAvailableForReading())
+        // notes from the UI that do not fit stay queued for the next block
+        while (! inputEventList.isFull() && fNotesRingBuffer.isDataAvailableForReading())
         {
             uint8_t midiData[3];
             if (! fNotesRingBuffer.readCustomData(midiData, 3))
                 break;
 
-            if (inputEventList.appendFromUI(midiData))
-            {
-                canAppendMoreEvents = false;
-                break;
-            }
+            inputEventList.appendFromUI(midiData);
         }
        #endif
 
-        if (canAppendMoreEvents)
+        if (v3_event_list** const eventptr = data->input_events)
         {
-            if (v3_event_list** const eventptr = data->input_events)
+            v3_event event;
+            for (uint32_t i = 0, count = v3_cpp_obj(eventptr)->get_event_count(eventptr); i < count; ++i)
             {
-                v3_event event;
-                for (uint32_t i = 0, count = v3_cpp_obj(eventptr)->get_event_count(eventptr); i < count; ++i)
-                {
-                    if (v3_cpp_obj(eventptr)->get_event(eventptr, i, &event) != V3_OK)
-                        break;
+                if (v3_cpp_obj(eventptr)->get_event(eventptr, i, &event) != V3_OK)
+                    break;
 
-                    if (inputEventList.appendEvent(event))
-                    {
-                        canAppendMoreEvents = false;
-                        break;
-                    }
-                }
+                inputEventList.appendEvent(event);
             }
         }
       #endif
 
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        uint32_t queueCount = 0;
+       #endif
+
         if (v3_param_changes** const inparamsptr = data->input_params)
         {
             int32_t offset;
@@ -1573,18 +1710,14 @@ public:
                 {
                    #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
                     // if there are any MIDI CC events as parameter changes, handle them here
-                    if (canAppendMoreEvents && rindex >= kVst3InternalParameterMidiCC_start && rindex < kVst3InternalParameterCount)
+                    if (rindex >= kVst3InternalParameterMidiCC_start && rindex < kVst3InternalParameterCount)
                     {
                         for (int32_t j = 0, pcount = v3_cpp_obj(queue)->get_point_count(queue); j < pcount; ++j)
                         {
                             if (v3_cpp_obj(queue)->get_point(queue, j, &offset, &normalized) != V3_OK)
                                 break;
 
-                            if (inputEventList.appendCC(offset, rindex, normalized))
-                            {
-                                canAppendMoreEvents = false;
-                                break;
-                            }
+                            inputEventList.appendCC(offset, rindex, normalized);
                         }
                     }
                    #endif
@@ -1592,6 +1725,25 @@ public:
                 }
                #endif
 
+               #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+                const int32_t pcount = v3_cpp_obj(queue)->get_point_count(queue);
+
+                if (pcount <= 0 || queueCount == fParameterCount)
+                    continue;
+
+                if (v3_cpp_obj(queue)->get_point(queue, 0, &offset, &normalized) != V3_OK)
+                    break;
+
+                // keep track of this queue, its points are handled while splitting the audio block
+                ParameterQueue& pqueue(fParameterQueues[queueCount]);
+                pqueue.queue = queue;
+                pqueue.index = rindex - kVst3InternalParameterCount;
+                pqueue.pointCount = pcount;
+                pqueue.pointIndex = 0;
+                pqueue.offset = offset;
+                pqueue.normalized = normalized;
+                ++queueCount;
+               #else
                 if (v3_cpp_obj(queue)->get_point_count(queue) <= 0)
                     continue;
 
@@ -1604,12 +1756,76 @@ public:
 
                 const uint32_t index = rindex - kVst3InternalParameterCount;
                 _setNormalizedPluginParameterValue(index, normalized);
+               #endif
             }
         }
 
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        int32_t frameOffset = 0;
        #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-        const uint32_t midiEventCount = inputEventList.convert(fMidiEvents);
-        fPlugin.run(inputs, outputs, data->nframes, fMidiEvents, midiEventCount);
+        MidiEventPool& midiEvents(fPlugin.getMidiEventPool());
+        midiEvents.clear();
+        inputEventList.convert(midiEvents);
+        uint32_t midiEventIndex = 0;
+       #endif
+
+        for (;;)
+        {
+            // find the position of the next parameter change
+            int32_t nextOffset = data->nframes;
+
+            for (uint32_t i = 0; i < queueCount; ++i)
+            {
+                const ParameterQueue& pqueue(fParameterQueues[i]);
+
+                if (pqueue.pointIndex < pqueue.pointCount && pqueue.offset < nextOffset)
+                    nextOffset = pqueue.offset;
+            }
+
+            if (nextOffset >= data->nframes)
+                break;
+
+            // run everything up to this position before changing the parameters
+            if (nextOffset > frameOffset)
+            {
+               #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                fPlugin.runSubBlock(inputs, outputs, frameOffset, nextOffset - frameOffset,
+                                    midiEvents.getEvents(), midiEvents.getCount(), midiEventIndex, false);
+               #else
+                fPlugin.runSubBlock(inputs, outputs, frameOffset, nextOffset - frameOffset);
+               #endif
+                frameOffset = nextOffset;
+            }
+
+            for (uint32_t i = 0; i < queueCount; ++i)
+            {
+                ParameterQueue& pqueue(fParameterQueues[i]);
+
+                while (pqueue.pointIndex < pqueue.pointCount && pqueue.offset <= nextOffset)
+                {
+                    _setNormalizedPluginParameterValue(pqueue.index, pqueue.normalized);
+
+                    if (++pqueue.pointIndex == pqueue.pointCount)
+                        break;
+
+                    if (v3_cpp_obj(pqueue.queue)->get_point(pqueue.queue, pqueue.pointIndex,
+                                                            &pqueue.offset, &pqueue.normalized) != V3_OK)
+                        pqueue.pointIndex = pqueue.pointCount;
+                }
+            }
+        }
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fPlugin.runSubBlock(inputs, outputs, frameOffset, data->nframes - frameOffset,
+                            midiEvents.getEvents(), midiEvents.getCount(), midiEventIndex, true);
+       #else
+        fPlugin.runSubBlock(inputs, outputs, frameOffset, data->nframes - frameOffset);
+       #endif
+       #elif DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        MidiEventPool& midiEvents(fPlugin.getMidiEventPool());
+        midiEvents.clear();
+        inputEventList.convert(midiEvents);
+        fPlugin.run(inputs, outputs, data->nframes, midiEvents.getEvents(), midiEvents.getCount());
        #else
         fPlugin.run(inputs, outputs, data->nframes);
        #endif
@@ -1618,6 +1834,22 @@ public:
         fHostEventOutputHandle = nullptr;
        #endif
 
+       #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+        // if there are any parameter changes beyond the current block, set them here
+        for (uint32_t i = 0; i < queueCount; ++i)
+        {
+            const ParameterQueue& pqueue(fParameterQueues[i]);
+
+            if (pqueue.pointIndex == pqueue.pointCount)
+                continue;
+
+            int32_t offset;
+            double normalized;
+
+            if (v3_cpp_obj(pqueue.queue)->get_point(pqueue.queue, pqueue.pointCount - 1, &offset, &normalized) == V3_OK)
+                _setNormalizedPluginParameterValue(pqueue.index, normalized);
+        }
+       #else
         // if there are any parameter changes after frame 0, set them here
         if (v3_param_changes** const inparamsptr = data->input_params)
         {
@@ -1652,6 +1884,7 @@ public:
                 _setNormalizedPluginParameterValue(index, normalized);
             }
         }
+       #endif
 
         updateParametersFromProcessing(data->output_params, data->nframes - 1);
         return V3_OK;
@@ -2082,15 +2315,24 @@ public:
                 fCurrentProgram = fCachedParameterValues[rindex];
                 fPlugin.loadProgram(fCurrentProgram);
 
+                fParameterChanges.clear();
+
                 for (uint32_t i=0; i<fParameterCount; ++i)
                 {
-                    if (fPlugin.isParameterOutputOrTrigger(i))
-                        continue;
-                    fCachedParameterValues[kVst3InternalParameterBaseCount + i] = fPlugin.getParameterValue(i);
+                    if (! fPlugin.isParameterOutputOrTrigger(i))
+                        fParameterChanges.add(i);
+                }
+
+                fPlugin.getParameterValues(fParameterChanges);
+
+                for (uint32_t i=0, count=fParameterChanges.getCount(); i<count; ++i)
+                {
+                    const uint32_t index = fParameterChanges.getIndex(i);
+                    fCachedParameterValues[kVst3InternalParameterBaseCount + index] = fParameterChanges.getValue(i);
                 }
 
                #if DISTRHO_PLUGIN_HAS_UI
-                fParameterValueChangesForUI[kVst3InternalParameterProgram] = true;
+                fParameterValueChangesForUI.mark(kVst3InternalParameterProgram);
                #endif
                 break;
            #endif
@@ -2192,13 +2434,13 @@ public:
             fConnectedToUI = true;
 
            #if DPF_VST3_USES_SEPARATE_CONTROLLER
-            fParameterValueChangesForUI[kVst3InternalParameterSampleRate] = false;
+            fParameterValueChangesForUI.take(kVst3InternalParameterSampleRate);
             sendParameterSetToUI(kVst3InternalParameterSampleRate,
                                  fCachedParameterValues[kVst3InternalParameterSampleRate]);
            #endif
 
            #if DISTRHO_PLUGIN_WANT_PROGRAMS
-            fParameterValueChangesForUI[kVst3InternalParameterProgram] = false;
+            fParameterValueChangesForUI.take(kVst3InternalParameterProgram);
             sendParameterSetToUI(kVst3InternalParameterProgram, fCurrentProgram);
            #endif
 
@@ -2224,7 +2466,7 @@ public:
 
             for (uint32_t i=0; i<fParameterCount; ++i)
             {
-                fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i] = false;
+                fParameterValueChangesForUI.take(kVst3InternalParameterBaseCount + i);
                 sendParameterSetToUI(kVst3InternalParameterCount + i,
                                      fCachedParameterValues[kVst3InternalParameterBaseCount + i]);
             }
@@ -2240,31 +2482,31 @@ public:
 
         if (std::strcmp(msgid, "idle") == 0)
         {
-           #if DPF_VST3_USES_SEPARATE_CONTROLLER
-            if (fParameterValueChangesForUI[kVst3InternalParameterSampleRate])
+            uint32_t index;
+            while (fParameterValueChangesForUI.takeNext(index))
             {
-                fParameterValueChangesForUI[kVst3InternalParameterSampleRate] = false;
-                sendParameterSetToUI(kVst3InternalParameterSampleRate,
-                                     fCachedParameterValues[kVst3InternalParameterSampleRate]);
-            }
-           #endif
+               #if DPF_VST3_USES_SEPARATE_CONTROLLER
+                if (index == kVst3InternalParameterSampleRate)
+                {
+                    sendParameterSetToUI(kVst3InternalParameterSampleRate,
+                                         fCachedParameterValues[kVst3InternalParameterSampleRate]);
+                    continue;
+                }
+               #endif
 
-           #if DISTRHO_PLUGIN_WANT_PROGRAMS
-            if (fParameterValueChangesForUI[kVst3InternalParameterProgram])
-            {
-                fParameterValueChangesForUI[kVst3InternalParameterProgram] = false;
-                sendParameterSetToUI(kVst3InternalParameterProgram, fCurrentProgram);
-            }
-           #endif
+               #if DISTRHO_PLUGIN_WANT_PROGRAMS
+                if (index == kVst3InternalParameterProgram)
+                {
+                    sendParameterSetToUI(kVst3InternalParameterProgram, fCurrentProgram);
+                    continue;
+                }
+               #endif
 
-            for (uint32_t i=0; i<fParameterCount; ++i)
-            {
-                if (! fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i])
+                if (index < kVst3InternalParameterBaseCount)
                     continue;
 
-                fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i] = false;
-                sendParameterSetToUI(kVst3InternalParameterCount + i,
-                                     fCachedParameterValues[kVst3InternalParameterBaseCount + i]);
+                sendParameterSetToUI(kVst3InternalParameterCount + index - kVst3InternalParameterBaseCount,
+                                     fCachedParameterValues[index]);
             }
 
             sendReadyToUI();
@@ -2409,11 +2651,9 @@ public:
         fPlugin.setState(key, value);
 
         // save this key as needed
-        if (fPlugin.wantStateKey(key))
-        {
-            const String dkey(key);
-            fStateMap[dkey] = value;
-        }
+        uint32_t index;
+        if (fPlugin.getStateIndex(key, index))
+            fStateMap[fPlugin.getStateKey(index)] = value;
 
         std::free(key16);
         std::free(value16);
@@ -2460,7 +2700,20 @@ private:
     const uint32_t fVst3ParameterCount; // full offset + real
     float* fCachedParameterValues; // basic offset + real
     float* fDummyAudioBuffer;
-    bool* fParameterValuesChangedDuringProcessing; // basic offset + real
+    ParameterChangeTracker fParameterValuesChangedDuringProcessing; // basic offset + real
+    ParameterValueList fParameterChanges; // for batched state and program restore
+    ParameterValueList fOutputParameters; // fixed list of output and trigger parameters
+   #if DISTRHO_PLUGIN_WANT_SAMPLE_ACCURATE_PARAMETERS
+    struct ParameterQueue {
+        v3_param_value_queue** queue;
+        uint32_t index;
+        int32_t pointCount;
+        int32_t pointIndex;
+        int32_t offset; // of current point
+        double normalized; // of current point
+    };
+    ParameterQueue* fParameterQueues; // real
+   #endif
    #if DISTRHO_PLUGIN_NUM_INPUTS > 0
     bool fEnabledInputs[DISTRHO_PLUGIN_NUM_INPUTS];
    #endif
@@ -2471,18 +2724,15 @@ private:
     const bool fIsComponent;
    #endif
    #if DISTRHO_PLUGIN_HAS_UI
-    bool* fParameterValueChangesForUI; // basic offset + real
+    ParameterChangeTracker fParameterValueChangesForUI; // basic offset + real
     bool fConnectedToUI;
    #endif
    #if DISTRHO_PLUGIN_WANT_LATENCY
     uint32_t fLastKnownLatency;
    #endif
-  #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-    MidiEvent fMidiEvents[kMaxMidiEvents];
-   #if DISTRHO_PLUGIN_HAS_UI
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT && DISTRHO_PLUGIN_HAS_UI
     SmallStackRingBuffer fNotesRingBuffer;
    #endif
-  #endif
    #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
     v3_event_list** fHostEventOutputHandle;
    #endif
@@ -2875,6 +3125,157 @@ private:
     }
    #endif
 
+    // ----------------------------------------------------------------------------------------------------------------
+    // helper functions for dealing with state
+
+    static v3_result writeStateData(v3_bstream** const stream, const void* const data, const int32_t size)
+    {
+        // saving state, carefully until host written bytes matches full state size
+        const uint8_t* const buffer = static_cast<const uint8_t*>(data);
+        v3_result res;
+
+        for (int32_t wrtntotal = 0, wrtn; wrtntotal < size; wrtntotal += wrtn)
+        {
+            wrtn = 0;
+            res = v3_cpp_obj(stream)->write(stream, const_cast<uint8_t*>(buffer) + wrtntotal, size - wrtntotal, &wrtn);
+
+            DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
+            DISTRHO_SAFE_ASSERT_INT_RETURN(wrtn > 0, wrtn, V3_INTERNAL_ERR);
+        }
+
+        return V3_OK;
+    }
+
+    v3_result setBinaryState(v3_bstream** const stream,
+                             const char* const initialData, const uint32_t initialSize, const uint32_t totalSize,
+                             bool& componentValuesChanged)
+    {
+       #if DISTRHO_PLUGIN_HAS_UI
+        const bool connectedToUI = fConnectionFromCtrlToView != nullptr && fConnectedToUI;
+       #endif
+
+        // get the full state in a single block, so chunks can be read in place
+        std::vector<uint8_t> data(totalSize);
+        uint32_t filled = std::min(initialSize, totalSize);
+        std::memcpy(data.data(), initialData, filled);
+
+        for (int32_t read; filled < totalSize; filled += static_cast<uint32_t>(read))
+        {
+            read = -1;
+            const v3_result res = v3_cpp_obj(stream)->read(stream, data.data() + filled,
+                                                            static_cast<int32_t>(totalSize - filled), &read);
+            DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
+            DISTRHO_SAFE_ASSERT_INT_RETURN(read > 0, read, V3_INTERNAL_ERR);
+        }
+
+        BinaryStateReader reader(data.data(), totalSize);
+        const uint8_t* chunkData;
+        uint32_t chunkType, chunkSize;
+
+        while (reader.readChunk(chunkType, chunkData, chunkSize))
+        {
+            switch (chunkType)
+            {
+            case kBinaryStateChunkProgram:
+            {
+               #if DISTRHO_PLUGIN_WANT_PROGRAMS
+                uint32_t program;
+                DISTRHO_SAFE_ASSERT_BREAK(BinaryStateReader::parseProgram(chunkData, chunkSize, program));
+                DISTRHO_SAFE_ASSERT_UINT2_BREAK(program <= fProgramCountMinusOne, program, fProgramCountMinusOne);
+
+                fCurrentProgram = program;
+                fPlugin.loadProgram(fCurrentProgram);
+
+               #if DISTRHO_PLUGIN_HAS_UI
+                if (connectedToUI)
+                {
+                    fParameterValueChangesForUI.take(kVst3InternalParameterProgram);
+                    sendParameterSetToUI(kVst3InternalParameterProgram, program);
+                }
+               #endif
+               #endif
+                break;
+            }
+
+            case kBinaryStateChunkState:
+            {
+               #if DISTRHO_PLUGIN_WANT_STATE
+                const char* key;
+                const char* value;
+                DISTRHO_SAFE_ASSERT_BREAK(BinaryStateReader::parseState(chunkData, chunkSize, key, value));
+
+                uint32_t stateIndex;
+                if (fPlugin.getStateIndex(key, stateIndex))
+                {
+                    fStateMap[fPlugin.getStateKey(stateIndex)] = value;
+                    fPlugin.setState(key, value);
+
+                   #if DISTRHO_PLUGIN_HAS_UI
+                    if (connectedToUI)
+                        sendStateSetToUI(key, value);
+                   #endif
+                }
+               #endif
+                break;
+            }
+
+            case kBinaryStateChunkParameters:
+            {
+                BinaryStateReader::Parameters params;
+                DISTRHO_SAFE_ASSERT_BREAK(BinaryStateReader::parseParameters(chunkData, chunkSize, params));
+
+                const char* symbol;
+                float value;
+
+                // parameters are saved in order, so the next index is usually the right one
+                for (uint32_t hint = 0; params.next(symbol, value);)
+                {
+                    for (uint32_t n=0; n < fParameterCount; ++n)
+                    {
+                        const uint32_t j = (hint + n) % fParameterCount;
+
+                        if (fPlugin.isParameterOutputOrTrigger(j))
+                            continue;
+                        if (fPlugin.getParameterSymbol(j) != symbol)
+                            continue;
+
+                        fCachedParameterValues[kVst3InternalParameterBaseCount + j] = value;
+
+                       #if DPF_VST3_USES_SEPARATE_CONTROLLER
+                        // If this is the component make sure the controller also knows about the state change
+                        if (fIsComponent)
+                        {
+                            componentValuesChanged = true;
+                            fParameterValuesChangedDuringProcessing.mark(kVst3InternalParameterBaseCount + j);
+                        }
+                       #else
+                        componentValuesChanged = true;
+                       #endif
+
+                       #if DISTRHO_PLUGIN_HAS_UI
+                        if (connectedToUI)
+                        {
+                            // UI parameter updates are handled outside the read loop (after host param restart)
+                            fParameterValueChangesForUI.mark(kVst3InternalParameterBaseCount + j);
+                        }
+                       #endif
+                        fParameterChanges.add(j, value);
+                        hint = j + 1;
+                        break;
+                    }
+                }
+                break;
+            }
+
+            default:
+                d_debug("ignoring unknown binary state chunk type %u", chunkType);
+                break;
+            }
+        }
+
+        return V3_OK;
+    }
+
     // ----------------------------------------------------------------------------------------------------------------
     // helper functions called during process, cannot block
 
@@ -2885,20 +3286,49 @@ private:
         float curValue, defValue;
         double normalized;
 
-       #if DPF_VST3_USES_SEPARATE_CONTROLLER
-        for (v3_param_id i=kVst3InternalParameterBufferSize; i<=kVst3InternalParameterSampleRate; ++i)
+        uint32_t index;
+
+        // only changed parameters are visited, the tracker skips over untouched ones in groups of 32
+        while (fParameterValuesChangedDuringProcessing.takeNext(index))
         {
-            if (! fParameterValuesChangedDuringProcessing[i])
+           #if DPF_VST3_USES_SEPARATE_CONTROLLER
+            if (index == kVst3InternalParameterBufferSize || index == kVst3InternalParameterSampleRate)
+            {
+                normalized = plainParameterToNormalized(index, fCachedParameterValues[index]);
+                addParameterDataToHostOutputEvents(outparamsptr, index, normalized);
                 continue;
+            }
+           #endif
+
+            if (index < kVst3InternalParameterBaseCount)
+                continue;
+
+            const uint32_t i = index - kVst3InternalParameterBaseCount;
+
+            if (fPlugin.isParameterOutputOrTrigger(i))
+                continue;
+
+            curValue = fPlugin.getParameterValue(i);
+            fCachedParameterValues[index] = curValue;
+           #if DISTRHO_PLUGIN_HAS_UI
+            fParameterValueChangesForUI.mark(index);
+           #endif
+
+            normalized = _getNormalizedParameterValue(i, curValue);
 
-            normalized = plainParameterToNormalized(i, fCachedParameterValues[i]);
-            fParameterValuesChangedDuringProcessing[i] = false;
-            addParameterDataToHostOutputEvents(outparamsptr, i, normalized);
+            if (! addParameterDataToHostOutputEvents(outparamsptr, kVst3InternalParameterCount + i, normalized, offset))
+            {
+                // host queue is full, keep this and any remaining changes for the next block
+                fParameterValuesChangedDuringProcessing.mark(index);
+                break;
+            }
         }
-       #endif
 
-        for (uint32_t i=0; i<fParameterCount; ++i)
+        // output and trigger parameters have no host-side support, so they are polled
+        for (uint32_t j=0, count=fOutputParameters.getCount(); j<count; ++j)
         {
+            const uint32_t i = fOutputParameters.getIndex(j);
+
             if (fPlugin.isParameterOutput(i))
             {
                 // NOTE: no output parameter support in VST3, simulate it here
@@ -2907,7 +3337,7 @@ private:
                 if (d_isEqual(curValue, fCachedParameterValues[kVst3InternalParameterBaseCount + i]))
                     continue;
             }
-            else if (fPlugin.isParameterTrigger(i))
+            else
             {
                 // NOTE: no trigger parameter support in VST3, simulate it here
                 defValue = fPlugin.getParameterDefault(i);
@@ -2919,19 +3349,10 @@ private:
                 curValue = defValue;
                 fPlugin.setParameterValue(i, curValue);
             }
-            else if (fParameterValuesChangedDuringProcessing[kVst3InternalParameterBaseCount + i])
-            {
-                fParameterValuesChangedDuringProcessing[kVst3InternalParameterBaseCount + i] = false;
-                curValue = fPlugin.getParameterValue(i);
-            }
-            else
-            {
-                continue;
-            }
 
             fCachedParameterValues[kVst3InternalParameterBaseCount + i] = curValue;
            #if DISTRHO_PLUGIN_HAS_UI
-            fParameterValueChangesForUI[kVst3InternalParameterBaseCount + i] = true;
+            fParameterValueChangesForUI.mark(kVst3InternalParameterBaseCount + i);
            #endif
 
             normalized = _getNormalizedParameterValue(i, curValue);
@@ -3050,7 +3471,7 @@ private:
    #if DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST
     bool requestParameterValueChange(const uint32_t index, float)
     {
-        fParameterValuesChangedDuringProcessing[kVst3InternalParameterBaseCount + index] = true;
+        fParameterValuesChangedDuringProcessing.mark(kVst3InternalParameterBaseCount + index);
         return true;
     }
 
@@ -4085,6 +4506,10 @@ struct dpf_audio_processor : v3_audio_processor_cpp {
     {
         // NOTE runs during RT
         // d_debug("dpf_audio_processor::can_process_sample_size => %i", symbolic_sample_size);
+       #if DISTRHO_PLUGIN_WANT_DOUBLE_PRECISION
+        if (symbolic_sample_size == V3_SAMPLE_64)
+            return V3_OK;
+       #endif
         return symbolic_sample_size == V3_SAMPLE_32 ? V3_OK : V3_NOT_IMPLEMENTED;
     }
 
@@ -4973,6 +5398,7 @@ bool ENTRYFNNAME(ENTRYFNNAMEARGS)
         d_nextBufferSize = 512;
         d_nextSampleRate = 44100.0;
         d_nextPluginIsDummy = true;
+        d_nextPluginIsMetadataOnly = true;
         d_nextCanRequestParameterValueChanges = true;
 
         // Create dummy plugin to get data from
@@ -4982,6 +5408,7 @@ bool ENTRYFNNAME(ENTRYFNNAMEARGS)
         d_nextBufferSize = 0;
         d_nextSampleRate = 0.0;
         d_nextPluginIsDummy = false;
+        d_nextPluginIsMetadataOnly = false;
         d_nextCanRequestParameterValueChanges = false;
 
         dpf_tuid_class[2] = dpf_tuid_component[2] = dpf_tuid_controller[2]
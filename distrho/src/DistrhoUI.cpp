@@ -82,6 +82,11 @@ END_NAMESPACE_DISTRHO
 #include "src/WindowPrivateData.hpp"
 #include "DistrhoUIPrivateData.hpp"
 
+#if DISTRHO_UI_USE_WEB_VIEW
+# include "extra/Base64.hpp"
+# include "extra/Time.hpp"
+#endif
+
 START_NAMESPACE_DISTRHO
 
 /* ------------------------------------------------------------------------------------------------------------
@@ -208,16 +213,49 @@ PluginWindow& UI::PrivateData::createNextWindow(UI* const ui, uint width, uint h
 
         // TODO convert win32 paths to web
 
+        // parameter changes are sent in batches of (uint32 index, float32 value) pairs, encoded as base64
         WebViewOptions opts;
         opts.initialJS = ""
-"editParameter = function(index, started){ postMessage('editparam ' + index + ' ' + (started ? '1' : '0')) };"
-"setParameterValue = function(index, value){ postMessage('setparam ' + index + ' ' + value) };"
+"_dpfParamRate = " STRINGIFY(DISTRHO_UI_WEB_VIEW_PARAMETER_RATE) ";"
+"_dpfParamTimer = null;"
+"_dpfParams = new Map();"
+"_dpfFlushParams = function(){"
+  "if (_dpfParamTimer !== null){ clearTimeout(_dpfParamTimer); _dpfParamTimer = null; }"
+  "if (_dpfParams.size === 0) return;"
+  "var view = new DataView(new ArrayBuffer(_dpfParams.size * 8)), offset = 0, str = '';"
+  "_dpfParams.forEach(function(value, index){"
+    "view.setUint32(offset, index, true); view.setFloat32(offset + 4, value, true); offset += 8;"
+  "});"
+  "_dpfParams.clear();"
+  "for (var i = 0; i < offset; ++i) str += String.fromCharCode(view.getUint8(i));"
+  "postMessage('setparams ' + btoa(str));"
+"};"
+"_dpfParametersChanged = function(data){"
+  "var str = atob(data), count = str.length / 8;"
+  "var view = new DataView(new ArrayBuffer(str.length));"
+  "var indexes = new Uint32Array(count), values = new Float32Array(count);"
+  "for (var i = 0; i < str.length; ++i) view.setUint8(i, str.charCodeAt(i));"
+  "for (var i = 0; i < count; ++i){ indexes[i] = view.getUint32(i * 8, true); values[i] = view.getFloat32(i * 8 + 4, true); }"
+  "_dpfDispatchParameters(indexes, values);"
+"};"
+"_dpfSharedValuesChanged = function(indexes, values){"
+  "_dpfDispatchParameters(new Uint32Array(indexes), new Float32Array(values));"
+"};"
+"_dpfDispatchParameters = function(indexes, values){"
+  "if (typeof(parametersChanged) === 'function') return parametersChanged(indexes, values);"
+  "if (typeof(parameterChanged) === 'function') for (var i = 0; i < indexes.length; ++i) parameterChanged(indexes[i], values[i]);"
+"};"
+"editParameter = function(index, started){ _dpfFlushParams(); postMessage('editparam ' + index + ' ' + (started ? '1' : '0')) };"
+"setParameterValue = function(index, value){"
+  "_dpfParams.set(index, value);"
+  "if (_dpfParamTimer === null) _dpfParamTimer = setTimeout(_dpfFlushParams, _dpfParamRate > 0 ? 1000 / _dpfParamRate : 0);"
+"};"
 #if DISTRHO_PLUGIN_WANT_STATE
-"setState = function(key, value){ postMessage('setstate ' + key + ' ' + value) };"
+"setState = function(key, value){ _dpfFlushParams(); postMessage('setstate ' + key + ' ' + value) };"
 "requestStateFile = function(key){ postMessage('reqstatefile ' + key) };"
 #endif
 #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
-"sendNote = function(channel, note, velocity){ postMessage('sendnote ' + channel + ' ' + note + ' ' + velocity) };"
+"sendNote = function(channel, note, velocity){ _dpfFlushParams(); postMessage('sendnote ' + channel + ' ' + note + ' ' + velocity) };"
 #endif
         ;
         opts.callback = webViewMessageCallback;
@@ -244,6 +282,23 @@ void UI::PrivateData::webViewMessageCallback(void* const arg, char* const msg)
 {
     UI::PrivateData* const uiData = static_cast<UI::PrivateData*>(arg);
 
+    if (std::strncmp(msg, "setparams ", 10) == 0)
+    {
+        const std::vector<uint8_t> data(d_getChunkFromBase64String(msg + 10));
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(data.size() % 8 == 0, data.size(),);
+
+        uint32_t index;
+        float value;
+
+        for (size_t i = 0; i < data.size(); i += 8)
+        {
+            std::memcpy(&index, data.data() + i, sizeof(uint32_t));
+            std::memcpy(&value, data.data() + i + 4, sizeof(float));
+            uiData->setParamCallback(index + uiData->parameterOffset, value);
+        }
+        return;
+    }
+
     if (std::strncmp(msg, "setparam ", 9) == 0)
     {
         const char* const strindex = msg + 9;
@@ -317,6 +372,56 @@ void UI::PrivateData::webViewMessageCallback(void* const arg, char* const msg)
 
     d_stderr("UI received unknown message '%s'", msg);
 }
+
+void UI::PrivateData::webViewParameterChanged(const uint32_t index, const float value)
+{
+    if (index >= webviewParameterValues.size())
+    {
+        webviewParameterValues.resize(index + 1, 0.f);
+        webviewParameterIsPending.resize(index + 1, false);
+    }
+
+    webviewParameterValues[index] = value;
+
+    if (! webviewParameterIsPending[index])
+    {
+        webviewParameterIsPending[index] = true;
+        webviewPendingParameters.push_back(index);
+    }
+}
+
+void UI::PrivateData::flushWebViewParameters()
+{
+    if (webviewPendingParameters.empty())
+        return;
+
+   #if DISTRHO_UI_WEB_VIEW_PARAMETER_RATE > 0
+    const uint32_t now = d_gettime_ms();
+
+    if (now - webviewLastParameterFlush < 1000 / DISTRHO_UI_WEB_VIEW_PARAMETER_RATE)
+        return;
+
+    webviewLastParameterFlush = now;
+   #endif
+
+    const size_t count = webviewPendingParameters.size();
+    std::vector<uint8_t> data(count * 8);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint32_t index = webviewPendingParameters[i];
+        std::memcpy(data.data() + i * 8, &index, sizeof(uint32_t));
+        std::memcpy(data.data() + i * 8 + 4, &webviewParameterValues[index], sizeof(float));
+        webviewParameterIsPending[index] = false;
+    }
+
+    webviewPendingParameters.clear();
+
+    String js("typeof(_dpfParametersChanged) === 'function' && _dpfParametersChanged('");
+    js += String::asBase64(data.data(), data.size());
+    js += "')";
+    webViewEvaluateJS(webview, js);
+}
 #endif
 
 /* ------------------------------------------------------------------------------------------------------------
@@ -446,16 +551,9 @@ void* UI::getPluginInstancePointer() const noexcept
 void UI::parameterChanged(const uint32_t index, const float value)
 {
    #if DISTRHO_UI_USE_WEB_VIEW
-    if (uiData->webview != nullptr)
-    {
-        char msg[128];
-        {
-            const ScopedSafeLocale ssl;
-            std::snprintf(msg, sizeof(msg) - 1,
-                          "typeof(parameterChanged) === 'function' && parameterChanged(%u,%f)", index, value);
-        }
-        webViewEvaluateJS(uiData->webview, msg);
-    }
+    // mirrored through shared memory where possible, otherwise sent in batches on idle, see flushWebViewParameters()
+    if (uiData->webview != nullptr && ! webViewSetSharedValue(uiData->webview, index, value))
+        uiData->webViewParameterChanged(index, value);
    #else
     // unused
     (void)index;
@@ -204,7 +204,10 @@ public:
 
        #if DISTRHO_UI_USE_WEB_VIEW
         if (uiData->webview != nullptr)
+        {
+            uiData->flushWebViewParameters();
             webViewIdle(uiData->webview);
+        }
        #endif
 
         ui->uiIdle();
@@ -226,7 +229,10 @@ public:
 
        #if DISTRHO_UI_USE_WEB_VIEW
         if (uiData->webview != nullptr)
+        {
+            uiData->flushWebViewParameters();
             webViewIdle(uiData->webview);
+        }
        #endif
 
         ui->uiIdle();
@@ -261,7 +267,10 @@ public:
 
        #if DISTRHO_UI_USE_WEB_VIEW
         if (uiData->webview != nullptr)
+        {
+            uiData->flushWebViewParameters();
             webViewIdle(uiData->webview);
+        }
        #endif
 
         ui->uiIdle();
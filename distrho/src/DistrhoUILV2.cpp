@@ -94,6 +94,10 @@ public:
           fURIDs(uridMap),
           fBypassParameterIndex(fUiPortMap != nullptr ? fUiPortMap->port_index(fUiPortMap->handle, ParameterDesignationSymbols::bypass_lv2)
                                                       : LV2UI_INVALID_PORT_INDEX),
+         #if DISTRHO_PLUGIN_WANT_FREEWHEELING
+          fFreeWheelPortIndex(fUiPortMap != nullptr ? fUiPortMap->port_index(fUiPortMap->handle, "lv2_freewheel")
+                                                    : LV2UI_INVALID_PORT_INDEX),
+         #endif
           fWinIdWasNull(winId == 0),
           fUI(this, winId, sampleRate,
               editParameterCallback,
@@ -164,6 +168,10 @@ public:
 
             if (rindex < parameterOffset)
                 return;
+           #if DISTRHO_PLUGIN_WANT_FREEWHEELING
+            if (rindex == fFreeWheelPortIndex)
+                return;
+           #endif
 
             DISTRHO_SAFE_ASSERT_RETURN(bufferSize == sizeof(float),)
 
@@ -349,6 +357,11 @@ private:
     // index of bypass parameter, if present
     const uint32_t fBypassParameterIndex;
 
+   #if DISTRHO_PLUGIN_WANT_FREEWHEELING
+    // index of host freewheel port, not a parameter
+    const uint32_t fFreeWheelPortIndex;
+   #endif
+
     // using ui:showInterface if true
     const bool fWinIdWasNull;
 
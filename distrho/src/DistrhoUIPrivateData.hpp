@@ -34,6 +34,7 @@
 
 #if DISTRHO_UI_USE_WEB_VIEW
 # include "extra/WebView.hpp"
+# include <vector>
 #endif
 
 #if defined(DISTRHO_PLUGIN_TARGET_JACK) || defined(DISTRHO_PLUGIN_TARGET_DSSI)
@@ -262,6 +263,11 @@ struct UI::PrivateData {
     ScopedPointer<PluginWindow> window;
    #if DISTRHO_UI_USE_WEB_VIEW
     WebViewHandle webview;
+    // parameter changes waiting to be sent to the web view, coalesced per index
+    std::vector<uint32_t> webviewPendingParameters;
+    std::vector<float> webviewParameterValues;
+    std::vector<bool> webviewParameterIsPending;
+    uint32_t webviewLastParameterFlush;
    #endif
 
     // DSP
@@ -297,6 +303,10 @@ struct UI::PrivateData {
           window(nullptr),
          #if DISTRHO_UI_USE_WEB_VIEW
           webview(nullptr),
+          webviewPendingParameters(),
+          webviewParameterValues(),
+          webviewParameterIsPending(),
+          webviewLastParameterFlush(0),
          #endif
           sampleRate(0),
           parameterOffset(0),
@@ -389,6 +399,8 @@ struct UI::PrivateData {
     static PluginWindow& createNextWindow(UI* ui, uint width, uint height);
    #if DISTRHO_UI_USE_WEB_VIEW
     static void webViewMessageCallback(void* arg, char* msg);
+    void webViewParameterChanged(uint32_t index, float value);
+    void flushWebViewParameters();
    #endif
 };
 
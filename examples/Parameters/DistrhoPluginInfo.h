@@ -25,6 +25,7 @@
 #define DISTRHO_PLUGIN_BRAND_ID  Dstr
 #define DISTRHO_PLUGIN_UNIQUE_ID dPrm
 
+#define DISTRHO_PLUGIN_HAS_METADATA  1
 #define DISTRHO_PLUGIN_HAS_UI        1
 #define DISTRHO_PLUGIN_IS_RT_SAFE    1
 #define DISTRHO_PLUGIN_NUM_INPUTS    2
@@ -21,21 +21,14 @@ START_NAMESPACE_DISTRHO
 // -----------------------------------------------------------------------------------------------------------
 
 /**
-  Simple plugin to demonstrate parameter usage (including UI).
-  The plugin will be treated as an effect, but it will not change the host audio.
+  Plugin information, ports, parameters and programs, without any DSP.
+  Hosts scanning for plugins get a metadata-only instance of this class, see createPluginMetadata().
  */
-class ExamplePluginParameters : public Plugin
+class ExamplePluginParametersMetadata : public Plugin
 {
 public:
-    ExamplePluginParameters()
-        : Plugin(9, 2, 0) // 9 parameters, 2 programs, 0 states
-    {
-       /**
-          Initialize all our parameters to their defaults.
-          In this example all parameters have 0 as default, so we can simply zero them.
-        */
-        std::memset(fParamGrid, 0, sizeof(float)*9);
-    }
+    ExamplePluginParametersMetadata()
+        : Plugin(9, 2, 0) {} // 9 parameters, 2 programs, 0 states
 
 protected:
    /* --------------------------------------------------------------------------------------------------------
@@ -230,6 +223,40 @@ The plugin will be treated as an effect, but it will not change the host audio."
         }
     }
 
+   /* --------------------------------------------------------------------------------------------------------
+    * Process */
+
+   /**
+      Metadata-only instances are never activated or run, so there is nothing to do here.
+    */
+    void run(const float**, float**, uint32_t) override {}
+
+    // -------------------------------------------------------------------------------------------------------
+
+private:
+    DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ExamplePluginParametersMetadata)
+};
+
+// -----------------------------------------------------------------------------------------------------------
+
+/**
+  Simple plugin to demonstrate parameter usage (including UI).
+  The plugin will be treated as an effect, but it will not change the host audio.
+ */
+class ExamplePluginParameters : public ExamplePluginParametersMetadata
+{
+public:
+    ExamplePluginParameters()
+        : ExamplePluginParametersMetadata()
+    {
+       /**
+          Initialize all our parameters to their defaults.
+          In this example all parameters have 0 as default, so we can simply zero them.
+        */
+        std::memset(fParamGrid, 0, sizeof(float)*9);
+    }
+
+protected:
    /* --------------------------------------------------------------------------------------------------------
     * Internal data */
 
@@ -329,6 +356,14 @@ Plugin* createPlugin()
     return new ExamplePluginParameters();
 }
 
+/* ------------------------------------------------------------------------------------------------------------
+ * Metadata entry point, called by DPF to create a lightweight instance used only for host scans. */
+
+Plugin* createPluginMetadata()
+{
+    return new ExamplePluginParametersMetadata();
+}
+
 // -----------------------------------------------------------------------------------------------------------
 
 END_NAMESPACE_DISTRHO
@@ -0,0 +1,202 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2025 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_PLUGIN_TARGET_CLAP
+# define DISTRHO_PLUGIN_TARGET_CLAP
+#endif
+
+#include "dpf_tests.hpp"
+
+#include "distrho/DistrhoPluginMain.cpp"
+
+// --------------------------------------------------------------------------------------------------------------------
+
+START_NAMESPACE_DISTRHO
+
+// keeps the number of MIDI events it receives in each block
+class TestPlugin : public Plugin
+{
+public:
+    TestPlugin()
+        : Plugin(0, 0, 0),
+          lastMidiEventCount(0) {}
+
+    uint32_t lastMidiEventCount;
+
+protected:
+    const char* getLabel() const override { return "Test"; }
+    const char* getMaker() const override { return "DISTRHO"; }
+    const char* getLicense() const override { return "ISC"; }
+    uint32_t getVersion() const override { return d_version(1, 0, 0); }
+    int64_t getUniqueId() const override { return d_cconst('d', 'T', 's', 't'); }
+
+    void run(const float** const inputs, float** const outputs, const uint32_t frames,
+             const MidiEvent*, const uint32_t midiEventCount) override
+    {
+        std::memcpy(outputs[0], inputs[0], sizeof(float) * frames);
+        lastMidiEventCount = midiEventCount;
+    }
+};
+
+static TestPlugin* sLastPlugin = nullptr;
+
+Plugin* createPlugin()
+{
+    sLastPlugin = new TestPlugin();
+    return sLastPlugin;
+}
+
+END_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+// minimal host, without any extensions
+
+static const void* CLAP_ABI host_get_extension(const clap_host_t*, const char*)
+{
+    return nullptr;
+}
+
+static void CLAP_ABI host_request(const clap_host_t*)
+{
+}
+
+static const clap_host_t kHost = {
+    CLAP_VERSION,
+    nullptr,
+    "DPF tests",
+    "DISTRHO",
+    "",
+    "1.0",
+    host_get_extension,
+    host_request,
+    host_request,
+    host_request
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static const uint32_t kBufferSize = 2048;
+static const uint32_t kMaxTestEvents = 4096;
+
+struct TestEvents {
+    clap_event_midi_t events[kMaxTestEvents];
+    uint32_t count;
+};
+
+static uint32_t CLAP_ABI events_size(const clap_input_events_t* const list)
+{
+    return static_cast<const TestEvents*>(list->ctx)->count;
+}
+
+static const clap_event_header_t* CLAP_ABI events_get(const clap_input_events_t* const list, const uint32_t index)
+{
+    return &static_cast<const TestEvents*>(list->ctx)->events[index].header;
+}
+
+static void fillNoteEvents(TestEvents& events, const uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const clap_event_midi_t event = {
+            { sizeof(clap_event_midi_t), std::min(i, kBufferSize - 1), 0, CLAP_EVENT_MIDI, 0 },
+            0, { 0x90, static_cast<uint8_t>(i % 128), 100 }
+        };
+        events.events[i] = event;
+    }
+    events.count = count;
+}
+
+static void processBlock(const clap_plugin_t* const plugin, TestEvents& events)
+{
+    static float input[kBufferSize];
+    static float output[kBufferSize];
+    float* inputs[1] = { input };
+    float* outputs[1] = { output };
+
+    const clap_audio_buffer_t inputBuffer = { inputs, nullptr, 1, 0, 0 };
+    clap_audio_buffer_t outputBuffer = { outputs, nullptr, 1, 0, 0 };
+    const clap_input_events_t in = { &events, events_size, events_get };
+
+    const clap_process_t process = {
+        -1, kBufferSize, nullptr,
+        &inputBuffer, &outputBuffer, 1, 1,
+        &in, nullptr
+    };
+
+    plugin->process(plugin, &process);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    USE_NAMESPACE_DISTRHO;
+
+    DISTRHO_ASSERT_EQUAL(clap_entry.init(""), true, "entry init");
+
+    const clap_plugin_factory_t* const factory
+        = static_cast<const clap_plugin_factory_t*>(clap_entry.get_factory(CLAP_PLUGIN_FACTORY_ID));
+    DISTRHO_ASSERT_NOT_EQUAL(factory, nullptr, "plugin factory");
+
+    const clap_plugin_t* const plugin = factory->create_plugin(factory, &kHost, DISTRHO_PLUGIN_CLAP_ID);
+    DISTRHO_ASSERT_NOT_EQUAL(plugin, nullptr, "plugin creation");
+    DISTRHO_ASSERT_EQUAL(plugin->init(plugin), true, "plugin init");
+
+    TestPlugin* const testPlugin = sLastPlugin;
+    DISTRHO_ASSERT_EQUAL(testPlugin->getDroppedMidiEventCount(), 0u, "no events dropped before processing");
+
+    DISTRHO_ASSERT_EQUAL(plugin->activate(plugin, 48000.0, 1, kBufferSize), true, "plugin activate");
+    DISTRHO_ASSERT_EQUAL(plugin->start_processing(plugin), true, "plugin start processing");
+
+    static TestEvents events;
+
+    // the buffer size is higher than kMaxMidiEvents, so the pool holds one event per frame
+    {
+        fillNoteEvents(events, kBufferSize + 100);
+        processBlock(plugin, events);
+
+        DISTRHO_ASSERT_EQUAL(testPlugin->lastMidiEventCount, kBufferSize, "plugin receives as many events as fit");
+        DISTRHO_ASSERT_EQUAL(testPlugin->getDroppedMidiEventCount(), 100u, "events that do not fit are counted");
+    }
+
+    // the count is kept across blocks, and blocks that fit do not change it
+    {
+        fillNoteEvents(events, 10);
+        processBlock(plugin, events);
+
+        DISTRHO_ASSERT_EQUAL(testPlugin->lastMidiEventCount, 10u, "plugin receives all events");
+        DISTRHO_ASSERT_EQUAL(testPlugin->getDroppedMidiEventCount(), 100u, "dropped event count is unchanged");
+    }
+
+    {
+        fillNoteEvents(events, kBufferSize + 1);
+        processBlock(plugin, events);
+
+        DISTRHO_ASSERT_EQUAL(testPlugin->getDroppedMidiEventCount(), 101u, "dropped events add up");
+    }
+
+    plugin->stop_processing(plugin);
+    plugin->deactivate(plugin);
+
+    // the deactivate report does not reset the count
+    DISTRHO_ASSERT_EQUAL(testPlugin->getDroppedMidiEventCount(), 101u, "dropped event count survives deactivation");
+
+    plugin->destroy(plugin);
+    clap_entry.deinit();
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
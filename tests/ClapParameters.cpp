@@ -0,0 +1,203 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2025 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_PLUGIN_TARGET_CLAP
+# define DISTRHO_PLUGIN_TARGET_CLAP
+#endif
+
+#include "dpf_tests.hpp"
+
+#include "distrho/DistrhoPluginMain.cpp"
+
+// --------------------------------------------------------------------------------------------------------------------
+
+START_NAMESPACE_DISTRHO
+
+static const uint32_t kNumParameters = 2;
+
+// keeps the values it receives, so they can be compared against the ones reported to the host
+class TestPlugin : public Plugin
+{
+public:
+    TestPlugin()
+        : Plugin(kNumParameters, 0, 0)
+    {
+        std::memset(values, 0, sizeof(values));
+    }
+
+    float values[kNumParameters];
+
+protected:
+    const char* getLabel() const override { return "Test"; }
+    const char* getMaker() const override { return "DISTRHO"; }
+    const char* getLicense() const override { return "ISC"; }
+    uint32_t getVersion() const override { return d_version(1, 0, 0); }
+    int64_t getUniqueId() const override { return d_cconst('d', 'T', 's', 't'); }
+
+    void initParameter(const uint32_t index, Parameter& parameter) override
+    {
+        parameter.hints = kParameterIsAutomatable;
+        parameter.name = index == 0 ? "First" : "Second";
+        parameter.symbol = index == 0 ? "first" : "second";
+        parameter.ranges.min = 0.f;
+        parameter.ranges.max = 100.f;
+        parameter.ranges.def = 0.f;
+    }
+
+    float getParameterValue(const uint32_t index) const override
+    {
+        return values[index];
+    }
+
+    void setParameterValue(const uint32_t index, const float value) override
+    {
+        values[index] = value;
+    }
+
+    void run(const float** const inputs, float** const outputs, const uint32_t frames,
+             const MidiEvent*, uint32_t) override
+    {
+        std::memcpy(outputs[0], inputs[0], sizeof(float) * frames);
+    }
+};
+
+static TestPlugin* sLastPlugin = nullptr;
+
+Plugin* createPlugin()
+{
+    sLastPlugin = new TestPlugin();
+    return sLastPlugin;
+}
+
+END_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+// minimal host, without any extensions
+
+static const void* CLAP_ABI host_get_extension(const clap_host_t*, const char*)
+{
+    return nullptr;
+}
+
+static void CLAP_ABI host_request(const clap_host_t*)
+{
+}
+
+static const clap_host_t kHost = {
+    CLAP_VERSION,
+    nullptr,
+    "DPF tests",
+    "DISTRHO",
+    "",
+    "1.0",
+    host_get_extension,
+    host_request,
+    host_request,
+    host_request
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+struct TestEvents {
+    clap_event_param_value_t events[16];
+    uint32_t count;
+};
+
+static uint32_t CLAP_ABI events_size(const clap_input_events_t* const list)
+{
+    return static_cast<const TestEvents*>(list->ctx)->count;
+}
+
+static const clap_event_header_t* CLAP_ABI events_get(const clap_input_events_t* const list, const uint32_t index)
+{
+    return &static_cast<const TestEvents*>(list->ctx)->events[index].header;
+}
+
+static void addEvent(TestEvents& events, const uint32_t index, const double value)
+{
+    const clap_event_param_value_t event = {
+        { sizeof(clap_event_param_value_t), 0, 0, CLAP_EVENT_PARAM_VALUE, 0 },
+        index, nullptr, -1, -1, -1, -1, value
+    };
+    events.events[events.count++] = event;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    USE_NAMESPACE_DISTRHO;
+
+    DISTRHO_ASSERT_EQUAL(clap_entry.init(""), true, "entry init");
+
+    const clap_plugin_factory_t* const factory
+        = static_cast<const clap_plugin_factory_t*>(clap_entry.get_factory(CLAP_PLUGIN_FACTORY_ID));
+    DISTRHO_ASSERT_NOT_EQUAL(factory, nullptr, "plugin factory");
+
+    const clap_plugin_t* const plugin = factory->create_plugin(factory, &kHost, DISTRHO_PLUGIN_CLAP_ID);
+    DISTRHO_ASSERT_NOT_EQUAL(plugin, nullptr, "plugin creation");
+    DISTRHO_ASSERT_EQUAL(plugin->init(plugin), true, "plugin init");
+
+    TestPlugin* const testPlugin = sLastPlugin;
+
+    const clap_plugin_params_t* const params
+        = static_cast<const clap_plugin_params_t*>(plugin->get_extension(plugin, CLAP_EXT_PARAMS));
+    DISTRHO_ASSERT_NOT_EQUAL(params, nullptr, "params extension");
+    DISTRHO_ASSERT_EQUAL(params->count(plugin), kNumParameters, "parameter count");
+
+    // a single flush with more events than parameters, repeating the same ids
+    {
+        TestEvents events;
+        events.count = 0;
+        addEvent(events, 0, 10.0);
+        addEvent(events, 1, 20.0);
+        addEvent(events, 0, 30.0);
+        addEvent(events, 0, 40.0);
+        addEvent(events, 1, 50.0);
+
+        const clap_input_events_t in = { &events, events_size, events_get };
+        params->flush(plugin, &in, nullptr);
+
+        double value = 0.0;
+        DISTRHO_ASSERT_EQUAL(params->get_value(plugin, 0, &value), true, "get first parameter value");
+        DISTRHO_ASSERT_SAFE_EQUAL(value, 40.0, "first parameter reports last flushed value");
+        DISTRHO_ASSERT_SAFE_EQUAL(testPlugin->values[0], 40.f, "first parameter was given its last flushed value");
+
+        DISTRHO_ASSERT_EQUAL(params->get_value(plugin, 1, &value), true, "get second parameter value");
+        DISTRHO_ASSERT_SAFE_EQUAL(value, 50.0, "second parameter reports last flushed value");
+        DISTRHO_ASSERT_SAFE_EQUAL(testPlugin->values[1], 50.f, "second parameter was given its last flushed value");
+    }
+
+    // flushes are independent, a new one starts with an empty list
+    {
+        TestEvents events;
+        events.count = 0;
+        addEvent(events, 1, 60.0);
+        addEvent(events, 1, 70.0);
+
+        const clap_input_events_t in = { &events, events_size, events_get };
+        params->flush(plugin, &in, nullptr);
+
+        DISTRHO_ASSERT_SAFE_EQUAL(testPlugin->values[0], 40.f, "first parameter is untouched");
+        DISTRHO_ASSERT_SAFE_EQUAL(testPlugin->values[1], 70.f, "second parameter was given its last flushed value");
+    }
+
+    plugin->destroy(plugin);
+    clap_entry.deinit();
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
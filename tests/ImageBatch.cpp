@@ -0,0 +1,156 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2025 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "tests.hpp"
+
+#include "dgl/OpenGL.hpp"
+#include "dgl/StandaloneWindow.hpp"
+#include "distrho/extra/Time.hpp"
+
+START_NAMESPACE_DGL
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static const uint kImageSize = 24;
+static const uint kImageTypes = 8;
+static const uint kColumns = 32;
+static const uint kRows = 20;
+static const uint kFramesPerMode = 300;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+class ImageBatchBenchmark : public StandaloneWindow,
+                            public IdleCallback
+{
+    char imageData[kImageTypes][kImageSize * kImageSize * 4];
+    OpenGLImage images[kImageTypes];
+    OpenGLImageAtlas atlas;
+    OpenGLImageBatch batch;
+    uint imageIds[kImageTypes];
+    uint frame;
+    uint64_t timeSingle;
+    uint64_t timeBatched;
+
+public:
+    ImageBatchBenchmark(Application& app)
+      : StandaloneWindow(app),
+        atlas(256, 256),
+        batch(atlas),
+        frame(0),
+        timeSingle(0),
+        timeBatched(0)
+    {
+        // simple knob-like images, a colored circle on a transparent background
+        for (uint i = 0; i < kImageTypes; ++i)
+        {
+            for (uint y = 0; y < kImageSize; ++y)
+            {
+                for (uint x = 0; x < kImageSize; ++x)
+                {
+                    const int dx = static_cast<int>(x) - static_cast<int>(kImageSize / 2);
+                    const int dy = static_cast<int>(y) - static_cast<int>(kImageSize / 2);
+                    const bool inside = dx * dx + dy * dy < static_cast<int>(kImageSize * kImageSize / 4);
+
+                    char* const pixel = imageData[i] + (y * kImageSize + x) * 4;
+                    pixel[0] = static_cast<char>(i * 32);
+                    pixel[1] = static_cast<char>(x * 10);
+                    pixel[2] = static_cast<char>(y * 10);
+                    pixel[3] = static_cast<char>(inside ? 0xff : 0);
+                }
+            }
+
+            images[i].loadFromMemory(imageData[i], kImageSize, kImageSize, kImageFormatBGRA);
+
+            const bool added = atlas.addImage(images[i], imageIds[i]);
+            DISTRHO_SAFE_ASSERT(added);
+        }
+
+        setSize(kColumns * kImageSize, kRows * kImageSize);
+        setTitle("ImageBatch");
+        done();
+
+        addIdleCallback(this);
+    }
+
+protected:
+    void onDisplay() override
+    {
+        const GraphicsContext& context(getGraphicsContext());
+        const bool batched = frame >= kFramesPerMode;
+
+        const uint64_t start = d_gettime_us();
+
+        for (uint r = 0; r < kRows; ++r)
+        {
+            for (uint c = 0; c < kColumns; ++c)
+            {
+                const uint type = (r * kColumns + c + frame) % kImageTypes;
+                const Point<int> pos(static_cast<int>(c * kImageSize), static_cast<int>(r * kImageSize));
+
+                if (batched)
+                    batch.add(imageIds[type], pos);
+                else
+                    images[type].drawAt(context, pos);
+            }
+        }
+
+        if (batched)
+            batch.draw(context);
+
+        // wait for the GPU, so the time includes the actual drawing
+        glFinish();
+
+        (batched ? timeBatched : timeSingle) += d_gettime_us() - start;
+        ++frame;
+    }
+
+    void idleCallback() noexcept override
+    {
+        if (frame < kFramesPerMode * 2)
+        {
+            repaint();
+            return;
+        }
+
+        removeIdleCallback(this);
+
+        d_stdout("%u images per frame: single draws %u us/frame, batched %u us/frame",
+                 kColumns * kRows,
+                 static_cast<uint>(timeSingle / kFramesPerMode),
+                 static_cast<uint>(timeBatched / kFramesPerMode));
+
+        getApp().quit();
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DGL
+
+int main()
+{
+    using DGL_NAMESPACE::Application;
+    using DGL_NAMESPACE::ImageBatchBenchmark;
+
+    Application app(true);
+    ImageBatchBenchmark win(app);
+    win.show();
+    app.exec();
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
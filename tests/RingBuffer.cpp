@@ -0,0 +1,182 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "dpf_tests.hpp"
+
+#include "distrho/extra/RingBuffer.hpp"
+#include "distrho/extra/Thread.hpp"
+#include "distrho/extra/Time.hpp"
+
+#include <sched.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static const uint32_t kBufferSize = 16384;
+static const uint32_t kMessageCount = 2000000;
+
+// similar in size to a parameter change or small MIDI event, as sent between audio and UI threads
+struct Message {
+    uint32_t index;
+    float values[3];
+};
+
+static void fillMessage(Message& msg, const uint32_t index)
+{
+    msg.index = index;
+    msg.values[0] = static_cast<float>(index);
+    msg.values[1] = static_cast<float>(index % 127);
+    msg.values[2] = static_cast<float>(index % 3);
+}
+
+// writes all messages from a separate thread, waiting for space whenever the buffer is full
+template <class RingBufferType>
+class ProducerThread : public Thread
+{
+public:
+    ProducerThread(RingBufferType& rb)
+        : Thread("RingBuffer producer"),
+          emptyCount(0),
+          ringBuffer(rb) {}
+
+    // times the producer found the buffer empty, checked from the writing side on purpose
+    uint32_t emptyCount;
+
+protected:
+    void run() override
+    {
+        Message msg;
+
+        for (uint32_t i = 0; i < kMessageCount; ++i)
+        {
+            fillMessage(msg, i);
+
+            if (ringBuffer.isEmpty())
+                ++emptyCount;
+
+            while (! ringBuffer.isSpaceAvailableForWriting(sizeof(Message)))
+            {
+                if (shouldThreadExit())
+                    return;
+
+                // let the consumer run in case both threads share a core
+                sched_yield();
+            }
+
+            ringBuffer.writeCustomType(msg);
+            ringBuffer.commitWrite();
+        }
+    }
+
+private:
+    RingBufferType& ringBuffer;
+};
+
+template <class RingBufferType>
+static int runTestsPerType(const char* const name)
+{
+    RingBufferType ringBuffer;
+    DISTRHO_ASSERT_EQUAL(ringBuffer.createBuffer(kBufferSize), true, "buffer creation");
+
+    // single thread, with data wrapping around the end of the buffer
+    {
+        Message msg, expected;
+
+        for (uint32_t i = 0; i < kBufferSize; ++i)
+        {
+            fillMessage(msg, i);
+            DISTRHO_ASSERT_EQUAL(ringBuffer.writeCustomType(msg), true, "write");
+            DISTRHO_ASSERT_EQUAL(ringBuffer.commitWrite(), true, "commit");
+            DISTRHO_ASSERT_EQUAL(ringBuffer.isDataAvailableForReading(), true, "data available after commit");
+            DISTRHO_ASSERT_EQUAL(ringBuffer.readCustomType(msg), true, "read");
+
+            fillMessage(expected, i);
+            DISTRHO_ASSERT_EQUAL(std::memcmp(&msg, &expected, sizeof(Message)), 0, "read matches write");
+        }
+
+        DISTRHO_ASSERT_EQUAL(ringBuffer.isEmpty(), true, "empty after reading everything");
+        DISTRHO_ASSERT_EQUAL(ringBuffer.getWritableDataSize(), kBufferSize - 1, "all space available");
+
+        // fill the buffer until writes fail
+        uint32_t count = 0;
+        while (ringBuffer.isSpaceAvailableForWriting(sizeof(Message)))
+        {
+            fillMessage(msg, count++);
+            ringBuffer.writeCustomType(msg);
+            ringBuffer.commitWrite();
+        }
+
+        DISTRHO_ASSERT_EQUAL(count, (kBufferSize - 1) / sizeof(Message), "messages fitting in the buffer");
+        DISTRHO_ASSERT_EQUAL(ringBuffer.getReadableDataSize(), count * sizeof(Message), "readable size when full");
+
+        ringBuffer.flush();
+        DISTRHO_ASSERT_EQUAL(ringBuffer.isEmpty(), true, "empty after flush");
+    }
+
+    // producer and consumer on separate threads
+    {
+        ProducerThread<RingBufferType> producer(ringBuffer);
+
+        Message msg, expected;
+        uint32_t received = 0;
+
+        const uint64_t t1 = d_gettime_us();
+        DISTRHO_ASSERT_EQUAL(producer.startThread(), true, "producer thread start");
+
+        while (received < kMessageCount)
+        {
+            if (! ringBuffer.isDataAvailableForReading())
+            {
+                sched_yield();
+                continue;
+            }
+
+            if (! ringBuffer.readCustomType(msg))
+                break;
+
+            fillMessage(expected, received++);
+
+            if (std::memcmp(&msg, &expected, sizeof(Message)) != 0)
+                break;
+        }
+
+        const uint64_t t2 = d_gettime_us();
+        producer.stopThread(-1);
+
+        DISTRHO_ASSERT_EQUAL(received, kMessageCount, "all messages received in order");
+        DISTRHO_ASSERT_EQUAL(producer.emptyCount != 0, true, "buffer seen empty by the producer at least once");
+
+        const double seconds = static_cast<double>(t2 - t1) / 1000000.0;
+        d_stdout("%s: %u messages in %u us, %.2f MB/s",
+                 name, kMessageCount, static_cast<uint>(t2 - t1),
+                 static_cast<double>(kMessageCount * sizeof(Message)) / 1000000.0 / seconds);
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    if (runTestsPerType<HeapRingBuffer>("HeapRingBuffer"))
+        return 1;
+    if (runTestsPerType<AlignedHeapRingBuffer>("AlignedHeapRingBuffer"))
+        return 1;
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,203 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2025 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "dpf_tests.hpp"
+
+#include "distrho/extra/String.hpp"
+
+#include <map>
+#include <utility>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+// lengths around the inline buffer size, which is an implementation detail but 24 is what we have now
+static const size_t kLengths[] = { 0, 1, 7, 22, 23, 24, 25, 64, 300 };
+
+static String makeString(const size_t length, const char first = 'a')
+{
+    char buf[512];
+    for (size_t i = 0; i < length; ++i)
+        buf[i] = static_cast<char>(first + i % 26);
+    buf[length] = '\0';
+    return String(buf);
+}
+
+static int runLengthTests(const size_t length)
+{
+    const String orig(makeString(length));
+    DISTRHO_ASSERT_EQUAL(orig.length(), length, "construction length");
+
+    // copies
+    {
+        String copy(orig);
+        DISTRHO_ASSERT_EQUAL(copy, orig, "copy constructor");
+        DISTRHO_ASSERT_EQUAL(copy.length(), length, "copy constructor length");
+
+        String assigned("something else");
+        assigned = orig;
+        DISTRHO_ASSERT_EQUAL(assigned, orig, "copy assignment");
+
+        // self-assignment must keep contents
+        const String& ref(assigned);
+        assigned = ref;
+        DISTRHO_ASSERT_EQUAL(assigned, orig, "self copy assignment");
+
+        // modifying the copy must not touch the original
+        if (length != 0)
+        {
+            copy.toUpper();
+            DISTRHO_ASSERT_EQUAL(copy != orig, true, "copy is independent");
+        }
+    }
+
+    // moves
+    {
+        String source(orig);
+        String moved(std::move(source));
+        DISTRHO_ASSERT_EQUAL(moved, orig, "move constructor");
+        DISTRHO_ASSERT_EQUAL(source.isEmpty(), true, "move constructor leaves source empty");
+
+        String assigned(makeString(100, 'k'));
+        assigned = std::move(moved);
+        DISTRHO_ASSERT_EQUAL(assigned, orig, "move assignment");
+        DISTRHO_ASSERT_EQUAL(moved.isEmpty(), true, "move assignment leaves source empty");
+
+        // moved-from strings stay usable
+        moved = "reused";
+        DISTRHO_ASSERT_EQUAL(moved, "reused", "moved-from string is reusable");
+
+        // the moved string must not depend on the source object anymore
+        {
+            String tmp(orig);
+            assigned = std::move(tmp);
+        }
+        DISTRHO_ASSERT_EQUAL(assigned, orig, "move assignment outlives source");
+    }
+
+    // appends, crossing from inline to allocated storage
+    {
+        String str;
+        for (size_t i = 0; i < length; ++i)
+        {
+            const char c[2] = { static_cast<char>('a' + i % 26), '\0' };
+            str += c;
+        }
+        DISTRHO_ASSERT_EQUAL(str, orig, "append per character");
+
+        str += orig;
+        DISTRHO_ASSERT_EQUAL(str.length(), length * 2, "append to itself length");
+        DISTRHO_ASSERT_EQUAL(str.startsWith(orig), true, "append start");
+        DISTRHO_ASSERT_EQUAL(str.endsWith(orig), true, "append end");
+
+        const String sum(orig + orig.buffer());
+        DISTRHO_ASSERT_EQUAL(sum, str, "operator+");
+    }
+
+    // buffer release must always give an owned copy
+    {
+        String str(orig);
+        char* const buf = str.getAndReleaseBuffer();
+
+        if (length == 0)
+        {
+            DISTRHO_ASSERT_EQUAL(buf == nullptr, true, "empty release gives null");
+        }
+        else
+        {
+            DISTRHO_ASSERT_EQUAL(buf != nullptr, true, "release gives buffer");
+            DISTRHO_ASSERT_EQUAL(std::strcmp(buf, orig), 0, "released buffer contents");
+            std::free(buf);
+        }
+
+        DISTRHO_ASSERT_EQUAL(str.isEmpty(), true, "release leaves string empty");
+    }
+
+    // views
+    {
+        const StringView view(orig);
+        DISTRHO_ASSERT_EQUAL(view.length(), length, "view length");
+        DISTRHO_ASSERT_EQUAL(view.data(), orig.buffer(), "view points to string");
+        DISTRHO_ASSERT_EQUAL(view == StringView(orig.buffer()), true, "view comparison");
+        DISTRHO_ASSERT_EQUAL(String(view), orig, "string from view");
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    for (size_t i = 0; i < ARRAY_SIZE(kLengths); ++i)
+    {
+        if (runLengthTests(kLengths[i]))
+            return 1;
+    }
+
+    // views into larger, non null-terminated data
+    {
+        static const char kData[] = "parameter=value";
+        const StringView key(kData, 9);
+        const StringView value(kData + 10, 5);
+
+        DISTRHO_ASSERT_EQUAL(key == "parameter", true, "partial view comparison");
+        DISTRHO_ASSERT_EQUAL(key != "param", true, "partial view mismatch");
+        DISTRHO_ASSERT_EQUAL(key.startsWith("param"), true, "view startsWith");
+        DISTRHO_ASSERT_EQUAL(value.endsWith("lue"), true, "view endsWith");
+        DISTRHO_ASSERT_EQUAL(String(key), "parameter", "string from partial view");
+        DISTRHO_ASSERT_EQUAL(StringView().isEmpty(), true, "default view is empty");
+        DISTRHO_ASSERT_EQUAL(StringView(nullptr).isEmpty(), true, "null view is empty");
+
+        // empty views must not be read as null terminated strings
+        DISTRHO_ASSERT_EQUAL(String(StringView()).isEmpty(), true, "string from default view");
+        DISTRHO_ASSERT_EQUAL(String(StringView(kData, 0)).isEmpty(), true, "string from empty view into data");
+        DISTRHO_ASSERT_EQUAL(String(StringView(kData + 9, 0)).isEmpty(), true, "string from empty view at separator");
+    }
+
+    // updating allocated strings, including from data that points into the string itself
+    {
+        const String orig(makeString(300));
+        String str(orig);
+
+        str = makeString(200, 'b');
+        DISTRHO_ASSERT_EQUAL(str, makeString(200, 'b'), "long to long assignment");
+
+        str = orig;
+        str = str.buffer() + 1;
+        DISTRHO_ASSERT_EQUAL(str, orig.buffer() + 1, "assignment from own buffer");
+
+        str = str.buffer() + 290;
+        DISTRHO_ASSERT_EQUAL(str, orig.buffer() + 291, "assignment from own buffer into inline storage");
+    }
+
+    // strings as map keys, with moves during insertion
+    {
+        std::map<String, int> map;
+        for (int i = 0; i < 50; ++i)
+            map[makeString(static_cast<size_t>(i), 'a')] = i;
+
+        DISTRHO_ASSERT_EQUAL(map.size(), 50, "map size");
+
+        for (int i = 0; i < 50; ++i)
+        {
+            DISTRHO_ASSERT_EQUAL(map[makeString(static_cast<size_t>(i), 'a')], i, "map lookup");
+        }
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
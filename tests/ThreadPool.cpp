@@ -0,0 +1,148 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "dpf_tests.hpp"
+
+#include "distrho/extra/ThreadPool.hpp"
+#include "distrho/extra/Time.hpp"
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static const uint32_t kMaxCount = 1000;
+static const uint32_t kVoiceFrames = 2048;
+
+struct TestData {
+    uint32_t calls[kMaxCount];
+    float output[kMaxCount];
+};
+
+static void countCall(void* const userData, const uint32_t index)
+{
+    TestData* const data = static_cast<TestData*>(userData);
+    __atomic_add_fetch(&data->calls[index], 1, __ATOMIC_RELAXED);
+}
+
+// fake voice rendering, with some voices being a lot more expensive than others
+static void renderVoice(void* const userData, const uint32_t index)
+{
+    TestData* const data = static_cast<TestData*>(userData);
+    const uint32_t frames = index % 4 == 0 ? kVoiceFrames * 8 : kVoiceFrames;
+
+    float phase = 0.f;
+    for (uint32_t i = 0; i < frames; ++i)
+        phase = std::fmod(phase + static_cast<float>(index + 1) * 0.001f, 1.f);
+
+    data->output[index] = phase;
+}
+
+static int runCountTests(ThreadPool& pool, TestData& data)
+{
+    static const uint32_t kCounts[] = { 1, 2, 3, 7, 16, 17, 64, 999, kMaxCount };
+
+    for (uint32_t c = 0; c < ARRAY_SIZE(kCounts); ++c)
+    {
+        const uint32_t count = kCounts[c];
+
+        // repeat a few times, to make sure workers are properly parked and woken up between calls
+        for (uint32_t r = 0; r < 50; ++r)
+        {
+            std::memset(data.calls, 0, sizeof(data.calls));
+
+            pool.parallelFor(count, countCall, &data);
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                DISTRHO_ASSERT_EQUAL(data.calls[i], 1, "each index is called exactly once");
+            }
+            for (uint32_t i = count; i < kMaxCount; ++i)
+            {
+                DISTRHO_ASSERT_EQUAL(data.calls[i], 0, "indexes out of range are not called");
+            }
+        }
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    static TestData data;
+    static float serialOutput[kMaxCount];
+
+    // no workers, everything runs in the calling thread
+    {
+        ThreadPool pool;
+        DISTRHO_ASSERT_EQUAL(pool.getNumWorkers(), 0, "no workers before start");
+
+        if (runCountTests(pool, data))
+            return 1;
+    }
+
+    // fixed amount of workers, more than CPU cores is fine too
+    {
+        ThreadPool pool;
+        DISTRHO_ASSERT_EQUAL(pool.start(3, false), true, "pool start");
+        DISTRHO_ASSERT_EQUAL(pool.getNumWorkers(), 3, "pool worker count");
+
+        if (runCountTests(pool, data))
+            return 1;
+
+        // restart, like a plugin being deactivated and activated again
+        pool.stop();
+        DISTRHO_ASSERT_EQUAL(pool.getNumWorkers(), 0, "no workers after stop");
+        DISTRHO_ASSERT_EQUAL(pool.start(5, false), true, "pool restart");
+
+        if (runCountTests(pool, data))
+            return 1;
+    }
+
+    // uneven workload, compared against serial rendering
+    {
+        ThreadPool pool;
+        DISTRHO_ASSERT_EQUAL(pool.start(0, false), true, "pool start with automatic worker count");
+
+        static const uint32_t kVoices = 64;
+        static const uint32_t kRuns = 200;
+
+        const uint64_t t1 = d_gettime_us();
+        for (uint32_t r = 0; r < kRuns; ++r)
+        {
+            for (uint32_t i = 0; i < kVoices; ++i)
+                renderVoice(&data, i);
+        }
+        std::memcpy(serialOutput, data.output, sizeof(float) * kVoices);
+
+        const uint64_t t2 = d_gettime_us();
+        for (uint32_t r = 0; r < kRuns; ++r)
+            pool.parallelFor(kVoices, renderVoice, &data);
+
+        const uint64_t t3 = d_gettime_us();
+
+        for (uint32_t i = 0; i < kVoices; ++i)
+        {
+            DISTRHO_ASSERT_EQUAL(data.output[i], serialOutput[i], "parallel rendering matches serial");
+        }
+
+        d_stdout("%u voices with %u workers: serial %u us, parallel %u us",
+                 kVoices, pool.getNumWorkers(), static_cast<uint>(t2 - t1), static_cast<uint>(t3 - t2));
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,194 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "dpf_tests.hpp"
+
+#include "distrho/extra/Time.hpp"
+#include "distrho/extra/ValueSmoother.hpp"
+
+#define DISTRHO_ASSERT_NEAR(v1, v2, msg) \
+    if (std::abs(v1 - v2) > 1e-4f) { d_stderr2("Test condition failed: %s; file:%s line:%i", msg, __FILE__, __LINE__); return 1; }
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static const uint32_t kBufferSize = 509; // not a multiple of any vector size, so tails are tested too
+static const uint32_t kBenchmarkRuns = 20000;
+
+template <class Smoother>
+static void setupSmoother(Smoother& smoother, const float start, const float target)
+{
+    smoother.setSampleRate(48000.f);
+    smoother.setTimeConstant(0.005f);
+    smoother.setTargetValue(start);
+    smoother.clearToTargetValue();
+    smoother.setTargetValue(target);
+}
+
+template <class Smoother>
+static int runTestsPerType(const char* const name)
+{
+    // block fill must match per-sample next()
+    {
+        Smoother a, b;
+        setupSmoother(a, 0.1f, 0.9f);
+        setupSmoother(b, 0.1f, 0.9f);
+
+        float buffer[kBufferSize];
+        b.fill(buffer, kBufferSize);
+
+        for (uint32_t i = 0; i < kBufferSize; ++i)
+        {
+            DISTRHO_ASSERT_NEAR(buffer[i], a.next(), "fill matches next");
+        }
+
+        DISTRHO_ASSERT_NEAR(a.getCurrentValue(), b.getCurrentValue(), "fill leaves same state as next");
+    }
+
+    // same, but going down
+    {
+        Smoother a, b;
+        setupSmoother(a, 1.f, -1.f);
+        setupSmoother(b, 1.f, -1.f);
+
+        float buffer[kBufferSize];
+        b.fill(buffer, kBufferSize);
+
+        for (uint32_t i = 0; i < kBufferSize; ++i)
+        {
+            DISTRHO_ASSERT_NEAR(buffer[i], a.next(), "fill matches next (decreasing)");
+        }
+    }
+
+    // block multiply must match per-sample multiply
+    {
+        Smoother a, b;
+        setupSmoother(a, 0.f, 1.f);
+        setupSmoother(b, 0.f, 1.f);
+
+        float buffer[kBufferSize];
+        for (uint32_t i = 0; i < kBufferSize; ++i)
+            buffer[i] = static_cast<float>(i % 7) * 0.25f - 0.75f;
+
+        b.multiply(buffer, kBufferSize);
+
+        for (uint32_t i = 0; i < kBufferSize; ++i)
+        {
+            const float expected = (static_cast<float>(i % 7) * 0.25f - 0.75f) * a.next();
+            DISTRHO_ASSERT_NEAR(buffer[i], expected, "multiply matches next");
+        }
+
+        DISTRHO_ASSERT_NEAR(a.getCurrentValue(), b.getCurrentValue(), "multiply leaves same state as next");
+    }
+
+    // benchmark against the per-sample loop
+    {
+        Smoother a, b;
+        float buffer[kBufferSize];
+        float sum = 0.f;
+
+        const uint64_t t1 = d_gettime_us();
+        for (uint32_t r = 0; r < kBenchmarkRuns; ++r)
+        {
+            setupSmoother(a, 0.f, r % 2 ? 1.f : 0.5f);
+            for (uint32_t i = 0; i < kBufferSize; ++i)
+                buffer[i] = a.next();
+            sum += buffer[r % kBufferSize];
+        }
+
+        const uint64_t t2 = d_gettime_us();
+        for (uint32_t r = 0; r < kBenchmarkRuns; ++r)
+        {
+            setupSmoother(b, 0.f, r % 2 ? 1.f : 0.5f);
+            b.fill(buffer, kBufferSize);
+            sum += buffer[r % kBufferSize];
+        }
+
+        const uint64_t t3 = d_gettime_us();
+
+        d_stdout("%s: per-sample %u us, block %u us (checksum %f)",
+                 name, static_cast<uint>(t2 - t1), static_cast<uint>(t3 - t2), static_cast<double>(sum));
+    }
+
+    return 0;
+}
+
+template <class SmootherArray, class Smoother>
+static int runArrayTestsPerType()
+{
+    static const uint32_t kCount = 11;
+
+    SmootherArray array;
+    Smoother single[kCount];
+
+    array.setSampleRate(48000.f);
+    array.setTimeConstant(0.005f);
+
+    for (uint32_t i = 0; i < kCount; ++i)
+    {
+        const float target = static_cast<float>(i) / kCount;
+        setupSmoother(single[i], 0.f, target);
+        array.setTargetValue(i, target);
+    }
+
+    // advancing one frame at a time must match individual smoothers
+    for (uint32_t f = 0; f < 64; ++f)
+    {
+        const float* const values = array.next();
+
+        for (uint32_t i = 0; i < kCount; ++i)
+        {
+            DISTRHO_ASSERT_NEAR(values[i], single[i].next(), "array next matches individual next");
+        }
+    }
+
+    // advancing many frames at once must land on the same values
+    array.next(32);
+
+    for (uint32_t i = 0; i < kCount; ++i)
+    {
+        for (uint32_t f = 0; f < 32; ++f)
+            single[i].next();
+
+        DISTRHO_ASSERT_NEAR(array.getCurrentValue(i), single[i].getCurrentValue(), "array skip matches individual next");
+    }
+
+    array.clearToTargetValues();
+
+    for (uint32_t i = 0; i < kCount; ++i)
+    {
+        DISTRHO_ASSERT_EQUAL(array.getCurrentValue(i), array.getTargetValue(i), "array clear to target");
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    if (runTestsPerType<ExponentialValueSmoother>("ExponentialValueSmoother"))
+        return 1;
+    if (runTestsPerType<LinearValueSmoother>("LinearValueSmoother"))
+        return 1;
+    if (runArrayTestsPerType<ExponentialValueSmootherArray<11>, ExponentialValueSmoother>())
+        return 1;
+    if (runArrayTestsPerType<LinearValueSmootherArray<11>, LinearValueSmoother>())
+        return 1;
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -1,5 +1,79 @@
 #include "extra/Base64.hpp"
 #include "extra/String.hpp"
+#include "src/DistrhoPluginState.hpp"
+
+static int printBinaryState(const std::vector<uint8_t>& data, const uint32_t size)
+{
+    BinaryStateReader reader(data.data(), size);
+    const uint8_t* chunkData;
+    uint32_t chunkType, chunkSize;
+    bool firstSection = true;
+    bool firstState = true;
+
+    printf("{");
+
+    while (reader.readChunk(chunkType, chunkData, chunkSize))
+    {
+        switch (chunkType)
+        {
+        case kBinaryStateChunkProgram:
+        {
+            uint32_t program;
+            DISTRHO_SAFE_ASSERT_RETURN(BinaryStateReader::parseProgram(chunkData, chunkSize, program), 1);
+
+            if (! firstState)
+                printf("\n  }");
+            printf("%s\n  \"program\": %u", firstSection ? "" : ",", program);
+            firstSection = false;
+            firstState = true;
+            break;
+        }
+
+        case kBinaryStateChunkState:
+        {
+            const char* key;
+            const char* value;
+            DISTRHO_SAFE_ASSERT_RETURN(BinaryStateReader::parseState(chunkData, chunkSize, key, value), 1);
+
+            // states are written one chunk each, group them together
+            if (firstState)
+                printf("%s\n  \"states\": {", firstSection ? "" : ",");
+            else
+                printf(",");
+            // TODO safely encode value as json compatible string
+            printf("\n    \"%s\": %s", key, value);
+            firstSection = firstState = false;
+            break;
+        }
+
+        case kBinaryStateChunkParameters:
+        {
+            BinaryStateReader::Parameters params;
+            DISTRHO_SAFE_ASSERT_RETURN(BinaryStateReader::parseParameters(chunkData, chunkSize, params), 1);
+
+            if (! firstState)
+                printf("\n  }");
+            printf("%s\n  \"parameters\": {", firstSection ? "" : ",");
+
+            const char* symbol;
+            float value;
+            for (bool firstValue = true; params.next(symbol, value); firstValue = false)
+                printf("%s\n    \"%s\": %f", firstValue ? "" : ",", symbol, static_cast<double>(value));
+
+            printf("\n  }");
+            firstSection = false;
+            firstState = true;
+            break;
+        }
+        }
+    }
+
+    if (! firstState)
+        printf("\n  }");
+
+    printf("\n}\n");
+    return 0;
+}
 
 int main(int argc, char* argv[])
 {
@@ -17,6 +91,12 @@ int main(int argc, char* argv[])
         return 0;
     }
 
+    if (const uint32_t binaryStateSize = BinaryStateReader::getTotalSize(data.data(), static_cast<uint32_t>(data.size())))
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(binaryStateSize <= data.size(), binaryStateSize, data.size(), 1);
+        return printBinaryState(data, binaryStateSize);
+    }
+
     String key, value;
     bool firstValue = true;
     bool hasValue = false;